@@ -0,0 +1,264 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/algorithm/query_executor.cpp
+//
+//===-----------------------------------------------------
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include <algorithm/query_executor.h>
+#include <common/exception.h>
+
+namespace distribution_lsh {
+
+QUERY_EXECUTOR_TEMPLATE
+QUERY_EXECUTOR_TYPE::QueryExecutor(RangeReader range_reader,
+                                   Verifier verifier,
+                                   int k,
+                                   int collision_threshold,
+                                   float approximation_ratio,
+                                   float bucket_width,
+                                   int candidate_budget,
+                                   int64_t scan_budget,
+                                   WorkStealingPool *pool)
+    : range_reader_(std::move(range_reader)),
+      verifier_(std::move(verifier)),
+      k_(k),
+      collision_threshold_(collision_threshold),
+      approximation_ratio_(approximation_ratio),
+      bucket_width_(bucket_width),
+      candidate_budget_(candidate_budget),
+      scan_budget_(scan_budget),
+      pool_(pool) {
+  if (k_ <= 0 || collision_threshold_ <= 0 || approximation_ratio_ <= 1.0F || bucket_width_ <= 0) {
+    throw Exception(ExceptionType::INVALID_ARGUMENT, "Invalid parameters of query executor");
+  }
+}
+
+QUERY_EXECUTOR_TEMPLATE
+auto QUERY_EXECUTOR_TYPE::Execute(const std::vector<ValueType> &projections,
+                                  float initial_radius,
+                                  float max_radius) -> std::vector<Neighbor> {
+  collision_counts_.clear();
+  collision_partitions_.assign(pool_ == nullptr ? 0 : pool_->GetThreadCount(), {});
+  neighbors_ = {};
+  termination_ = QueryTermination::INVALID_TERMINATION;
+  radius_ = initial_radius;
+  round_count_ = 0;
+  candidate_count_ = 0;
+  scan_count_ = 0;
+
+  // Scanned window [left, right] of every line, empty before the first round
+  std::vector<ValueType> scanned_lefts(projections);
+  std::vector<ValueType> scanned_rights(projections);
+  std::vector<bool> is_scanned(projections.size(), false);
+  std::vector<ValueType> lefts(projections.size());
+  std::vector<ValueType> rights(projections.size());
+  std::vector<RID> result;
+
+  auto is_terminated = projections.empty();
+  while (!is_terminated) {
+    ++round_count_;
+    auto half_width = bucket_width_ * radius_ / 2;
+    for (size_t line = 0; line < projections.size(); ++line) {
+      lefts[line] = static_cast<ValueType>(projections[line] - half_width);
+      rights[line] = static_cast<ValueType>(projections[line] + half_width);
+    }
+
+    if (pool_ != nullptr) {
+      is_terminated = ParallelRound(lefts, rights, scanned_lefts, scanned_rights, is_scanned);
+    } else {
+      for (size_t line = 0; line < projections.size() && !is_terminated; ++line) {
+        result.clear();
+        ReadWindow(static_cast<int>(line), lefts[line], rights[line], is_scanned[line], scanned_lefts[line],
+                   scanned_rights[line], &result);
+        scan_count_ += static_cast<int64_t>(result.size());
+        is_terminated = Collide(result) || IsTerminated();
+      }
+    }
+
+    for (size_t line = 0; line < projections.size(); ++line) {
+      scanned_lefts[line] = is_scanned[line] ? std::min(lefts[line], scanned_lefts[line]) : lefts[line];
+      scanned_rights[line] = is_scanned[line] ? std::max(rights[line], scanned_rights[line]) : rights[line];
+      is_scanned[line] = true;
+    }
+
+    if (!is_terminated && radius_ >= max_radius) {
+      termination_ = QueryTermination::MAX_RADIUS;
+      is_terminated = true;
+    }
+    if (!is_terminated) {
+      radius_ = std::min(radius_ * approximation_ratio_, max_radius);
+    }
+  }
+
+  std::vector<Neighbor> neighbors;
+  neighbors.reserve(neighbors_.size());
+  while (!neighbors_.empty()) {
+    neighbors.emplace_back(neighbors_.top());
+    neighbors_.pop();
+  }
+  std::reverse(neighbors.begin(), neighbors.end());
+  return neighbors;
+}
+
+QUERY_EXECUTOR_TEMPLATE
+void QUERY_EXECUTOR_TYPE::ReadWindow(int line, ValueType left, ValueType right, bool is_scanned,
+                                     ValueType scanned_left, ValueType scanned_right, std::vector<RID> *result) {
+  if (!is_scanned) {
+    range_reader_(line, left, right, result);
+    return;
+  }
+
+  // Read the new parts of the window only, the bounds already read are excluded
+  if (left < scanned_left) {
+    range_reader_(line, left, std::nextafter(scanned_left, left), result);
+  }
+  if (right > scanned_right) {
+    range_reader_(line, std::nextafter(scanned_right, right), right, result);
+  }
+}
+
+QUERY_EXECUTOR_TEMPLATE
+auto QUERY_EXECUTOR_TYPE::Collide(const std::vector<RID> &rids) -> bool {
+  for (const auto &rid : rids) {
+    if (++collision_counts_[rid.Get()] != collision_threshold_) {
+      continue;
+    }
+
+    // Verify once, when the data crosses the threshold
+    auto distance = 0.0F;
+    if (!verifier_(rid, &distance)) {
+      continue;
+    }
+    Push(distance, rid);
+    if (IsTerminated()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+QUERY_EXECUTOR_TEMPLATE
+auto QUERY_EXECUTOR_TYPE::ParallelRound(const std::vector<ValueType> &lefts,
+                                        const std::vector<ValueType> &rights,
+                                        const std::vector<ValueType> &scanned_lefts,
+                                        const std::vector<ValueType> &scanned_rights,
+                                        const std::vector<bool> &is_scanned) -> bool {
+  // Every line scatters the positions of the data it reads into the partitions, so that a partition reads its own data
+  auto line_count = lefts.size();
+  auto partition_count = collision_partitions_.size();
+  std::vector<std::vector<RID>> results(line_count);
+  std::vector<std::vector<std::vector<size_t>>> buckets(line_count, std::vector<std::vector<size_t>>(partition_count));
+  {
+    TaskGroup task_group(pool_);
+    for (size_t line = 0; line < line_count; ++line) {
+      task_group.Run([&, line]() {
+        ReadWindow(static_cast<int>(line), lefts[line], rights[line], is_scanned[line], scanned_lefts[line],
+                   scanned_rights[line], &results[line]);
+        for (size_t position = 0; position < results[line].size(); ++position) {
+          auto partition = static_cast<size_t>(std::hash<int64_t>{}(results[line][position].Get())) % partition_count;
+          buckets[line][partition].push_back(position);
+        }
+      });
+    }
+    task_group.Wait();
+  }
+
+  // Every partition of the data is counted by one task, no count is shared
+  std::vector<std::vector<Crossing>> partition_crossings(partition_count);
+  {
+    TaskGroup task_group(pool_);
+    for (size_t partition = 0; partition < partition_count; ++partition) {
+      task_group.Run([&, partition]() {
+        auto &collision_counts = collision_partitions_[partition];
+        for (size_t line = 0; line < line_count; ++line) {
+          for (auto position : buckets[line][partition]) {
+            if (++collision_counts[results[line][position].Get()] == collision_threshold_) {
+              partition_crossings[partition].push_back({static_cast<int>(line), position, results[line][position]});
+            }
+          }
+        }
+      });
+    }
+    task_group.Wait();
+  }
+
+  // Candidates are taken in the order of a serial round
+  std::vector<Crossing> crossings;
+  for (const auto &partition : partition_crossings) {
+    crossings.insert(crossings.end(), partition.begin(), partition.end());
+  }
+  std::sort(crossings.begin(), crossings.end(), [](const auto &left, const auto &right) {
+    return left.line_ != right.line_ ? left.line_ < right.line_ : left.position_ < right.position_;
+  });
+
+  // They are verified in parallel batches when reached, no more than the candidate budget left, so that a query
+  // stopping in the round verifies one batch too many at most
+  std::vector<float> distances(crossings.size());
+  std::vector<char> is_found(crossings.size(), 0);
+  size_t verified_end = 0;
+  auto verify_batch = [&](size_t begin) {
+    auto batch_size = std::clamp(candidate_budget_ - candidate_count_, 1, QUERY_VERIFICATION_BATCH_SIZE);
+    verified_end = std::min(begin + static_cast<size_t>(batch_size), crossings.size());
+    TaskGroup task_group(pool_);
+    for (size_t i = begin; i < verified_end; ++i) {
+      task_group.Run([&, i]() { is_found[i] = verifier_(crossings[i].rid_, &distances[i]) ? 1 : 0; });
+    }
+    task_group.Wait();
+  };
+
+  size_t crossing_index = 0;
+  for (size_t line = 0; line < line_count; ++line) {
+    scan_count_ += static_cast<int64_t>(results[line].size());
+    for (; crossing_index < crossings.size() && crossings[crossing_index].line_ == static_cast<int>(line); ++crossing_index) {
+      if (crossing_index == verified_end) {
+        verify_batch(crossing_index);
+      }
+      if (is_found[crossing_index] == 0) {
+        continue;
+      }
+      Push(distances[crossing_index], crossings[crossing_index].rid_);
+      if (IsTerminated()) {
+        return true;
+      }
+    }
+    if (IsTerminated()) {
+      return true;
+    }
+  }
+  return false;
+}
+
+QUERY_EXECUTOR_TEMPLATE
+void QUERY_EXECUTOR_TYPE::Push(float distance, const RID &rid) {
+  ++candidate_count_;
+  if (static_cast<int>(neighbors_.size()) < k_) {
+    neighbors_.push({distance, rid});
+  } else if (distance < neighbors_.top().distance_) {
+    neighbors_.pop();
+    neighbors_.push({distance, rid});
+  }
+}
+
+QUERY_EXECUTOR_TEMPLATE
+auto QUERY_EXECUTOR_TYPE::IsTerminated() -> bool {
+  if (static_cast<int>(neighbors_.size()) == k_ && neighbors_.top().distance_ <= approximation_ratio_ * radius_) {
+    termination_ = QueryTermination::ACCURATE;
+  } else if (candidate_count_ >= candidate_budget_) {
+    termination_ = QueryTermination::CANDIDATE_BUDGET;
+  } else if (scan_count_ >= scan_budget_) {
+    termination_ = QueryTermination::SCAN_BUDGET;
+  } else {
+    return false;
+  }
+  return true;
+}
+
+template class QueryExecutor<float>;
+template class QueryExecutor<double>;
+
+} // namespace distribution_lsh
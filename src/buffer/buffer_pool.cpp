@@ -0,0 +1,28 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/buffer/buffer_pool.cpp
+//
+//===-----------------------------------------------------
+
+#include <buffer/buffer_pool.h>
+
+namespace distribution_lsh {
+
+BufferPool::BufferPool(size_t pool_size, size_t replacer_k)
+    : pool_size_(pool_size),
+      pages_(new Page[pool_size_]),
+      frame_owners_(pool_size_, nullptr),
+      replacer_(std::make_unique<LRUKReplacer>(pool_size, replacer_k)) {
+  // Initially, every page is in the free list.
+  for (size_t i = 0; i < pool_size_; ++i) {
+    free_list_.emplace_back(static_cast<int>(i));
+  }
+}
+
+auto BufferPool::GetFreeFrameCount() -> size_t {
+  std::unique_lock<std::mutex> lock(latch_);
+  return free_list_.size();
+}
+
+}// namespace distribution_lsh
@@ -4,13 +4,17 @@
 // src/buffer/buffer_pool_manager.cpp
 //
 //===-----------------------------------------------------
-#include <omp.h>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <vector>
 
 #include <buffer/buffer_pool_manager.h>
 
 #include <common/exception.h>
 #include <common/macro.h>
 #include <common/logger.h>
+#include <common/work_stealing_pool.h>
 #include <storage/page/page_guard.h>
 #include <storage/page/header_page.h>
 #include <storage/page/data_page.h>
@@ -21,19 +25,21 @@ BufferPoolManager::BufferPoolManager(size_t pool_size,
                                      size_t replacer_k,
                                      distribution_lsh::LogManager *log_manager,
                                      page_id_t next_page_id)
-    : pool_size_(pool_size),
-      pages_(new Page[pool_size_]),
+    : BufferPoolManager(std::make_shared<BufferPool>(pool_size, replacer_k),
+                        std::move(disk_manager),
+                        log_manager,
+                        next_page_id) {}
+
+BufferPoolManager::BufferPoolManager(std::shared_ptr<BufferPool> buffer_pool,
+                                     std::shared_ptr<distribution_lsh::DiskManager> disk_manager,
+                                     distribution_lsh::LogManager *log_manager,
+                                     page_id_t next_page_id)
+    : pool_(std::move(buffer_pool)),
+      file_key_(pool_->next_file_key_++),
       extra_pages_(new Page[2]),
       disk_scheduler_(std::make_unique<DiskScheduler>(std::move(disk_manager))),
       log_manager_(log_manager),
-      next_page_id_(next_page_id) {
-  replacer_ = std::make_unique<LRUKReplacer>(pool_size, replacer_k);
-
-  // Initially, every page is in the free list.
-  for (size_t i = 0; i < pool_size_; ++i) {
-    free_list_.emplace_back(static_cast<int>(i));
-  }
-}
+      next_page_id_(next_page_id) {}
 
 BufferPoolManager::~BufferPoolManager() {
 #ifdef RESOURCE_REUSE
@@ -43,7 +49,9 @@ BufferPoolManager::~BufferPoolManager() {
     auto promise = disk_scheduler_->CreatePromise();
     auto future = promise.get_future();
 
-    if (page_table_.find(HEADER_PAGE_ID) == page_table_.end()) {
+    std::unique_lock<std::mutex> lock(pool_->latch_);
+    auto header_frame = FindFrame(HEADER_PAGE_ID);
+    if (header_frame == -1) {
       // Use extra page for attaining null page
       disk_scheduler_->request_queue_.Put(std::make_optional<DiskRequest>(
           {false,
@@ -55,8 +63,12 @@ BufferPoolManager::~BufferPoolManager() {
 
       header_page = reinterpret_cast<HeaderPage *>(extra_pages_[0].data_);
     } else {
-      header_page = reinterpret_cast<HeaderPage *>(pages_[page_table_[HEADER_PAGE_ID]].data_);
+      // Pin the header frame, so that it is not evicted by the other files sharing the pool while being updated
+      pool_->pages_[header_frame].pin_count_ += 1;
+      pool_->replacer_->SetEvictable(header_frame, false);
+      header_page = reinterpret_cast<HeaderPage *>(pool_->pages_[header_frame].data_);
     }
+    lock.unlock();
 
     auto before_free_page_list_start =
         header_page->GetNullPageSlotStart() == INVALID_PAGE_ID || header_page->GetNullPageSlotStart() == HEADER_PAGE_ID
@@ -83,195 +95,294 @@ BufferPoolManager::~BufferPoolManager() {
       // Wait for write back process
       DISTRIBUTION_LSH_ENSURE(future.get(), "Write Back Failure.")
     }
+
+    if (header_frame == -1) {
+      // Write back the header read into the extra page
+      promise = disk_scheduler_->CreatePromise();
+      future = promise.get_future();
+      disk_scheduler_->request_queue_.Put(std::make_optional<DiskRequest>(
+          {true,
+           reinterpret_cast<char *>(extra_pages_[0].data_),
+           HEADER_PAGE_ID, std::move(promise)}));
+      DISTRIBUTION_LSH_ENSURE(future.get(), "Write Back Failure.")
+    } else {
+      // Flushed with the other pages below
+      UnpinPage(HEADER_PAGE_ID, true);
+    }
   }
 #endif
 
   FlushAllPages();
+
+  // Give the frames of this file back to the pool before the disk scheduler stops
+  {
+    std::unique_lock<std::mutex> lock(pool_->latch_);
+    for (size_t i = 0; i < pool_->pool_size_; ++i) {
+      if (pool_->frame_owners_[i] != this) {
+        continue;
+      }
+      auto frame_id = static_cast<frame_id_t>(i);
+      auto &page = pool_->pages_[static_cast<int64_t>(i)];
+      pool_->page_table_.erase({file_key_, page.page_id_});
+      pool_->replacer_->SetEvictable(frame_id, true);
+      pool_->replacer_->Remove(frame_id);
+      pool_->frame_owners_[i] = nullptr;
+      pool_->free_list_.emplace_back(frame_id);
+      page.page_id_ = INVALID_PAGE_ID;
+      page.pin_count_ = 0;
+      page.is_dirty_ = false;
+    }
+  }
   disk_scheduler_->request_queue_.Put(std::nullopt);
 }
 
-auto BufferPoolManager::NewPage(page_id_t *page_id) -> std::shared_ptr<Page> {
-  std::unique_lock<std::mutex> page(latch_);
+auto BufferPoolManager::NewPage(page_id_t *page_id) -> Page * {
+  std::unique_lock<std::mutex> lock(pool_->latch_);
 
-  // search in the free frame
-  frame_id_t target_frame = !free_list_.empty() ? free_list_.front() : -1;
-  if (target_frame == -1 && !replacer_->Evict(&target_frame)) {
+  frame_id_t target_frame = -1;
+  if (!AcquireFrame(&target_frame)) {
     *page_id = INVALID_PAGE_ID;
     return nullptr;
   }
 
-  // if the frame is searched in free list
-  if (!free_list_.empty()) {
-    free_list_.pop_front();
-  } else {
-    Page *replaced_page = &pages_[target_frame];
-    if (replaced_page->IsDirty()) {
-      // Write back to disk
-      auto promise = disk_scheduler_->CreatePromise();
-      auto future = promise.get_future();
-      std::optional<DiskRequest> disk_request
-          ({true, reinterpret_cast<char *>(replaced_page->data_), replaced_page->page_id_, std::move(promise)});
-      disk_scheduler_->request_queue_.Put(std::move(disk_request));
-      DISTRIBUTION_LSH_ENSURE(future.get(), "Write Back Failure.")
-    }
-
-    page_table_.erase(replaced_page->page_id_);
-  }
+  *page_id = AllocatePage();
+  return InstallNewPage(target_frame, *page_id);
+}
 
+auto BufferPoolManager::InstallNewPage(frame_id_t target_frame, page_id_t page_id) -> Page * {
   // Set initial data
-  pages_[target_frame].page_id_ = AllocatePage();
-  *page_id = pages_[target_frame].page_id_;
-  pages_[target_frame].ResetMemory();
-  pages_[target_frame].pin_count_ = 1;
-  pages_[target_frame].is_dirty_ = false;
-  page_table_[pages_[target_frame].page_id_] = target_frame;
+  auto &page = pool_->pages_[target_frame];
+  page.page_id_ = page_id;
+  page.ResetMemory();
+  page.pin_count_ = 1;
+  page.is_dirty_ = false;
+  pool_->page_table_[{file_key_, page.page_id_}] = target_frame;
+  pool_->frame_owners_[target_frame] = this;
 
   // Update replacers
-  replacer_->RecordAccess(target_frame);
-  replacer_->SetEvictable(target_frame, false);
+  pool_->replacer_->RecordAccess(target_frame);
+  pool_->replacer_->SetEvictable(target_frame, false);
 
-  return {pages_, pages_.get() + target_frame};
+  return &pool_->pages_[target_frame];
 }
 
-auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> std::shared_ptr<Page> {
-  std::unique_lock<std::mutex> page(latch_);
+auto BufferPoolManager::FetchPage(page_id_t page_id, [[maybe_unused]] AccessType access_type) -> Page * {
+  std::unique_lock<std::mutex> lock(pool_->latch_);
 
   // Page in the buffer
-  if (page_table_.find(page_id) != page_table_.end()) {
-    pages_[page_table_[page_id]].pin_count_ += 1;
-    replacer_->RecordAccess(page_table_[page_id]);
-    replacer_->SetEvictable(page_table_[page_id], false);
-    return {pages_, pages_.get() + page_table_[page_id]};
+  auto target_frame = FindFrame(page_id);
+  if (target_frame != -1) {
+    pool_->pages_[target_frame].pin_count_ += 1;
+    pool_->replacer_->RecordAccess(target_frame);
+    pool_->replacer_->SetEvictable(target_frame, false);
+    lock.unlock();
+
+    // A page being read by an asynchronous fetch is ready once the disk thread marks it loaded, the pinned frame keeps
+    // the page meanwhile
+    std::unique_lock<std::mutex> load_lock(pool_->load_latch_);
+    pool_->loaded_cv_.wait(load_lock, [&]() { return !pool_->loading_frames_.contains(target_frame); });
+    return &pool_->pages_[target_frame];
   }
 
   // Page need to replace
-  frame_id_t target_frame = !free_list_.empty() ? free_list_.front() : -1;
-  if (target_frame == -1 && !replacer_->Evict(&target_frame)) {
+  if (!AcquireFrame(&target_frame)) {
     return nullptr;
   }
 
-  // Deal the target page
-  if (!free_list_.empty()) {
-    free_list_.pop_front();
-  } else {
-    Page *replaced_page = &pages_[target_frame];
-    if (replaced_page->IsDirty()) {
-      // Write back to disk
-      auto promise = disk_scheduler_->CreatePromise();
-      auto future = promise.get_future();
-      std::optional<DiskRequest> disk_request
-          ({true, reinterpret_cast<char *>(replaced_page->data_), replaced_page->page_id_, std::move(promise)});
-      disk_scheduler_->request_queue_.Put(std::move(disk_request));
-      DISTRIBUTION_LSH_ENSURE(future.get(), "Write Back Failure.")
-    }
-
-    page_table_.erase(replaced_page->page_id_);
+  // Publish the page as loading, so that other fetches of it wait for this read
+  auto &page = pool_->pages_[target_frame];
+  page.page_id_ = page_id;
+  page.is_dirty_ = false;
+  page.pin_count_ = 1;
+  pool_->page_table_[{file_key_, page_id}] = target_frame;
+  pool_->frame_owners_[target_frame] = this;
+  {
+    std::scoped_lock<std::mutex> load_lock(pool_->load_latch_);
+    pool_->loading_frames_[target_frame];
   }
 
-  // Read from disk
+  // Update replacers
+  pool_->replacer_->RecordAccess(target_frame);
+  pool_->replacer_->SetEvictable(target_frame, false);
+  lock.unlock();
+
+  // Read from disk without the pool latch, the other files sharing the pool go on meanwhile
   auto promise = disk_scheduler_->CreatePromise();
   auto future = promise.get_future();
   std::optional<DiskRequest>
-      disk_request({false, reinterpret_cast<char *>(pages_[target_frame].data_), page_id, std::move(promise)});
+      disk_request({false, reinterpret_cast<char *>(page.data_), page_id, std::move(promise)});
   disk_scheduler_->request_queue_.Put(std::move(disk_request));
   // Wait for read in process
-  DISTRIBUTION_LSH_ENSURE(future.get(), "Read In Failure.")
-
-  // Set page information
-  pages_[target_frame].page_id_ = page_id;
-  pages_[target_frame].is_dirty_ = false;
-  pages_[target_frame].pin_count_ = 1;
-  page_table_[page_id] = target_frame;
-
-  // Update replacers
-  replacer_->RecordAccess(target_frame);
-  replacer_->SetEvictable(target_frame, false);
+  auto is_read = future.get();
+  FinishLoad(target_frame);
+  DISTRIBUTION_LSH_ENSURE(is_read, "Read In Failure.")
 
-  return {pages_, pages_.get() + target_frame};
+  return &page;
 }
 
 auto BufferPoolManager::UnpinPage(distribution_lsh::page_id_t page_id,
                                   bool is_dirty,
                                   [[maybe_unused]] distribution_lsh::AccessType access_type) -> bool {
-  std::unique_lock<std::mutex> page(latch_);
+  std::unique_lock<std::mutex> lock(pool_->latch_);
   // page_id is not in the buffer pool or its pin count is already 0
-  if (page_table_.find(page_id) == page_table_.end() || pages_[page_table_[page_id]].pin_count_ == 0) {
+  auto target_frame = FindFrame(page_id);
+  if (target_frame == -1 || pool_->pages_[target_frame].pin_count_ == 0) {
     return false;
   }
 
   // Decrease the pin count and set evictable
-  auto target_frame = page_table_[page_id];
-  if (--pages_[target_frame].pin_count_ == 0) {
-    replacer_->SetEvictable(target_frame, true);
+  if (--pool_->pages_[target_frame].pin_count_ == 0) {
+    pool_->replacer_->SetEvictable(target_frame, true);
   }
-  pages_[target_frame].is_dirty_ = is_dirty;
+  pool_->pages_[target_frame].is_dirty_ = pool_->pages_[target_frame].is_dirty_ || is_dirty;
   return true;
 }
 
 auto BufferPoolManager::FlushPage(page_id_t page_id) -> bool {
-  std::unique_lock<std::mutex> page(latch_);
+  std::unique_lock<std::mutex> lock(pool_->latch_);
 
-  if (page_table_.find(page_id) == page_table_.end()) {
+  auto target_frame = FindFrame(page_id);
+  if (target_frame == -1) {
     return false;
   }
+  // A page being read is clean
+  if (IsLoading(target_frame)) {
+    return true;
+  }
 
-  auto target_frame = page_table_[page_id];
   // Write into disk(non-block)
   auto promise = disk_scheduler_->CreatePromise();
   auto future = promise.get_future();
   std::optional<DiskRequest>
-      disk_request({true, reinterpret_cast<char *>(pages_[target_frame].data_), page_id, std::move(promise)});
+      disk_request({true, reinterpret_cast<char *>(pool_->pages_[target_frame].data_), page_id, std::move(promise)});
   disk_scheduler_->request_queue_.Put(std::move(disk_request));
   return true;
 }
 
 void BufferPoolManager::FlushAllPages() {
-  std::unique_lock<std::mutex> page(latch_);
-
-#pragma omp parallel for default(none) shared(pages_, __stdoutp)
-  for (size_t i = 0; i < pool_size_; i++) {
-    // Write into disk(non-block)
-    if (pages_[static_cast<int64_t>(i)].page_id_ != INVALID_PAGE_ID) {
-      auto promise = disk_scheduler_->CreatePromise();
-      auto future = promise.get_future();
-      std::optional<DiskRequest>
-          disk_request({true, reinterpret_cast<char *>(pages_[static_cast<int64_t>(i)].data_),
-                        pages_[static_cast<int64_t>(i)].page_id_, std::move(promise)});
-      disk_scheduler_->request_queue_.Put(std::move(disk_request));
-      if (!future.get()) {
-        LOG_DEBUG("Flush page failed.");
-      }
+  std::unique_lock<std::mutex> lock(pool_->latch_);
+
+  // Queue the writes of copies of all the pages of this file, then wait for them without the pool latch. An unpinned
+  // frame may be taken by another file sharing the pool meanwhile, so the frame itself is never written from.
+  std::vector<frame_id_t> frame_ids;
+  for (size_t i = 0; i < pool_->pool_size_; i++) {
+    if (pool_->frame_owners_[i] == this && pool_->pages_[static_cast<int64_t>(i)].page_id_ != INVALID_PAGE_ID
+        && !IsLoading(static_cast<frame_id_t>(i))) {
+      frame_ids.emplace_back(static_cast<frame_id_t>(i));
+    }
+  }
+  std::unique_ptr<char[]> data(new char[frame_ids.size() * DISTRIBUTION_LSH_PAGE_SIZE]);
+  std::vector<page_id_t> page_ids;
+  std::vector<bool> is_cleaned;
+  std::vector<std::future<bool>> futures;
+  page_ids.reserve(frame_ids.size());
+  is_cleaned.reserve(frame_ids.size());
+  futures.reserve(frame_ids.size());
+  for (size_t i = 0; i < frame_ids.size(); i++) {
+    auto &page = pool_->pages_[frame_ids[i]];
+    auto copy = data.get() + i * DISTRIBUTION_LSH_PAGE_SIZE;
+    memcpy(copy, page.data_, DISTRIBUTION_LSH_PAGE_SIZE);
+
+    // An unpinned page is whole in the copy, a pinned one is marked dirty again by its unpin
+    is_cleaned.emplace_back(page.pin_count_ == 0 && page.is_dirty_);
+    if (is_cleaned.back()) {
+      page.is_dirty_ = false;
+    }
+    page_ids.emplace_back(page.page_id_);
+    auto promise = disk_scheduler_->CreatePromise();
+    futures.emplace_back(promise.get_future());
+    disk_scheduler_->request_queue_.Put(std::make_optional<DiskRequest>({true, copy, page.page_id_,
+                                                                         std::move(promise)}));
+  }
+  lock.unlock();
+
+  for (size_t i = 0; i < futures.size(); i++) {
+    if (futures[i].get()) {
+      continue;
+    }
+    LOG_DEBUG("Flush page failed.");
+    // The page is written back on eviction instead, if it is still in its frame
+    std::scoped_lock<std::mutex> relock(pool_->latch_);
+    if (is_cleaned[i] && FindFrame(page_ids[i]) == frame_ids[i]) {
+      pool_->pages_[frame_ids[i]].is_dirty_ = true;
     }
   }
 }
 
 auto BufferPoolManager::DeletePage(page_id_t page_id) -> bool {
-  std::unique_lock<std::mutex> page(latch_);
+  std::unique_lock<std::mutex> lock(pool_->latch_);
 
-  if (page_table_.find(page_id) == page_table_.end() || pages_[page_table_[page_id]].pin_count_ != 0) {
-    return page_table_.find(page_id) == page_table_.end();
+  auto target_frame = FindFrame(page_id);
+  if (target_frame == -1 || pool_->pages_[target_frame].pin_count_ != 0) {
+    return target_frame == -1;
   }
 
-  auto target_frame = page_table_[page_id];
-  if (page_table_.erase(page_id) == 0U) {
+  if (pool_->page_table_.erase({file_key_, page_id}) == 0U) {
     throw Exception("Delete page failed");
   }
 
   // Stop trace and add to free list
-  replacer_->Remove(target_frame);
-  free_list_.emplace_back(target_frame);
-  page_table_.erase(pages_[target_frame].page_id_);
+  pool_->replacer_->Remove(target_frame);
+  pool_->free_list_.emplace_back(target_frame);
+  pool_->frame_owners_[target_frame] = nullptr;
 
-  pages_[target_frame].page_id_ = INVALID_PAGE_ID;
-  pages_[target_frame].ResetMemory();
-  pages_[target_frame].pin_count_ = 0;
-  pages_[target_frame].is_dirty_ = false;
+  auto &page = pool_->pages_[target_frame];
+  page.page_id_ = INVALID_PAGE_ID;
+  page.ResetMemory();
+  page.pin_count_ = 0;
+  page.is_dirty_ = false;
 
   DeallocatePage(page_id);
 
   return true;
 }
 
+auto BufferPoolManager::FindFrame(page_id_t page_id) -> frame_id_t {
+  auto iterator = pool_->page_table_.find({file_key_, page_id});
+  return iterator == pool_->page_table_.end() ? -1 : iterator->second;
+}
+
+auto BufferPoolManager::AcquireFrame(frame_id_t *frame_id) -> bool {
+  // search in the free frame
+  if (!pool_->free_list_.empty()) {
+    *frame_id = pool_->free_list_.front();
+    pool_->free_list_.pop_front();
+    return true;
+  }
+
+  if (!pool_->replacer_->Evict(frame_id)) {
+    return false;
+  }
+
+  // The replaced page may belong to another file sharing the pool
+  Page *replaced_page = &pool_->pages_[*frame_id];
+  auto owner = pool_->frame_owners_[*frame_id];
+  if (replaced_page->IsDirty()) {
+    // Write back a copy without waiting, so that the frame is free at once and no disk write is waited for under the
+    // pool latch. The disk scheduler of the owner runs its requests in order, a later read of the page sees the write.
+    std::shared_ptr<char[]> data(new char[DISTRIBUTION_LSH_PAGE_SIZE]);
+    memcpy(data.get(), replaced_page->data_, DISTRIBUTION_LSH_PAGE_SIZE);
+    std::optional<DiskRequest> disk_request({true,
+                                             data.get(),
+                                             replaced_page->page_id_,
+                                             owner->disk_scheduler_->CreatePromise(),
+                                             [data](bool is_written) {
+                                               if (!is_written) {
+                                                 LOG_DEBUG("Write Back Failure.");
+                                               }
+                                             }});
+    owner->disk_scheduler_->request_queue_.Put(std::move(disk_request));
+  }
+
+  // A page allocated again after a fetch past the end of its file lives in a newer frame, whose mapping is kept
+  auto iterator = pool_->page_table_.find({owner->file_key_, replaced_page->page_id_});
+  if (iterator != pool_->page_table_.end() && iterator->second == *frame_id) {
+    pool_->page_table_.erase(iterator);
+  }
+  pool_->frame_owners_[*frame_id] = nullptr;
+  return true;
+}
+
 auto BufferPoolManager::AllocatePage() -> page_id_t {
   // If the file is null
   if (next_page_id_ == HEADER_PAGE_ID) {
@@ -291,7 +402,8 @@ auto BufferPoolManager::AllocatePage() -> page_id_t {
   auto promise = disk_scheduler_->CreatePromise();
   auto future = promise.get_future();
 
-  if (page_table_.find(HEADER_PAGE_ID) == page_table_.end()) {
+  auto header_frame = FindFrame(HEADER_PAGE_ID);
+  if (header_frame == -1) {
     // Use extra page for attaining null page
     disk_scheduler_->request_queue_.Put(std::make_optional<DiskRequest>(
         {false,
@@ -303,7 +415,7 @@ auto BufferPoolManager::AllocatePage() -> page_id_t {
 
     header_page = reinterpret_cast<HeaderPage *>(extra_pages_[0].data_);
   } else {
-    header_page = reinterpret_cast<HeaderPage *>(pages_[page_table_[HEADER_PAGE_ID]].data_);
+    header_page = reinterpret_cast<HeaderPage *>(pool_->pages_[header_frame].data_);
   }
 
   if (header_page->GetNullPageSlotStart() == INVALID_PAGE_ID
@@ -350,4 +462,132 @@ auto BufferPoolManager::FetchPageWrite(page_id_t page_id) -> WritePageGuard { re
 
 auto BufferPoolManager::NewPageGuarded(page_id_t *page_id) -> BasicPageGuard { return {this, NewPage(page_id)}; }
 
+auto BufferPoolManager::ReservePages(int count) -> page_id_t {
+  std::unique_lock<std::mutex> lock(pool_->latch_);
+  return next_page_id_.fetch_add(count);
+}
+
+auto BufferPoolManager::NewReservedPageGuarded(page_id_t *page_id) -> BasicPageGuard {
+  std::unique_lock<std::mutex> lock(pool_->latch_);
+
+  frame_id_t target_frame = -1;
+  if (!AcquireFrame(&target_frame)) {
+    *page_id = INVALID_PAGE_ID;
+    return {this, nullptr};
+  }
+  return {this, InstallNewPage(target_frame, *page_id)};
+}
+
+void BufferPoolManager::ReleasePages(page_id_t first_page_id, int count) {
+  std::unique_lock<std::mutex> lock(pool_->latch_);
+  for (auto page_id = first_page_id; page_id < first_page_id + count; ++page_id) {
+    DeallocatePage(page_id);
+  }
+}
+
+auto BufferPoolManager::FetchPageReadAsync(page_id_t page_id) -> Task<ReadPageGuard> {
+  auto page = co_await FetchPageAwaiter(this, page_id);
+  if (page == nullptr) {
+    co_return ReadPageGuard(this, nullptr);
+  }
+
+  // A worker never blocks behind a writer, the coroutine goes back to the pool until the latch is free. The latch is
+  // taken on the thread that goes on with the caller, as a shared mutex must be released by its owner.
+  while (!page->TryRLatch()) {
+    co_await ResumeOnPool();
+  }
+  co_return ReadPageGuard(this, page, std::adopt_lock);
+}
+
+auto BufferPoolManager::FetchPageAwaiter::await_ready() -> bool {
+  auto pool = bpm_->pool_.get();
+  std::unique_lock<std::mutex> lock(pool->latch_);
+
+  // Page in the buffer, it is ready unless another fetch is reading it
+  frame_id_ = bpm_->FindFrame(page_id_);
+  if (frame_id_ != -1) {
+    pool->pages_[frame_id_].pin_count_ += 1;
+    pool->replacer_->RecordAccess(frame_id_);
+    pool->replacer_->SetEvictable(frame_id_, false);
+    return !bpm_->IsLoading(frame_id_);
+  }
+
+  // All frames are pinned, the fetch ends at once without a page
+  if (!bpm_->AcquireFrame(&frame_id_)) {
+    frame_id_ = -1;
+    return true;
+  }
+
+  // Publish the page before it is read, so that later fetches of it wait for this read
+  auto &page = pool->pages_[frame_id_];
+  page.page_id_ = page_id_;
+  page.is_dirty_ = false;
+  page.pin_count_ = 1;
+  pool->page_table_[{bpm_->file_key_, page_id_}] = frame_id_;
+  pool->frame_owners_[frame_id_] = bpm_;
+  pool->replacer_->RecordAccess(frame_id_);
+  pool->replacer_->SetEvictable(frame_id_, false);
+  {
+    std::scoped_lock<std::mutex> load_lock(pool->load_latch_);
+    pool->loading_frames_[frame_id_];
+  }
+  is_reader_ = true;
+  return false;
+}
+
+auto BufferPoolManager::FetchPageAwaiter::await_suspend(std::coroutine_handle<> handle) -> bool {
+  auto pool = bpm_->pool_.get();
+  {
+    std::scoped_lock<std::mutex> load_lock(pool->load_latch_);
+    auto iterator = pool->loading_frames_.find(frame_id_);
+    if (iterator == pool->loading_frames_.end()) {
+      return false;
+    }
+    iterator->second.emplace_back(handle);
+  }
+  if (!is_reader_) {
+    return true;
+  }
+
+  // The coroutine may resume as soon as the request is queued, so nothing of the awaiter is touched after it
+  auto disk_scheduler = bpm_->disk_scheduler_.get();
+  std::optional<DiskRequest> disk_request({false,
+                                           reinterpret_cast<char *>(pool->pages_[frame_id_].data_),
+                                           page_id_,
+                                           disk_scheduler->CreatePromise(),
+                                           [bpm = bpm_, frame_id = frame_id_](bool is_read) {
+                                             if (!is_read) {
+                                               LOG_DEBUG("Read In Failure.");
+                                             }
+                                             bpm->FinishLoad(frame_id);
+                                           }});
+  disk_scheduler->request_queue_.Put(std::move(disk_request));
+  return true;
+}
+
+auto BufferPoolManager::FetchPageAwaiter::await_resume() -> Page * {
+  return frame_id_ == -1 ? nullptr : &bpm_->pool_->pages_[frame_id_];
+}
+
+void BufferPoolManager::FinishLoad(frame_id_t frame_id) {
+  std::vector<std::coroutine_handle<>> waiters;
+  {
+    std::scoped_lock<std::mutex> load_lock(pool_->load_latch_);
+    auto iterator = pool_->loading_frames_.find(frame_id);
+    waiters = std::move(iterator->second);
+    pool_->loading_frames_.erase(iterator);
+  }
+  pool_->loaded_cv_.notify_all();
+
+  // Only the coroutines go to the pool, a synchronous fetch waiting for the page never depends on a free worker
+  for (auto waiter : waiters) {
+    WorkStealingPool::GetInstance().Submit([waiter]() { waiter.resume(); });
+  }
+}
+
+auto BufferPoolManager::IsLoading(frame_id_t frame_id) -> bool {
+  std::scoped_lock<std::mutex> load_lock(pool_->load_latch_);
+  return pool_->loading_frames_.contains(frame_id);
+}
+
 }// namespace distribution_lsh
\ No newline at end of file
@@ -20,6 +20,7 @@ using distribution_lsh::NormalizationType;
 using distribution_lsh::DistributionDatasetProcessor;
 using distribution_lsh::DistributionDataSetManager;
 using distribution_lsh::DistributionDataSetMonitor;
+using distribution_lsh::MONITOR_SHARED_POOL_SIZE;
 
 auto  main(int argc, char** argv) -> int {
 
@@ -37,7 +38,8 @@ auto  main(int argc, char** argv) -> int {
 
   // Arguments for buffer pool manager
   program.add_argument("--lru-k", "-k").default_value(16).help("lru-k size of dataset");
-  program.add_argument("--buffer-pool-size", "-b").default_value(50).help("buffer pool size of dataset");
+  program.add_argument("--buffer-pool-size", "-b").default_value(50).help("buffer pool size of each file of dataset if files share no pool");
+  program.add_argument("--shared-buffer-pool-size", "-sb").default_value(MONITOR_SHARED_POOL_SIZE).help("buffer pool size shared by all the files of dataset, 0 for a pool per file");
 
   // Arguments for page
   program.add_argument("--directory-page-size", "-dps").default_value(1000).help("directory page size of dataset");
@@ -115,13 +117,14 @@ auto  main(int argc, char** argv) -> int {
   // Buffer pool arguments
   auto lru_k = std::stoi(program.get("--lru-k"));
   auto buffer_pool_size = std::stoi(program.get("--buffer-pool-size"));
+  auto shared_buffer_pool_size = std::stoi(program.get("--shared-buffer-pool-size"));
 
   // Page size
   auto directory_page_size = program.get<int>("--directory-page-size");
   auto data_page_size = program.get<int>("--data-page-size");
 
   // Create dataset monitor
-  auto monitor = std::make_shared<DistributionDataSetMonitor<float>>(input_directory, training_set_directory, testing_set_directory, relation_directory, lru_k, buffer_pool_size, directory_page_size, data_page_size);
+  auto monitor = std::make_shared<DistributionDataSetMonitor<float>>(input_directory, training_set_directory, testing_set_directory, relation_directory, lru_k, buffer_pool_size, shared_buffer_pool_size, directory_page_size, data_page_size);
   monitor->GetDataSetIndex(data_set_type.value(), distribution_type.value(), normalization_type.value(), dimension, parameters[0], parameters[1], size, ratio);
   monitor->List();
   return 0;
@@ -0,0 +1,177 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/dataset/distribution/distribution_dataset_column_store.cpp
+//
+//===-----------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <common/exception.h>
+#include <common/work_stealing_pool.h>
+#include <dataset/distribution/distribution_dataset_column_store.h>
+
+namespace distribution_lsh {
+
+namespace {
+
+/** Fixed part of the file, followed by the RIDs at the next alignment */
+struct ColumnStoreHeader {
+  uint64_t magic_;
+  int32_t dimension_;
+  int32_t block_size_;
+  int64_t size_;
+};
+
+constexpr auto AlignColumnStoreOffset(int64_t offset) -> int64_t {
+  return (offset + DISTRIBUTION_DATASET_COLUMN_STORE_ALIGNMENT - 1) / DISTRIBUTION_DATASET_COLUMN_STORE_ALIGNMENT
+      * DISTRIBUTION_DATASET_COLUMN_STORE_ALIGNMENT;
+}
+
+constexpr auto GetRIDsOffset() -> int64_t { return AlignColumnStoreOffset(sizeof(ColumnStoreHeader)); }
+
+constexpr auto GetBlocksOffset(int64_t size) -> int64_t {
+  return AlignColumnStoreOffset(GetRIDsOffset() + size * static_cast<int64_t>(sizeof(int64_t)));
+}
+
+} // namespace
+
+DISTRIBUTION_DATASET_TEMPLATE
+DISTRIBUTION_DATASET_COLUMN_STORE_TYPE::DistributionDataSetColumnStore(const std::string &file_name)
+    : file_(file_name) {
+  ColumnStoreHeader header{};
+  if (file_.Size() < sizeof(ColumnStoreHeader)) {
+    throw Exception("Invalid column store file " + file_name);
+  }
+  memcpy(&header, file_.Data(), sizeof(ColumnStoreHeader));
+  if (header.magic_ != DISTRIBUTION_DATASET_COLUMN_STORE_MAGIC || header.dimension_ <= 0 || header.block_size_ <= 0
+      || header.size_ < 0) {
+    throw Exception("Invalid column store file " + file_name);
+  }
+
+  dimension_ = header.dimension_;
+  block_size_ = header.block_size_;
+  size_ = header.size_;
+  auto file_size = GetBlocksOffset(size_)
+      + GetBlockCount() * block_size_ * dimension_ * static_cast<int64_t>(sizeof(ValueType));
+  if (static_cast<int64_t>(file_.Size()) < file_size) {
+    throw Exception("Truncated column store file " + file_name);
+  }
+
+  rids_ = reinterpret_cast<const int64_t *>(file_.Data() + GetRIDsOffset());
+  blocks_ = reinterpret_cast<const ValueType *>(file_.Data() + GetBlocksOffset(size_));
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+void DISTRIBUTION_DATASET_COLUMN_STORE_TYPE::Build(DistributionDataSetManager<ValueType> *manager,
+                                                   bool is_training_set,
+                                                   const std::string &file_name,
+                                                   int block_size) {
+  if (block_size <= 0) {
+    throw Exception("Invalid block size of column store");
+  }
+
+  auto rids = manager->GetRIDs(is_training_set);
+  auto dimension = manager->GetDimension();
+  auto size = static_cast<int64_t>(rids.size());
+
+  std::ofstream ofs(file_name, std::ios::binary | std::ios::trunc);
+  if (!ofs.is_open()) {
+    throw Exception("Cannot open column store file " + file_name);
+  }
+
+  ColumnStoreHeader header{DISTRIBUTION_DATASET_COLUMN_STORE_MAGIC, dimension, block_size, size};
+  std::vector<char> padding(DISTRIBUTION_DATASET_COLUMN_STORE_ALIGNMENT, 0);
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(ColumnStoreHeader));
+  ofs.write(padding.data(), GetRIDsOffset() - static_cast<int64_t>(sizeof(ColumnStoreHeader)));
+
+  std::vector<int64_t> raw_rids(rids.size());
+  std::transform(rids.begin(), rids.end(), raw_rids.begin(), [](const RID &rid) { return rid.Get(); });
+  ofs.write(reinterpret_cast<const char *>(raw_rids.data()), size * static_cast<int64_t>(sizeof(int64_t)));
+  ofs.write(padding.data(), GetBlocksOffset(size) - GetRIDsOffset() - size * static_cast<int64_t>(sizeof(int64_t)));
+
+  // Read a block of rows from the pages, then write it out transposed
+  std::vector<ValueType> rows(static_cast<size_t>(block_size) * dimension);
+  std::vector<ValueType> columns(static_cast<size_t>(block_size) * dimension);
+  for (int64_t block_start = 0; block_start < size; block_start += block_size) {
+    auto block_rows = static_cast<int>(std::min<int64_t>(block_size, size - block_start));
+    auto found_size = manager->GetDistributionDataBatch(is_training_set,
+                                                        std::span<const RID>(rids).subspan(block_start, block_rows),
+                                                        rows.data());
+    if (found_size != block_rows) {
+      throw Exception("Data deleted while building the column store");
+    }
+
+    std::fill(columns.begin(), columns.end(), ValueType{});
+    for (int row = 0; row < block_rows; ++row) {
+      for (int i = 0; i < dimension; ++i) {
+        columns[static_cast<size_t>(i) * block_size + row] = rows[static_cast<size_t>(row) * dimension + i];
+      }
+    }
+    ofs.write(reinterpret_cast<const char *>(columns.data()),
+              static_cast<std::streamsize>(columns.size() * sizeof(ValueType)));
+  }
+
+  if (!ofs.good()) {
+    throw Exception("Failed to write column store file " + file_name);
+  }
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_COLUMN_STORE_TYPE::GetRID(int64_t index) const -> RID {
+  if (index < 0 || index >= size_) {
+    throw Exception("Index out of range");
+  }
+  return RID(rids_[index]);
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_COLUMN_STORE_TYPE::GetBlock(int64_t block_index, int *rows) const -> const ValueType * {
+  if (block_index < 0 || block_index >= GetBlockCount()) {
+    throw Exception("Block index out of range");
+  }
+  *rows = static_cast<int>(std::min<int64_t>(block_size_, size_ - block_index * block_size_));
+  return blocks_ + block_index * dimension_ * block_size_;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+void DISTRIBUTION_DATASET_COLUMN_STORE_TYPE::Project(const ValueType *lines, int line_count, ValueType *projections) const {
+  auto block_count = GetBlockCount();
+
+  auto grain_size = std::max<int64_t>(PARALLEL_GRAIN_SIZE / (static_cast<int64_t>(block_size_) * dimension_), 1);
+  ParallelFor(&WorkStealingPool::GetInstance(), int64_t{0}, block_count, grain_size, [&](int64_t begin, int64_t end) {
+    std::vector<ValueType> accumulation(block_size_);
+
+    for (int64_t block_index = begin; block_index < end; ++block_index) {
+      auto rows = 0;
+      auto block = GetBlock(block_index, &rows);
+      auto output = projections + block_index * block_size_ * line_count;
+
+      for (int line = 0; line < line_count; ++line) {
+        // Accumulate the block column by column, a column is block size contiguous values
+        std::fill(accumulation.begin(), accumulation.end(), ValueType{});
+        auto line_values = lines + static_cast<int64_t>(line) * dimension_;
+        for (int i = 0; i < dimension_; ++i) {
+          auto weight = line_values[i];
+          auto column = block + static_cast<int64_t>(i) * block_size_;
+          auto accumulation_data = accumulation.data();
+#pragma omp simd
+          for (int row = 0; row < block_size_; ++row) {
+            accumulation_data[row] += weight * column[row];
+          }
+        }
+
+        for (int row = 0; row < rows; ++row) {
+          output[static_cast<int64_t>(row) * line_count + line] = accumulation[row];
+        }
+      }
+    }
+  });
+}
+
+template class DistributionDataSetColumnStore<float>;
+
+} // namespace distribution_lsh
@@ -5,7 +5,14 @@
 //
 //===-----------------------------------------------------
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
 #include <memory>
+#include <numeric>
+#include <random>
+#include <thread>
 #include <utility>
 #include <dataset/distribution/distribution_dataset_manager.h>
 
@@ -45,6 +52,9 @@ DISTRIBUTION_DATASET_MANAGER_TYPE::DistributionDataSetManager(
     data_page_max_size_(data_page_max_size),
     training_set_file_id_(training_set_file_id),
     testing_set_file_id_(testing_set_file_id) {
+  std::random_device rd;
+  seed_ = static_cast<uint64_t>(rd()) << 32 | rd();
+
   // Check if training set matches testing set
   DISTRIBUTION_LSH_ENSURE(IsTrainingSetMatchTestingSet(), "Training set and testing set not matched");
 
@@ -61,8 +71,24 @@ DISTRIBUTION_DATASET_MANAGER_TYPE::DistributionDataSetManager(
     this->data_set_type_ = training_set_header_page->GetDataSetType();
     this->dimension_ = training_set_header_page->GetDimension();
     this->normalization_type_ = training_set_header_page->GetNormalizationType();
+    this->vector_encoding_ = training_set_header_page->GetVectorEncoding();
+    if (this->vector_encoding_ != VectorEncoding::FLOAT32) {
+      this->data_page_max_size_ = DataPage::GetEncodedCapacity(this->vector_encoding_);
+    }
     this->training_set_header_page_id_ = HEADER_PAGE_ID;
     this->testing_set_header_page_id_ = HEADER_PAGE_ID;
+    auto is_training_set_legacy = training_set_header_page->GetFormatVersion() == 0;
+    auto is_testing_set_legacy = testing_set_header_page->GetFormatVersion() == 0;
+    if ((is_training_set_legacy || is_testing_set_legacy) && this->data_set_type_ == DataSetType::GENERATION) {
+      throw Exception(fmt::format("Data set {} was written before its header page kept the size, the generation "
+                                  "parameters behind it cannot be read, regenerate the data set.", manager_name_));
+    }
+    if (this->data_set_type_ == DataSetType::GENERATION
+        && (training_set_header_page->GetFormatVersion() < DISTRIBUTION_DATASET_HEADER_PAGE_SEED_VERSION
+            || testing_set_header_page->GetFormatVersion() < DISTRIBUTION_DATASET_HEADER_PAGE_SEED_VERSION)) {
+      throw Exception(fmt::format("Data set {} was written before its header page kept the seed, the data appended to "
+                                  "it would not follow its seed, regenerate the data set.", manager_name_));
+    }
     switch (this->data_set_type_) {
       case DataSetType::INVALID_DATA_SET_TYPE: {
         throw Exception("Invalid data set type");
@@ -72,6 +98,7 @@ DISTRIBUTION_DATASET_MANAGER_TYPE::DistributionDataSetManager(
             reinterpret_cast<const DistributionDataSetGenerationHeaderPage *>(training_set_header_page);
         this->distribution_type_ = training_set_generation_header_page->GetDistributionType();
         this->params_ = training_set_generation_header_page->GetParameter();
+        this->seed_ = training_set_generation_header_page->GetSeed();
         break;
       }
       case DataSetType::MNIST:
@@ -80,6 +107,17 @@ DISTRIBUTION_DATASET_MANAGER_TYPE::DistributionDataSetManager(
         throw Exception("Unsupported data set type");
       }
     }
+
+    training_set_header_page_guard.Drop();
+    testing_set_header_page_guard.Drop();
+    BuildDirectoryIndex(true);
+    BuildDirectoryIndex(false);
+    if (is_training_set_legacy) {
+      UpgradeLegacyHeaderPage(true);
+    }
+    if (is_testing_set_legacy) {
+      UpgradeLegacyHeaderPage(false);
+    }
   } else {
     // Allocate header page for training set and testing set
     auto training_set_header_page_basic_guard = training_set_bpm_->NewPageGuarded(&training_set_header_page_id_);
@@ -103,12 +141,12 @@ DISTRIBUTION_DATASET_MANAGER_TYPE::DistributionDataSetManager(
         auto training_set_generation_header_page =
             reinterpret_cast<DistributionDataSetGenerationHeaderPage *>(training_set_header_page);
         training_set_generation_header_page->Init(this->training_set_file_id_, this->distribution_type_, this->normalization_type_, this->params_[0],
-                                                  this->params_[1], this->dimension_, INVALID_PAGE_ID);
+                                                  this->params_[1], this->dimension_, INVALID_PAGE_ID, seed_);
 
         auto testing_set_generation_header_page =
             reinterpret_cast<DistributionDataSetGenerationHeaderPage *>(testing_set_header_page);
         testing_set_generation_header_page->Init(this->testing_set_file_id_, this->distribution_type_, this->normalization_type_, this->params_[0],
-                                                 this->params_[1], this->dimension_, INVALID_PAGE_ID);
+                                                 this->params_[1], this->dimension_, INVALID_PAGE_ID, seed_);
         break;
       }
       case DataSetType::MNIST: {
@@ -144,6 +182,8 @@ auto DISTRIBUTION_DATASET_MANAGER_TYPE::IsEmpty(DistributionDataSetContext *ctx,
     return true;
   }
 
+  // The guard keeps the header page pinned while it is read
+  std::optional<ReadPageGuard> training_set_header_page_guard;
   auto training_set_header_page = ctx != nullptr && !is_read ? [&]() {
     if (ctx->training_set_header_page_.has_value()) {
       return ctx->training_set_header_page_.value().template As<DistributionDataSetHeaderPage>();
@@ -153,9 +193,10 @@ auto DISTRIBUTION_DATASET_MANAGER_TYPE::IsEmpty(DistributionDataSetContext *ctx,
   }() : [&]() {
     return ctx != nullptr && ctx->training_set_header_page_.has_value() ?
            ctx->training_set_header_page_.value().template As<DistributionDataSetHeaderPage>()
-           : training_set_bpm_->FetchPageRead(training_set_header_page_id_).template As<DistributionDataSetHeaderPage>();
+           : (training_set_header_page_guard = training_set_bpm_->FetchPageRead(training_set_header_page_id_))->template As<DistributionDataSetHeaderPage>();
   }();
 
+  std::optional<ReadPageGuard> testing_set_header_page_guard;
   auto testing_set_header_page = ctx != nullptr && !is_read ? [&]() {
     if (ctx->testing_set_header_page_.has_value()) {
       return ctx->testing_set_header_page_.value().template As<DistributionDataSetHeaderPage>();
@@ -165,12 +206,46 @@ auto DISTRIBUTION_DATASET_MANAGER_TYPE::IsEmpty(DistributionDataSetContext *ctx,
   }() : [&]() {
     return ctx != nullptr && ctx->testing_set_header_page_.has_value() ?
            ctx->testing_set_header_page_.value().template As<DistributionDataSetHeaderPage>()
-           : testing_set_bpm_->FetchPageRead(testing_set_header_page_id_).template As<DistributionDataSetHeaderPage>();
+           : (testing_set_header_page_guard = testing_set_bpm_->FetchPageRead(testing_set_header_page_id_))->template As<DistributionDataSetHeaderPage>();
   }();
 
   return training_set_header_page->IsEmpty() && testing_set_header_page->IsEmpty();
 }
 
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::SetVectorEncoding(VectorEncoding vector_encoding, int data_page_max_size) -> bool {
+  auto capacity = DataPage::GetEncodedCapacity(vector_encoding);
+  if (data_page_max_size < 0 || data_page_max_size > capacity) {
+    throw Exception("Data page max size exceeds the capacity of the encoding");
+  }
+
+  DistributionDataSetContext ctx;
+  if (!IsEmpty(&ctx, false)) {
+    LOG_DEBUG("Vector encoding can only be set on an empty data set");
+    return false;
+  }
+
+  ctx.training_set_header_page_->template AsMut<DistributionDataSetHeaderPage>()->SetVectorEncoding(vector_encoding);
+  ctx.testing_set_header_page_->template AsMut<DistributionDataSetHeaderPage>()->SetVectorEncoding(vector_encoding);
+  vector_encoding_ = vector_encoding;
+  data_page_max_size_ = data_page_max_size == 0 ? capacity : data_page_max_size;
+  return true;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+void DISTRIBUTION_DATASET_MANAGER_TYPE::SetSeed(uint64_t seed) {
+  seed_ = seed;
+  if (data_set_type_ != DataSetType::GENERATION) {
+    return;
+  }
+
+  // Both sets keep the seed, the testing set draws from a stream derived from it
+  auto training_set_header_page_guard = training_set_bpm_->FetchPageWrite(training_set_header_page_id_);
+  training_set_header_page_guard.template AsMut<DistributionDataSetGenerationHeaderPage>()->SetSeed(seed);
+  auto testing_set_header_page_guard = testing_set_bpm_->FetchPageWrite(testing_set_header_page_id_);
+  testing_set_header_page_guard.template AsMut<DistributionDataSetGenerationHeaderPage>()->SetSeed(seed);
+}
+
 DISTRIBUTION_DATASET_TEMPLATE
 auto DISTRIBUTION_DATASET_MANAGER_TYPE::IsTrainingSetMatchTestingSet() -> bool {
   if (IsEmpty()) {
@@ -234,60 +309,122 @@ auto DISTRIBUTION_DATASET_MANAGER_TYPE::GenerateDistributionDataset(int size, fl
     auto testing_set_directory_page =
         testing_set_directory_page_guard.template AsMut<DistributionDataSetDirectoryPage>();
     testing_set_directory_page->Init(directory_page_max_size_);
+
+    training_set_directory_page_ids_.assign({training_set_header_page->directory_start_page_id_});
+    testing_set_directory_page_ids_.assign({testing_set_header_page->directory_start_page_id_});
   }
 
-  // Generate training set and testing set data
-  auto training_set_data = [&]() {
-    switch (this->data_set_type_) {
-      case DataSetType::INVALID_DATA_SET_TYPE : throw Exception("Invalid data set type");
-      case DataSetType::GENERATION: {
-        return ddp_->GenerationDistributionDataset(this->dimension_,
-                                                   static_cast<int>(static_cast<float>(size) * ratio),
-                                                   this->distribution_type_,
-                                                   this->normalization_type_,
-                                                   this->params_.get());
-      }
-      case DataSetType::MNIST: {
-        return ddp_->MNISTDistributionDataset(static_cast<int>(static_cast<float>(size) * ratio),
-                                              this->directory_name_,
-                                              this->normalization_type_);
-      }
-      case DataSetType::CIFAR10:
-      default: throw Exception("Unsupported data set type");
+  auto training_set_size = static_cast<int>(static_cast<float>(size) * ratio);
+  auto testing_set_size = static_cast<int>(static_cast<float>(size) * (1 - ratio));
+
+  // Data is produced chunk by chunk and stored while the next chunk is being produced
+  switch (this->data_set_type_) {
+    case DataSetType::INVALID_DATA_SET_TYPE : throw Exception("Invalid data set type");
+    case DataSetType::GENERATION: {
+      // Training set and testing set are two independent streams of the same seed
+      IngestAndStore(true, training_set_size, GenerationProducer(seed_), &ctx);
+      IngestAndStore(false, testing_set_size, GenerationProducer(seed_ ^ 0x9E37'79B9'7F4A'7C15UL), &ctx);
+      break;
     }
-  }();
+    case DataSetType::MNIST:
+    case DataSetType::CIFAR10: {
+      IngestAndStore(true, training_set_size, RawDataSetProducer(true), &ctx);
+      IngestAndStore(false, testing_set_size, RawDataSetProducer(false), &ctx);
+      break;
+    }
+    default: throw Exception("Unsupported data set type");
+  }
 
-  auto testing_set_data = [&]() {
-    switch (this->data_set_type_) {
-      case DataSetType::INVALID_DATA_SET_TYPE : throw Exception("Invalid data set type");
-      case DataSetType::GENERATION: {
-        return ddp_->GenerationDistributionDataset(this->dimension_,
-                                                   static_cast<int>(static_cast<float>(size) * (1 - ratio)),
-                                                   this->distribution_type_,
-                                                   this->normalization_type_,
-                                                   this->params_.get());
+  return true;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::GenerationProducer(uint64_t seed) -> DataProducer {
+  return [this, seed](ValueType *chunk, int64_t start_row, int size) {
+    ddp_->GenerationDistributionDataset(chunk,
+                                        this->dimension_,
+                                        start_row,
+                                        size,
+                                        this->distribution_type_,
+                                        this->normalization_type_,
+                                        this->params_.get(),
+                                        seed);
+    return size;
+  };
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::RawDataSetProducer(bool is_training_set) -> DataProducer {
+  std::shared_ptr<RawDataSetReader<ValueType>> reader =
+      OpenRawDataSetReader<ValueType>(this->data_set_type_, this->directory_name_, is_training_set);
+  if (reader->GetDimension() != this->dimension_) {
+    throw Exception("Dimension of the data set does not match the raw data set");
+  }
+
+  // Rows are read sequentially, the reader keeps the position
+  return [this, reader](ValueType *chunk, [[maybe_unused]] int64_t start_row, int size) {
+    return ddp_->ReadDistributionDataset(reader.get(), chunk, size, this->normalization_type_);
+  };
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+void DISTRIBUTION_DATASET_MANAGER_TYPE::IngestAndStore(bool is_training_set,
+                                                       int size,
+                                                       const DataProducer &producer,
+                                                       DistributionDataSetContext *ctx) {
+  if (size <= 0) {
+    return;
+  }
+
+  // Chunk buffers circulate between the producer and this thread, so at most
+  // DISTRIBUTION_DATASET_INGEST_QUEUE_DEPTH chunks are in memory whatever the size of the data set
+  auto chunk_size = std::min(size, DISTRIBUTION_DATASET_CHUNK_SIZE);
+  Channel<std::unique_ptr<ValueType[]>> free_chunks;
+  Channel<std::pair<std::unique_ptr<ValueType[]>, int>> produced_chunks;   // a chunk of 0 rows ends the stream
+  for (int i = 0; i < DISTRIBUTION_DATASET_INGEST_QUEUE_DEPTH; ++i) {
+    free_chunks.Put(std::unique_ptr<ValueType[]>(new ValueType[static_cast<int64_t>(chunk_size) * this->dimension_]));
+  }
+
+  std::atomic<bool> is_stopped{false};
+  std::exception_ptr producer_exception;
+  std::thread producer_thread([&]() {
+    try {
+      for (int start_row = 0; start_row < size && !is_stopped.load();) {
+        auto chunk = free_chunks.Get();
+        auto rows = producer(chunk.get(), start_row, std::min(chunk_size, size - start_row));
+        if (rows <= 0) {
+          break;
+        }
+        produced_chunks.Put({std::move(chunk), rows});
+        start_row += rows;
       }
-      case DataSetType::MNIST: {
-        return ddp_->MNISTDistributionDataset(static_cast<int>(static_cast<float>(size) * (1 - ratio)),
-                                              this->directory_name_,
-                                              this->normalization_type_);
+    } catch (...) {
+      producer_exception = std::current_exception();
+    }
+    produced_chunks.Put({nullptr, 0});
+  });
+
+  // Keep draining after a failure so that the producer never blocks on a free chunk
+  std::exception_ptr consumer_exception;
+  for (auto chunk = produced_chunks.Get(); chunk.second > 0; chunk = produced_chunks.Get()) {
+    if (consumer_exception == nullptr) {
+      try {
+        StoreBatch(is_training_set, chunk.first.get(), chunk.second, ctx);
+      } catch (...) {
+        consumer_exception = std::current_exception();
+        is_stopped.store(true);
       }
-      case DataSetType::CIFAR10:
-      default: throw Exception("Unsupported data set type");
     }
-  }();
-
-  // Store training set data
-  for (int current = 0; current < static_cast<int>(static_cast<float>(size) * ratio); ++current) {
-    Store(true, &training_set_data[current * this->dimension_], &ctx);
+    free_chunks.Put(std::move(chunk.first));
   }
+  producer_thread.join();
 
-  // Store testing set data
-  for (int current = 0; current < static_cast<int>(static_cast<float>(size) * (1 - ratio)); ++current) {
-    Store(false, &testing_set_data[current * this->dimension_], &ctx);
+  if (consumer_exception != nullptr) {
+    std::rethrow_exception(consumer_exception);
+  }
+  if (producer_exception != nullptr) {
+    std::rethrow_exception(producer_exception);
   }
-
-  return true;
 }
 
 DISTRIBUTION_DATASET_TEMPLATE
@@ -296,146 +433,218 @@ auto DISTRIBUTION_DATASET_MANAGER_TYPE::Store(bool is_training_set, ValueType *d
 
   // Judge data set type and locate the target directory page
   auto bpm = is_training_set ? training_set_bpm_ : testing_set_bpm_;
-  auto header_page_id = is_training_set ? training_set_header_page_id_ : testing_set_header_page_id_;
-  auto header_page = is_training_set ?
-      [&]() {
-        if (ctx != nullptr && ctx->training_set_header_page_.has_value()) {
-          return ctx->training_set_header_page_->template AsMut<DistributionDataSetHeaderPage>();
-        }
-        dataset_ctx.training_set_header_page_ = bpm->FetchPageWrite(header_page_id);
-        return dataset_ctx.training_set_header_page_->template AsMut<DistributionDataSetHeaderPage>();
-  }() :
-      [&]() {
-        if (ctx != nullptr && ctx->testing_set_header_page_.has_value()) {
-          return ctx->testing_set_header_page_->template AsMut<DistributionDataSetHeaderPage>();
-        }
-        dataset_ctx.testing_set_header_page_ = bpm->FetchPageWrite(header_page_id);
-        return dataset_ctx.testing_set_header_page_->template AsMut<DistributionDataSetHeaderPage>();
-  }();
-
-  auto directory_page_guard = bpm->FetchPageWrite(header_page->directory_start_page_id_);
-  dataset_ctx.write_set_.emplace_back(std::move(directory_page_guard));
+  // The latch of header page guards the directory index and the size
+  auto header_page = FetchHeaderPageWrite(is_training_set, ctx, &dataset_ctx);
 
   // Locate the last of the directory page
-  auto directory_page = dataset_ctx.write_set_.back().template AsMut<DistributionDataSetDirectoryPage>();
-  while (directory_page->next_page_id_ != INVALID_PAGE_ID) {
-    directory_page_guard = bpm->FetchPageWrite(directory_page->next_page_id_);
-    dataset_ctx.write_set_.pop_front();
-    dataset_ctx.write_set_.emplace_back(std::move(directory_page_guard));
-    directory_page = dataset_ctx.write_set_.back().template AsMut<DistributionDataSetDirectoryPage>();
+  auto &directory_page_ids = is_training_set ? training_set_directory_page_ids_ : testing_set_directory_page_ids_;
+  if (directory_page_ids.empty()) {
+    throw Exception("The directory page of data set is not allocated");
   }
 
+  dataset_ctx.write_set_.emplace_back(bpm->FetchPageWrite(directory_page_ids.back()));
+  auto directory_page = dataset_ctx.write_set_.back().template AsMut<DistributionDataSetDirectoryPage>();
+
   // Update the directory page
   // If it has full, update a new page
   if (directory_page->GetSize() == directory_page->GetMaxSize()) {
-    auto directory_page_basic_guard = bpm->NewPageGuarded(&directory_page->next_page_id_);
-    if (directory_page->next_page_id_ == INVALID_PAGE_ID) {
-      throw Exception("Allocate directory page failed");
-    }
-    directory_page_guard = directory_page_basic_guard.UpgradeWrite();
-    dataset_ctx.write_set_.emplace_back(std::move(directory_page_guard));
-    directory_page = dataset_ctx.write_set_.back().AsMut<DistributionDataSetDirectoryPage>();
-    directory_page->Init(directory_page_max_size_);
+    dataset_ctx.write_set_.emplace_back(AppendDirectoryPage(bpm.get(), directory_page, &directory_page_ids));
+    directory_page = dataset_ctx.write_set_.back().template AsMut<DistributionDataSetDirectoryPage>();
     dataset_ctx.write_set_.pop_front();
   }
 
-  // Store the data with multi-pages
-  auto data_page_id = INVALID_PAGE_ID;
-  auto data_page_guard = bpm->NewPageGuarded(&data_page_id);
-  if (data_page_id == INVALID_PAGE_ID) {
-    throw Exception("Allocate data page for data set failed");
+  // Store the data with multi-pages, then publish it in the directory page
+  auto start_data_page_id = StoreDataPages(bpm.get(), distribution);
+
+  auto slot = -1;
+  directory_page->Insert(start_data_page_id, &slot);
+  header_page->IncreaseSize(1);
+
+  return {dataset_ctx.write_set_.back().PageId(), static_cast<uint32_t>(slot)};
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::StoreBatch(bool is_training_set,
+                                                   const ValueType *distribution,
+                                                   int size,
+                                                   DistributionDataSetContext *ctx) -> std::vector<RID> {
+  DistributionDataSetContext dataset_ctx;
+  std::vector<RID> rids;
+  rids.reserve(std::max(size, 0));
+  if (size <= 0) {
+    return rids;
   }
 
-  dataset_ctx.write_set_.emplace_front(data_page_guard.UpgradeWrite());
-  DataPage *data_page = dataset_ctx.write_set_.front().template AsMut<DataPage>();
-  data_page->Init(this->data_page_max_size_);
-  
-  auto current_data_page_id = data_page_id;
-  DataPage *current_data_page = data_page;
-  
-  auto start_data_page_id = data_page_id;
-  std::deque<page_id_t > data_page_id_list;
-  data_page_id_list.emplace_front(data_page_id);
+  auto bpm = is_training_set ? training_set_bpm_ : testing_set_bpm_;
+  auto header_page = FetchHeaderPageWrite(is_training_set, ctx, &dataset_ctx);
 
+  auto &directory_page_ids = is_training_set ? training_set_directory_page_ids_ : testing_set_directory_page_ids_;
+  if (directory_page_ids.empty()) {
+    throw Exception("The directory page of data set is not allocated");
+  }
 
-  auto slot = -1;
-  directory_page->Insert(start_data_page_id, &slot);
+  // Cursor on the tail directory page, it only moves forward when the page is full
+  dataset_ctx.write_set_.emplace_back(bpm->FetchPageWrite(directory_page_ids.back()));
+  auto directory_page = dataset_ctx.write_set_.back().template AsMut<DistributionDataSetDirectoryPage>();
 
-  for (int current_size = 0; current_size < this->dimension_; current_size += this->data_page_max_size_) {
-    if (dimension_ - current_size > this->data_page_max_size_) {
-      memcpy(reinterpret_cast<char *>(current_data_page->array_), reinterpret_cast<char *>(&distribution[current_size]),
-             sizeof(ValueType) * this->data_page_max_size_);
+  for (int current = 0; current < size; ++current) {
+    if (directory_page->GetSize() == directory_page->GetMaxSize()) {
+      dataset_ctx.write_set_.emplace_back(AppendDirectoryPage(bpm.get(), directory_page, &directory_page_ids));
+      directory_page = dataset_ctx.write_set_.back().template AsMut<DistributionDataSetDirectoryPage>();
+      dataset_ctx.write_set_.pop_front();
+    }
 
-      current_data_page->SetSize(this->data_page_max_size_);
+    auto start_data_page_id = StoreDataPages(bpm.get(), &distribution[static_cast<int64_t>(current) * this->dimension_]);
 
-      // Allocate new data page
-      data_page_id = INVALID_PAGE_ID;
-      data_page_guard = bpm->NewPageGuarded(&data_page_id);
-      if (data_page_id == INVALID_PAGE_ID) {
-        // Roll back
-        directory_page->Delete(start_data_page_id);
-
-        //  Delete page allocated before
-        while (!data_page_id_list.empty()) {
-          // Delete current page
-          if (data_page_id_list.front() == current_data_page_id) {
-            dataset_ctx.write_set_.pop_front();
-          }
-
-          bpm->DeletePage(data_page_id_list.front());
-          data_page_id_list.pop_front();
-        }
+    auto slot = -1;
+    directory_page->Insert(start_data_page_id, &slot);
+    header_page->IncreaseSize(1);
+    rids.emplace_back(dataset_ctx.write_set_.back().PageId(), static_cast<uint32_t>(slot));
+  }
+
+  return rids;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::FetchHeaderPageWrite(bool is_training_set,
+                                                             DistributionDataSetContext *ctx,
+                                                             DistributionDataSetContext *dataset_ctx) -> DistributionDataSetHeaderPage * {
+  auto bpm = is_training_set ? training_set_bpm_ : testing_set_bpm_;
+  auto header_page_id = is_training_set ? training_set_header_page_id_ : testing_set_header_page_id_;
+  auto &header_page_guard = is_training_set ? dataset_ctx->training_set_header_page_ : dataset_ctx->testing_set_header_page_;
+  if (ctx != nullptr) {
+    auto &ctx_header_page_guard = is_training_set ? ctx->training_set_header_page_ : ctx->testing_set_header_page_;
+    if (ctx_header_page_guard.has_value()) {
+      return ctx_header_page_guard->template AsMut<DistributionDataSetHeaderPage>();
+    }
+  }
+
+  header_page_guard = bpm->FetchPageWrite(header_page_id);
+  return header_page_guard->template AsMut<DistributionDataSetHeaderPage>();
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::AppendDirectoryPage(BufferPoolManager *bpm,
+                                                            DistributionDataSetDirectoryPage *directory_page,
+                                                            std::vector<page_id_t> *directory_page_ids) -> WritePageGuard {
+  auto directory_page_basic_guard = bpm->NewPageGuarded(&directory_page->next_page_id_);
+  if (directory_page->next_page_id_ == INVALID_PAGE_ID) {
+    throw Exception("Allocate directory page failed");
+  }
+
+  auto directory_page_guard = directory_page_basic_guard.UpgradeWrite();
+  directory_page_guard.template AsMut<DistributionDataSetDirectoryPage>()->Init(directory_page_max_size_);
+  directory_page_ids->emplace_back(directory_page_guard.PageId());
+  return directory_page_guard;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::StoreDataPages(BufferPoolManager *bpm, const ValueType *distribution) -> page_id_t {
+  std::vector<page_id_t> data_page_ids;
+  std::optional<WritePageGuard> previous_data_page_guard;
+
+  // Quantization parameters cover the whole vector, every page of the chain keeps a copy
+  auto scale = 0.0F;
+  auto offset = 0.0F;
+  if (vector_encoding_ == VectorEncoding::UINT8) {
+    ComputeQuantizationRange(distribution, this->dimension_, &scale, &offset);
+  }
+
+  // Pages of a chain take a run of contiguous page ids, so that a data is read sequentially. A single page reuses
+  // the freed page ids instead.
+  auto page_count = (this->dimension_ + this->data_page_max_size_ - 1) / this->data_page_max_size_;
+  auto first_data_page_id = page_count > 1 ? bpm->ReservePages(page_count) : INVALID_PAGE_ID;
 
-        throw Exception("Allocate data page for data set failed");
+  for (int current_size = 0; current_size < this->dimension_; current_size += this->data_page_max_size_) {
+    auto data_page_id = first_data_page_id == INVALID_PAGE_ID ? INVALID_PAGE_ID
+                                                              : first_data_page_id + static_cast<int>(data_page_ids.size());
+    auto data_page_basic_guard = first_data_page_id == INVALID_PAGE_ID ? bpm->NewPageGuarded(&data_page_id)
+                                                                       : bpm->NewReservedPageGuarded(&data_page_id);
+    if (data_page_id == INVALID_PAGE_ID) {
+      // Roll back, delete pages allocated before and give back the rest of the run
+      previous_data_page_guard.reset();
+      for (auto allocated_data_page_id : data_page_ids) {
+        bpm->DeletePage(allocated_data_page_id);
+      }
+      if (first_data_page_id != INVALID_PAGE_ID) {
+        bpm->ReleasePages(first_data_page_id + static_cast<int>(data_page_ids.size()),
+                          page_count - static_cast<int>(data_page_ids.size()));
       }
+      throw Exception("Allocate data page for data set failed");
+    }
 
-      current_data_page->SetNextPageId(data_page_id);
-      dataset_ctx.write_set_.emplace_front(data_page_guard.UpgradeWrite());
-      data_page = dataset_ctx.write_set_.front().template AsMut<DataPage>();
-      data_page->Init(this->data_page_max_size_);
-      
-      // Update the current page
-      current_data_page = data_page;
-      current_data_page_id = data_page_id;
-    } else {
-      memcpy(reinterpret_cast<char *>(current_data_page->array_), reinterpret_cast<char *>(&distribution[current_size]),
-             sizeof(ValueType) * (dimension_ - current_size));
-      current_data_page->SetSize(dimension_ - current_size);
+    auto data_page_guard = data_page_basic_guard.UpgradeWrite();
+    auto data_page = data_page_guard.template AsMut<DataPage>();
+    data_page->Init(this->data_page_max_size_);
+
+    auto length = std::min(this->dimension_ - current_size, this->data_page_max_size_);
+    data_page->Encode(&distribution[current_size], length, vector_encoding_, scale, offset);
+
+    // Link the page to the previous one, which is not needed any more
+    if (previous_data_page_guard.has_value()) {
+      previous_data_page_guard->template AsMut<DataPage>()->SetNextPageId(data_page_id);
     }
+    previous_data_page_guard.reset();
+    previous_data_page_guard.emplace(std::move(data_page_guard));
+    data_page_ids.emplace_back(data_page_id);
   }
 
-  return {dataset_ctx.write_set_.back().PageId(), static_cast<uint32_t>(slot)};
+  return data_page_ids.front();
 }
 
 DISTRIBUTION_DATASET_TEMPLATE
 auto DISTRIBUTION_DATASET_MANAGER_TYPE::GetSize(bool is_training_set) -> int {
-  if (IsEmpty()) {
+  auto bpm = is_training_set ? training_set_bpm_ : testing_set_bpm_;
+  auto header_page_id = is_training_set ? training_set_header_page_id_ : testing_set_header_page_id_;
+  if (header_page_id == INVALID_PAGE_ID) {
     return 0;
   }
 
-  DistributionDataSetContext context;
-  auto distribution_dataset_size = 0;
+  // Size is maintained in the header page
+  auto header_page_guard = bpm->FetchPageRead(header_page_id);
+  auto header_page = header_page_guard.template As<DistributionDataSetHeaderPage>();
+
+  return header_page->IsEmpty() ? 0 : header_page->GetSize();
+}
 
+DISTRIBUTION_DATASET_TEMPLATE
+void DISTRIBUTION_DATASET_MANAGER_TYPE::BuildDirectoryIndex(bool is_training_set) {
   auto bpm = is_training_set ? training_set_bpm_ : testing_set_bpm_;
   auto header_page_id = is_training_set ? training_set_header_page_id_ : testing_set_header_page_id_;
+  auto &directory_page_ids = is_training_set ? training_set_directory_page_ids_ : testing_set_directory_page_ids_;
+  directory_page_ids.clear();
+
   auto header_page_guard = bpm->FetchPageRead(header_page_id);
   auto header_page = header_page_guard.template As<DistributionDataSetHeaderPage>();
-
-  auto directory_page_guard = bpm->FetchPageRead(header_page->directory_start_page_id_);
-  auto directory_page = directory_page_guard.template As<DistributionDataSetDirectoryPage>();
-  context.read_set_.emplace_back(std::move(directory_page_guard));
-
-  while (directory_page->GetNextPageId() != INVALID_PAGE_ID) {
-    distribution_dataset_size += directory_page->GetSize();
-    directory_page_guard = bpm->FetchPageRead(directory_page->GetNextPageId());
-    context.read_set_.pop_front();
-    context.read_set_.emplace_back(std::move(directory_page_guard));
-    directory_page = context.read_set_.back().template As<DistributionDataSetDirectoryPage>();
+  auto directory_page_id = header_page->directory_start_page_id_;
+  while (directory_page_id != INVALID_PAGE_ID && directory_page_id != HEADER_PAGE_ID) {
+    auto directory_page_guard = bpm->FetchPageRead(directory_page_id);
+    auto directory_page = directory_page_guard.template As<DistributionDataSetDirectoryPage>();
+    // Files written with another directory page size keep their own, global indexes are located by it
+    if (directory_page_ids.empty()) {
+      directory_page_max_size_ = directory_page->GetMaxSize();
+    }
+    directory_page_ids.emplace_back(directory_page_id);
+    directory_page_id = directory_page->GetNextPageId();
   }
+}
 
-  distribution_dataset_size += directory_page->GetSize();
+DISTRIBUTION_DATASET_TEMPLATE
+void DISTRIBUTION_DATASET_MANAGER_TYPE::UpgradeLegacyHeaderPage(bool is_training_set) {
+  auto bpm = is_training_set ? training_set_bpm_ : testing_set_bpm_;
+  auto header_page_id = is_training_set ? training_set_header_page_id_ : testing_set_header_page_id_;
+  const auto &directory_page_ids = is_training_set ? training_set_directory_page_ids_ : testing_set_directory_page_ids_;
 
-  return distribution_dataset_size;
+  auto header_page_guard = bpm->FetchPageWrite(header_page_id);
+  auto header_page = header_page_guard.template AsMut<DistributionDataSetHeaderPage>();
+  int size = 0;
+  for (const auto &directory_page_id : directory_page_ids) {
+    auto directory_page_guard = bpm->FetchPageRead(directory_page_id);
+    size += directory_page_guard.template As<DistributionDataSetDirectoryPage>()->GetSize();
+  }
+  header_page->SetSize(size);
+  header_page->SetFormatVersion(DISTRIBUTION_DATASET_HEADER_PAGE_VERSION);
+  LOG_INFO("%s", fmt::format("upgrade legacy header page of data set {}, size: {}", manager_name_, size).data());
 }
 
 DISTRIBUTION_DATASET_TEMPLATE
@@ -444,116 +653,249 @@ auto DISTRIBUTION_DATASET_MANAGER_TYPE::GetDistributionData(bool is_training_set
                                                             int index) -> std::shared_ptr<ValueType[]> {
   std::shared_ptr<ValueType[]> distribution_data(new ValueType[this->dimension_]);
 
-  auto bpm = is_training_set ? training_set_bpm_ : testing_set_bpm_;
-  auto directory_page_guard = bpm->FetchPageRead(directory_page_id);
-  auto data_set_page = directory_page_guard.template As<DistributionDataSetPage>();
-  if (!data_set_page->IsDirectoryPage()) {
-    throw Exception("The input page is not a directory page");
-  }
+  auto is_found = VisitDistributionData(is_training_set, directory_page_id, index,
+                                        [&](const ValueType *chunk, int offset, int length) {
+    memcpy(distribution_data.get() + offset, chunk, length * sizeof(ValueType));
+  });
 
-  auto directory_page = reinterpret_cast<const DistributionDataSetDirectoryPage *>(data_set_page);
-  auto data_page_id = directory_page->IndexAt(index);
-  if (data_page_id == INVALID_PAGE_ID) {
-    LOG_DEBUG("Invalid index page");
-    return nullptr;
-  }
-  auto data_page_guard = bpm->FetchPageRead(data_page_id);
-  const DataPage *data_page = data_page_guard.template As<DataPage>();
+  return is_found ? distribution_data : nullptr;
+}
 
-  auto current_size = 0;
-  while (current_size < this->dimension_) {
-    if (this->dimension_ - current_size > data_page_max_size_) {
-      memcpy(distribution_data.get() + current_size, data_page->array_, data_page_max_size_ * sizeof(ValueType));
-      current_size += data_page_max_size_;
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::GetDistributionDataAsync(bool is_training_set,
+                                                                 page_id_t directory_page_id,
+                                                                 int index) -> Task<std::shared_ptr<ValueType[]>> {
+  auto bpm = is_training_set ? training_set_bpm_.get() : testing_set_bpm_.get();
+
+  // No page is latched across a fetch, as the coroutine may resume on another thread. The slot is read again once
+  // the data is read: a delete in between drops the copy, and the data is read again from the new slot.
+  auto read_slot = [bpm, directory_page_id, index]() -> Task<page_id_t> {
+    auto directory_page_guard = co_await bpm->FetchPageReadAsync(directory_page_id);
+    auto data_set_page = directory_page_guard.template As<DistributionDataSetPage>();
+    if (!data_set_page->IsDirectoryPage()) {
+      throw Exception("The input page is not a directory page");
+    }
+    co_return reinterpret_cast<const DistributionDataSetDirectoryPage *>(data_set_page)->IndexAt(index);
+  };
 
-      if (data_page->next_page_id_ == INVALID_PAGE_ID) {
-        throw Exception("The data page is not a linked list");
+  std::shared_ptr<ValueType[]> distribution_data(new ValueType[this->dimension_]);
+  std::unique_ptr<ValueType[]> decoded(new ValueType[DISTRIBUTION_LSH_PAGE_SIZE]);
+  auto data_page_id = co_await read_slot();
+  while (data_page_id != INVALID_PAGE_ID) {
+    // Same walk as VisitDataPages, each page of the chain is fetched without blocking
+    const char *error = nullptr;
+    auto current_size = 0;
+    auto next_page_id = data_page_id;
+    while (current_size < this->dimension_) {
+      if (next_page_id == INVALID_PAGE_ID) {
+        error = "The data page is not a linked list";
+        break;
+      }
+      auto data_page_guard = co_await bpm->FetchPageReadAsync(next_page_id);
+      const DataPage *data_page = data_page_guard.template As<DataPage>();
+      auto length = std::min(this->dimension_ - current_size, data_page->GetSize());
+      if (length <= 0) {
+        error = "The data page is empty";
+        break;
       }
+      memcpy(distribution_data.get() + current_size, data_page->Decode(vector_encoding_, decoded.get()), length * sizeof(ValueType));
+      current_size += length;
+      next_page_id = data_page->next_page_id_;
+    }
 
-      data_page_guard.Drop();
-      data_page_guard = bpm->FetchPageRead(data_page->next_page_id_);
-      data_page = data_page_guard.template As<DataPage>();
-    } else {
-      memcpy(distribution_data.get() + current_size,
-             data_page->array_,
-             (this->dimension_ - current_size) * sizeof(ValueType));
-      current_size = this->dimension_;
+    // A broken chain is an error only if the data was not deleted while it was read
+    auto current_data_page_id = co_await read_slot();
+    if (current_data_page_id == data_page_id) {
+      if (error != nullptr) {
+        throw Exception(error);
+      }
+      co_return distribution_data;
     }
+    data_page_id = current_data_page_id;
   }
 
-  return distribution_data;
+  LOG_DEBUG("Invalid index page");
+  co_return nullptr;
 }
 
 // TODO return different exception type for different error cases
 DISTRIBUTION_DATASET_TEMPLATE
 auto DISTRIBUTION_DATASET_MANAGER_TYPE::GetDistributionData(bool is_training_set, int index, page_id_t *directory_page_id, int *slot) -> std::shared_ptr<ValueType[]> {
-  if (IsEmpty()) {
+  auto bpm = is_training_set ? training_set_bpm_ : testing_set_bpm_;
+  auto header_page_id = is_training_set ? training_set_header_page_id_ : testing_set_header_page_id_;
+  auto header_page_guard = bpm->FetchPageRead(header_page_id);
+  auto header_page = header_page_guard.template As<DistributionDataSetHeaderPage>();
+  if (header_page->IsEmpty() || header_page->GetSize() == 0) {
     LOG_DEBUG("The file is empty");
     return nullptr;
   }
 
-  DistributionDataSetContext directory_ctx;
   std::shared_ptr<ValueType[]> distribution_data(new ValueType[this->dimension_]);
 
+  // Locate the target directory page by the directory index
+  const auto &directory_page_ids = is_training_set ? training_set_directory_page_ids_ : testing_set_directory_page_ids_;
+  auto directory_page_position = index / directory_page_max_size_;
+  if (index < 0 || directory_page_position >= static_cast<int>(directory_page_ids.size())) {
+    throw Exception("Invalid index");
+  }
+
+  *directory_page_id = directory_page_ids[directory_page_position];
+  *slot = index % directory_page_max_size_;
+  auto directory_page_guard = bpm->FetchPageRead(*directory_page_id);
+  auto directory_page = directory_page_guard.template As<DistributionDataSetDirectoryPage>();
+  header_page_guard.Drop();
+
+  // Locate the data
+  auto data_page_id = directory_page->IndexAt(*slot);
+  if (data_page_id == INVALID_PAGE_ID) {
+    LOG_DEBUG("Invalid index page");
+    return nullptr;
+  }
+
+  std::vector<ValueType> decoded;
+  VisitDataPages(bpm.get(), data_page_id, &decoded, [&](const ValueType *chunk, int offset, int length) {
+    memcpy(distribution_data.get() + offset, chunk, length * sizeof(ValueType));
+  });
+
+  return distribution_data;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::GetRIDs(bool is_training_set) -> std::vector<RID> {
   auto bpm = is_training_set ? training_set_bpm_ : testing_set_bpm_;
   auto header_page_id = is_training_set ? training_set_header_page_id_ : testing_set_header_page_id_;
   auto header_page_guard = bpm->FetchPageRead(header_page_id);
   auto header_page = header_page_guard.template As<DistributionDataSetHeaderPage>();
-  auto directory_page_guard = bpm->FetchPageRead(header_page->directory_start_page_id_);
-  auto directory_page = directory_page_guard.template As<DistributionDataSetDirectoryPage>();
-  directory_ctx.read_set_.emplace_back(std::move(directory_page_guard));
-
-  // Locate the target directory page
-  auto directory_current_size = 0;
-  while (directory_current_size <= index) {
-    if (directory_page->GetMaxSize() > index - directory_current_size) {
-      *directory_page_id = directory_ctx.read_set_.back().PageId();
-      *slot = index - directory_current_size;
-      break;
-    }
 
-    if (directory_page->GetNextPageId() == INVALID_PAGE_ID) {
-      throw Exception("Invalid index");
+  std::vector<RID> rids;
+  if (header_page->IsEmpty()) {
+    return rids;
+  }
+  rids.reserve(header_page->GetSize());
+
+  // The latch of header page keeps the directory index stable while walking it
+  const auto &directory_page_ids = is_training_set ? training_set_directory_page_ids_ : testing_set_directory_page_ids_;
+  for (auto directory_page_id : directory_page_ids) {
+    auto directory_page_guard = bpm->FetchPageRead(directory_page_id);
+    auto directory_page = directory_page_guard.template As<DistributionDataSetDirectoryPage>();
+    for (int slot = 0; slot < directory_page->GetEndOfArray(); ++slot) {
+      if (directory_page->IndexAt(slot) != INVALID_PAGE_ID) {
+        rids.emplace_back(directory_page_id, static_cast<uint32_t>(slot));
+      }
     }
-
-    directory_current_size += directory_page->GetMaxSize();
-    directory_page_guard = bpm->FetchPageRead(directory_page->GetNextPageId());
-    directory_ctx.read_set_.pop_front();
-    directory_ctx.read_set_.emplace_back(std::move(directory_page_guard));
-    directory_page = directory_ctx.read_set_.back().template As<DistributionDataSetDirectoryPage>();
   }
 
-  // Locate the data
-  auto data_page_id = directory_page->IndexAt(index - directory_current_size);
-  if (data_page_id == INVALID_PAGE_ID) {
-    LOG_DEBUG("Invalid index page");
-    return nullptr;
+  return rids;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::GetDistributionDataBatch(bool is_training_set,
+                                                                 std::span<const RID> rids,
+                                                                 ValueType *distribution_data,
+                                                                 std::vector<bool> *is_found) -> int {
+  auto bpm = is_training_set ? training_set_bpm_.get() : testing_set_bpm_.get();
+  if (is_found != nullptr) {
+    is_found->assign(rids.size(), false);
   }
-  auto data_page_guard = bpm->FetchPageRead(data_page_id);
-  const DataPage *data_page = data_page_guard.template As<DataPage>();
 
-  auto current_size = 0;
-  while (current_size < this->dimension_) {
-    if (this->dimension_ - current_size > data_page_max_size_) {
-      memcpy(distribution_data.get() + current_size, data_page->array_, data_page_max_size_ * sizeof (ValueType));
-      current_size += data_page_max_size_;
+  // Group the requests by directory page
+  std::vector<size_t> order(rids.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](size_t left, size_t right) { return rids[left] < rids[right]; });
+
+  // (start data page id, output row) of a directory page group
+  std::vector<std::pair<page_id_t, size_t>> data_page_requests;
+  std::vector<ValueType> decoded;
+  auto found_size = 0;
+  auto group_start = static_cast<size_t>(0);
+  while (group_start < order.size()) {
+    auto directory_page_id = rids[order[group_start]].GetPageId();
+    auto group_end = group_start;
+    while (group_end < order.size() && rids[order[group_end]].GetPageId() == directory_page_id) {
+      group_end++;
+    }
 
-      if (data_page->next_page_id_ == INVALID_PAGE_ID) {
-        throw Exception("The data page is not a linked list");
+    // Resolve all slots of the group within a single directory page fetch, the latch is held until the group is
+    // copied so that the slots can not be deleted in between
+    auto directory_page_guard = bpm->FetchPageRead(directory_page_id);
+    auto data_set_page = directory_page_guard.template As<DistributionDataSetPage>();
+    if (!data_set_page->IsDirectoryPage()) {
+      throw Exception("The input page is not a directory page");
+    }
+    auto directory_page = reinterpret_cast<const DistributionDataSetDirectoryPage *>(data_set_page);
+
+    data_page_requests.clear();
+    for (auto current = group_start; current < group_end; ++current) {
+      auto data_page_id = directory_page->IndexAt(static_cast<int>(rids[order[current]].GetSlotNum()));
+      if (data_page_id == INVALID_PAGE_ID) {
+        LOG_DEBUG("Invalid index page");
+        continue;
       }
+      data_page_requests.emplace_back(data_page_id, order[current]);
+    }
+
+    // Visit data pages in page id order, pages of one data are allocated contiguously
+    std::sort(data_page_requests.begin(), data_page_requests.end());
+    for (const auto &[data_page_id, row] : data_page_requests) {
+      auto row_data = distribution_data + row * this->dimension_;
+      VisitDataPages(bpm, data_page_id, &decoded, [&](const ValueType *chunk, int offset, int length) {
+        memcpy(row_data + offset, chunk, length * sizeof(ValueType));
+      });
+
+      if (is_found != nullptr) {
+        (*is_found)[row] = true;
+      }
+      found_size++;
+    }
+
+    group_start = group_end;
+  }
 
-      data_page_guard.Drop();
-      data_page_guard = bpm->FetchPageRead(data_page->next_page_id_);
-      data_page = data_page_guard.template As<DataPage>();
+  return found_size;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::Distance(bool is_training_set,
+                                                 page_id_t directory_page_id,
+                                                 int index,
+                                                 const ValueType *query,
+                                                 float p,
+                                                 float *distance) -> bool {
+  auto accumulation = 0.0F;
+
+  // Accumulate on the pinned data pages directly, no copy of the data is made
+  auto is_found = VisitDistributionData(is_training_set, directory_page_id, index,
+                                        [&](const ValueType *chunk, int offset, int length) {
+    const ValueType *query_chunk = query + offset;
+    if (p == 2.0F) {
+      for (int i = 0; i < length; ++i) {
+        auto difference = static_cast<float>(chunk[i] - query_chunk[i]);
+        accumulation += difference * difference;
+      }
+    } else if (p == 1.0F) {
+      for (int i = 0; i < length; ++i) {
+        accumulation += std::abs(static_cast<float>(chunk[i] - query_chunk[i]));
+      }
     } else {
-      memcpy(distribution_data.get() + current_size,
-             data_page->array_,
-             (this->dimension_ - current_size) * sizeof(ValueType));
-      current_size = this->dimension_;
+      for (int i = 0; i < length; ++i) {
+        accumulation += std::pow(std::abs(static_cast<float>(chunk[i] - query_chunk[i])), p);
+      }
     }
+  });
+
+  if (!is_found) {
+    return false;
   }
 
-  return distribution_data;
+  if (p == 2.0F) {
+    *distance = std::sqrt(accumulation);
+  } else if (p == 1.0F) {
+    *distance = accumulation;
+  } else {
+    *distance = std::pow(accumulation, 1.0F / p);
+  }
+
+  return true;
 }
 
 DISTRIBUTION_DATASET_TEMPLATE
@@ -581,6 +923,11 @@ auto DISTRIBUTION_DATASET_MANAGER_TYPE::Delete(bool is_training_set, page_id_t d
 
   // Delete data page located by the index
   auto data_page_id = directory_page->IndexAt(index);
+  if (data_page_id == INVALID_PAGE_ID) {
+    LOG_DEBUG("Invalid index page");
+    return false;
+  }
+
   auto data_page_guard = bpm->FetchPageWrite(data_page_id);
   data_ctx.write_set_.emplace_back(std::move(data_page_guard));
   auto data_page = data_ctx.write_set_.back().template AsMut<DataPage>();
@@ -602,9 +949,16 @@ auto DISTRIBUTION_DATASET_MANAGER_TYPE::Delete(bool is_training_set, page_id_t d
     LOG_DEBUG("Delete failed");
     return false;
   }
+  header_page->IncreaseSize(-1);
 
   // Compact the directory page if size is zero
   if (directory_page->GetSize() == 0) {
+    auto &directory_page_ids = is_training_set ? training_set_directory_page_ids_ : testing_set_directory_page_ids_;
+    auto directory_page_id_iterator = std::find(directory_page_ids.begin(), directory_page_ids.end(), directory_page_id);
+    if (directory_page_id_iterator != directory_page_ids.end()) {
+      directory_page_ids.erase(directory_page_id_iterator);
+    }
+
     // Locate the page before this page and maintain the list structure
     if (header_page->directory_start_page_id_ == directory_page_id) {
       header_page->directory_start_page_id_ = data_set_page->next_page_id_;
@@ -643,6 +997,7 @@ auto DISTRIBUTION_DATASET_MANAGER_TYPE::ToString() -> std::string {
       "├─────dimension: {}.\n"
       "├─────directory page max size {}.\n"
       "├─────data page max size {}.\n"
+      "├─────vector encoding: {}.\n"
       "├─────data set scale: training set scale {}, testing set scale {}.\n",
       fmt::format(fg(fmt::color::deep_pink) | fmt::emphasis::underline, std::to_string(training_set_file_id_)),
       fmt::format(fg(fmt::color::deep_pink) | fmt::emphasis::underline, std::to_string(testing_set_file_id_)),
@@ -655,6 +1010,7 @@ auto DISTRIBUTION_DATASET_MANAGER_TYPE::ToString() -> std::string {
       fmt::format(fg(fmt::color::medium_violet_red) | fmt::emphasis::bold, "{}", dimension_),
       fmt::format(fg(fmt::color::misty_rose) | fmt::emphasis::bold, "{}", directory_page_max_size_),
       fmt::format(fg(fmt::color::misty_rose) | fmt::emphasis::bold, "{}", data_page_max_size_),
+      fmt::format(fg(fmt::color::light_sky_blue) | fmt::emphasis::bold, "{}", VectorEncodingToString(vector_encoding_)),
       fmt::format(fg(fmt::color::orange_red) | fmt::emphasis::bold, "{}", GetSize(true)),
       fmt::format(fg(fmt::color::orange_red) | fmt::emphasis::bold, "{}", GetSize(false))
       );
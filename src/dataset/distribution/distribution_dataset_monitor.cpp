@@ -24,14 +24,18 @@ DISTRIBUTION_DATASET_MONITOR_TYPE::DistributionDataSetMonitor(
     std::string relation_directory_name,
     int k,
     int pool_size,
+    int shared_pool_size,
     int directory_page_max_size,
-    int data_page_max_size)
+    int data_page_max_size,
+    std::shared_ptr<BufferPool> buffer_pool)
     : raw_data_directory_name_(std::move(raw_data_directory_name)),
       training_set_directory_name_(std::move(training_set_directory_name)),
       testing_set_directory_name_(std::move(testing_set_directory_name)),
       relation_directory_name_(std::move(relation_directory_name)),
       k_(k),
       pool_size_(pool_size),
+      buffer_pool_(buffer_pool != nullptr ? std::move(buffer_pool)
+                   : shared_pool_size > 0 ? std::make_shared<BufferPool>(shared_pool_size, k) : nullptr),
       directory_page_max_size_(directory_page_max_size),
       data_page_max_size_(data_page_max_size) {
   // Indicators progress bar presentation
@@ -83,7 +87,7 @@ DISTRIBUTION_DATASET_MONITOR_TYPE::DistributionDataSetMonitor(
         if (std::string_view{FileFullExTension(entry.path().filename())} == DATASET_FILE_SUFFIX) {
           auto disk_manager = std::make_shared<DiskManager>(entry.path().string());
           auto next_page_id = GetNextPageId(disk_manager.get(), entry.path().string());
-          auto bpm = std::make_shared<BufferPoolManager>(pool_size_, disk_manager, k_, nullptr, next_page_id);
+          auto bpm = CreateBufferPoolManager(buffer_pool_, pool_size_, k_, disk_manager, next_page_id);
           training_set_bpms_.insert({static_cast<file_id_t >(std::stoull(entry.path().filename())), bpm});
 
           training_process.tick();
@@ -110,7 +114,7 @@ DISTRIBUTION_DATASET_MONITOR_TYPE::DistributionDataSetMonitor(
         if (std::string_view{FileFullExTension(entry.path().filename())} == DATASET_FILE_SUFFIX) {
           auto disk_manager = std::make_shared<DiskManager>(entry.path().string());
           auto next_page_id = GetNextPageId(disk_manager.get(), entry.path().string());
-          auto bpm = std::make_shared<BufferPoolManager>(pool_size_, disk_manager, k_, nullptr, next_page_id);
+          auto bpm = CreateBufferPoolManager(buffer_pool_, pool_size_, k_, disk_manager, next_page_id);
           testing_set_bpms_.insert({static_cast<file_id_t >(std::stoull(entry.path().filename())), bpm});
 
           testing_process.tick();
@@ -138,7 +142,7 @@ DISTRIBUTION_DATASET_MONITOR_TYPE::DistributionDataSetMonitor(
         if (std::string_view{FileFullExTension(entry.path().filename())} == RELATION_FILE_SUFFIX) {
           auto disk_manager = std::make_shared<DiskManager>(entry.path().string());
           auto next_page_id = GetNextPageId(disk_manager.get(), entry.path().string());
-          auto bpm = std::make_shared<BufferPoolManager>(pool_size_, disk_manager, k_, nullptr, next_page_id);
+          auto bpm = CreateBufferPoolManager(buffer_pool_, pool_size_, k_, disk_manager, next_page_id);
           auto relation_manager = std::make_shared<RelationManager<TrainingSetToTestingSetUnion>>("relation manager",
                                                                                                   relation_directory_name_,
                                                                                                   bpm,
@@ -260,11 +264,7 @@ auto DISTRIBUTION_DATASET_MONITOR_TYPE::GenerateDataSet(distribution_lsh::DataSe
   auto training_set_next_page_id = GetNextPageId(training_set_disk_manager.get(),
                                                  training_set_directory_name_ + "/" + std::to_string(training_set_file_id)
                                                  + DATASET_FILE_SUFFIX);
-  auto training_set_bpm = std::make_shared<BufferPoolManager>(pool_size_,
-                                                              training_set_disk_manager,
-                                                              k_,
-                                                              nullptr,
-                                                              training_set_next_page_id);
+  auto training_set_bpm = CreateBufferPoolManager(buffer_pool_, pool_size_, k_, training_set_disk_manager, training_set_next_page_id);
   training_set_bpms_.insert({training_set_file_id, training_set_bpm});
 
   auto testing_set_file_id =
@@ -275,7 +275,7 @@ auto DISTRIBUTION_DATASET_MONITOR_TYPE::GenerateDataSet(distribution_lsh::DataSe
                                                 testing_set_directory_name_ + "/" + std::to_string(testing_set_file_id)
                                                 + DATASET_FILE_SUFFIX);
   auto testing_set_bpm =
-      std::make_shared<BufferPoolManager>(pool_size_, testing_set_manager, k_, nullptr, testing_set_next_page_id);
+      CreateBufferPoolManager(buffer_pool_, pool_size_, k_, testing_set_manager, testing_set_next_page_id);
   testing_set_bpms_.insert({testing_set_file_id, testing_set_bpm});
 
   auto ddp = std::make_unique<DistributionDatasetProcessor<ValueType>>();
@@ -312,7 +312,7 @@ auto DISTRIBUTION_DATASET_MONITOR_TYPE::GenerateDataSet(distribution_lsh::DataSe
     auto relation_disk_manager = std::make_shared<DiskManager>(
         relation_directory_name_ + "/" + std::to_string(relation_file_id) + RELATION_FILE_SUFFIX);
     auto relation_next_page_id = GetNextPageId(relation_disk_manager.get(), relation_directory_name_ + "/" + std::to_string(relation_file_id) + RELATION_FILE_SUFFIX);
-    auto relation_bpm = std::make_shared<BufferPoolManager>(pool_size_, relation_disk_manager, k_, nullptr, relation_next_page_id);
+    auto relation_bpm = CreateBufferPoolManager(buffer_pool_, pool_size_, k_, relation_disk_manager, relation_next_page_id);
     auto relation_manager = std::make_shared<RelationManager<TrainingSetToTestingSetUnion>>("relation manager-" + std::to_string(relation_file_id) ,
                                                                            relation_directory_name_,
                                                                            relation_bpm,
@@ -399,6 +399,55 @@ auto DISTRIBUTION_DATASET_MONITOR_TYPE::GetDistributionData(int manager_index, b
   return dataset_managers_[manager_index].get()->GetDistributionData(is_training_set, directory_page_id, index);
 }
 
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MONITOR_TYPE::GetDistributionDataAsync(int manager_index,
+                                                                 bool is_training_set,
+                                                                 page_id_t directory_page_id,
+                                                                 int index) -> Task<std::shared_ptr<ValueType[]>> {
+  // The latch is not held across the page fetches, the coroutine may resume on another thread
+  DistributionDataSetManager<ValueType> *dataset_manager{nullptr};
+  {
+    std::unique_lock<std::mutex> lock(latch_);
+    auto iterator = dataset_managers_.find(manager_index);
+    if (iterator == dataset_managers_.end()) {
+      co_return nullptr;
+    }
+    dataset_manager = iterator->second.get();
+  }
+
+  co_return co_await dataset_manager->GetDistributionDataAsync(is_training_set, directory_page_id, index);
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MONITOR_TYPE::GetDistributionDataBatch(int manager_index,
+                                                                 bool is_training_set,
+                                                                 std::span<const RID> rids,
+                                                                 ValueType *distribution_data,
+                                                                 std::vector<bool> *is_found) -> int {
+  std::unique_lock<std::mutex> lock(latch_);
+  if (dataset_managers_.find(manager_index) == dataset_managers_.end()) {
+    return -1;
+  }
+
+  return dataset_managers_[manager_index].get()->GetDistributionDataBatch(is_training_set, rids, distribution_data, is_found);
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_MONITOR_TYPE::Distance(int manager_index,
+                                                 bool is_training_set,
+                                                 page_id_t directory_page_id,
+                                                 int index,
+                                                 const ValueType *query,
+                                                 float p,
+                                                 float *distance) -> bool {
+  std::unique_lock<std::mutex> lock(latch_);
+  if (dataset_managers_.find(manager_index) == dataset_managers_.end()) {
+    return false;
+  }
+
+  return dataset_managers_[manager_index].get()->Distance(is_training_set, directory_page_id, index, query, p, distance);
+}
+
 DISTRIBUTION_DATASET_TEMPLATE
 auto DISTRIBUTION_DATASET_MONITOR_TYPE::DeleteDistributionData(int manager_index,
                                                                bool is_training_set,
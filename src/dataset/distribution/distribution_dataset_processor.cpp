@@ -5,14 +5,83 @@
 //
 //===-----------------------------------------------------
 
+#include <algorithm>
+#include <bit>
 #include <cmath>
-#include <fstream>
-#include <sstream>
+#include <numbers>
 
+#include <common/work_stealing_pool.h>
 #include <dataset/distribution/distribution_dataset_processor.h>
+#include <random/philox.h>
 
 namespace distribution_lsh {
 
+namespace {
+
+/**
+ * exp(x) by range reduction x = n * ln2 + r and a degree 6 polynomial of r (Cephes expf), accurate to a few ulp.
+ * It is branch-free, so loops calling it are vectorized by omp simd unlike std::exp.
+ */
+#pragma omp declare simd notinbranch
+inline auto VectorizableExp(float x) -> float {
+  x = std::clamp(x, -87.3F, 88.7F);
+  auto n = std::floor(x * std::numbers::log2e_v<float> + 0.5F);
+  auto r = x - n * 0.693359375F + n * 2.12194440E-4F;
+
+  auto polynomial = 1.9875691500E-4F;
+  polynomial = polynomial * r + 1.3981999507E-3F;
+  polynomial = polynomial * r + 8.3334519073E-3F;
+  polynomial = polynomial * r + 4.1665795894E-2F;
+  polynomial = polynomial * r + 1.6666665459E-1F;
+  polynomial = polynomial * r + 5.0000001201E-1F;
+  polynomial = polynomial * r * r + r + 1.0F;
+
+  // Scale by 2^n through the exponent bits
+  return polynomial * std::bit_cast<float>((static_cast<int32_t>(n) + 127) << 23);
+}
+
+/** Softmax of a row, the max is subtracted first so that exp never overflows */
+void SoftmaxKernel(float *row, int dimension) {
+  auto max_value = row[0];
+#pragma omp simd reduction(max : max_value)
+  for (int j = 0; j < dimension; j++) {
+    max_value = std::max(max_value, row[j]);
+  }
+
+  auto sum = 0.0F;
+#pragma omp simd reduction(+ : sum)
+  for (int j = 0; j < dimension; j++) {
+    row[j] = VectorizableExp(row[j] - max_value);
+    sum += row[j];
+  }
+
+  auto inverse_sum = 1.0F / sum;
+#pragma omp simd
+  for (int j = 0; j < dimension; j++) {
+    row[j] *= inverse_sum;
+  }
+}
+
+/** Shift a row to be non-negative if it has negative values, then scale it to sum up to 1 */
+void MinMaxKernel(float *row, int dimension) {
+  auto min_value = 0.0F;
+  auto sum = 0.0;
+#pragma omp simd reduction(min : min_value) reduction(+ : sum)
+  for (int j = 0; j < dimension; j++) {
+    min_value = std::min(min_value, row[j]);
+    sum += row[j];
+  }
+
+  auto shift = std::abs(min_value);
+  auto total = static_cast<float>(sum) + shift * static_cast<float>(dimension);
+#pragma omp simd
+  for (int j = 0; j < dimension; j++) {
+    row[j] = (row[j] + shift) / total;
+  }
+}
+
+} // namespace
+
 DISTRIBUTION_DATASET_TEMPLATE
 auto DISTRIBUTION_DATASET_PROCESSOR_TYPE::GenerationDistributionDataset(int dimension,
                                                                  int size,
@@ -21,85 +90,91 @@ auto DISTRIBUTION_DATASET_PROCESSOR_TYPE::GenerationDistributionDataset(int dime
                                                                  float *param) -> std::unique_ptr<ValueType[]>  {
   std::unique_ptr<ValueType[]> distribution_dataset(new ValueType[size * dimension]);
   std::random_device rd;
-  std::mt19937 gen(rd());
+  auto seed = static_cast<uint64_t>(rd()) << 32 | rd();
 
-
-  // Generate raw data
-  // Uniform distribution
-  if (distribution_type == DistributionType::UNIFORM) {
-    std::uniform_real_distribution<> dis(param[0], param[1]);
-    for (int i = 0; i < size; i++) {
-      for (int j = 0; j < dimension; j++) {
-        distribution_dataset[i * dimension + j] = static_cast<ValueType>(dis(gen));
-      }
-    }
-  }
-    // Gaussian distribution
-  else if (distribution_type == DistributionType::GAUSSIAN) {
-    std::normal_distribution<> dis(param[0], param[1]);
-    for (int i = 0; i < size; i++) {
-      for (int j = 0; j < dimension; j++) {
-        distribution_dataset[i * dimension + j] = static_cast<ValueType>(dis(gen));
-      }
-    }
-  }
-    // Cauchy distribution
-  else if (distribution_type == DistributionType::CAUCHY) {
-    std::cauchy_distribution<> dis(param[0], param[1]);
-    for (int i = 0; i < size; i++) {
-      for (int j = 0; j < dimension; j++) {
-        distribution_dataset[i * dimension + j] = static_cast<ValueType>(dis(gen));
-      }
-    }
-  } else {
-    throw Exception("Distribution type not supported");
-  }
-
-  // Normalization phase
-  Normalize(distribution_dataset.get(), size, dimension, normalization_type);
+  GenerationDistributionDataset(distribution_dataset.get(), dimension, 0, size, distribution_type, normalization_type,
+                                param, seed);
 
   return distribution_dataset;
 }
 
-
 DISTRIBUTION_DATASET_TEMPLATE
-auto DISTRIBUTION_DATASET_PROCESSOR_TYPE::MNISTDistributionDataset(int size,
-                                                            const std::string& directory_name_,
-                                                            distribution_lsh::NormalizationType normalization_type) -> std::unique_ptr<ValueType[]> {
-  std::unique_ptr<ValueType[]> distribution_dataset(new ValueType[size * 784]); // MNIST dataset is 28x28, so dimension is 784
-
-  // Open target file
-  std::string directory_name = directory_name_ + "/mnist_train.csv";
-  std::ifstream ifs(directory_name, std::ios::in);
-  if (!ifs.is_open()) {
-    throw Exception("Cannot open file");
+void DISTRIBUTION_DATASET_PROCESSOR_TYPE::GenerationDistributionDataset(ValueType *distribution_dataset,
+                                                                        int dimension,
+                                                                        int64_t start_row,
+                                                                        int size,
+                                                                        DistributionType distribution_type,
+                                                                        NormalizationType normalization_type,
+                                                                        const float *param,
+                                                                        uint64_t seed,
+                                                                        WorkStealingPool *pool) {
+  // Check the types before entering the parallel region
+  if (distribution_type != DistributionType::UNIFORM && distribution_type != DistributionType::GAUSSIAN
+      && distribution_type != DistributionType::CAUCHY) {
+    throw Exception("Distribution type not supported");
+  }
+  if (normalization_type != NormalizationType::SOFTMAX && normalization_type != NormalizationType::MIN_MAX) {
+    throw Exception("Normalization type not supported");
   }
 
-  // Read data from file
-  std::string line;
-  auto current_row = -1;
-  while (std::getline(ifs, line) && current_row < size) {
-    std::stringstream ss(line);
-    std::string cell;
-
-    auto current_col = 1;
-    while (std::getline(ss, cell, ',') && current_row != -1) {
-      if (current_col > 784) {
-        continue;
+  Philox4x32 philox(seed);
+  auto location = param[0];
+  auto scale = distribution_type == DistributionType::UNIFORM ? param[1] - param[0] : param[1];
+
+  auto grain_size = static_cast<int>(std::max<int64_t>(PARALLEL_GRAIN_SIZE / dimension, 1));
+  ParallelFor(pool, 0, size, grain_size, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      auto row = distribution_dataset + static_cast<int64_t>(i) * dimension;
+      auto first_element = (start_row + i) * dimension;
+
+      // Generate raw data, each random block covers four consecutive elements of the data set
+      for (int j = 0; j < dimension;) {
+        auto element = first_element + j;
+        auto block = philox(static_cast<uint64_t>(element / 4));
+        float values[4];
+        switch (distribution_type) {
+          // Uniform distribution
+          case DistributionType::UNIFORM: {
+            for (int lane = 0; lane < 4; ++lane) {
+              values[lane] = Philox4x32::ToUniform(block[lane]);
+            }
+            break;
+          }
+          // Gaussian distribution
+          case DistributionType::GAUSSIAN: {
+            Philox4x32::ToGaussian(block[0], block[1], &values[0], &values[1]);
+            Philox4x32::ToGaussian(block[2], block[3], &values[2], &values[3]);
+            break;
+          }
+          // Cauchy distribution
+          default: {
+            for (int lane = 0; lane < 4; ++lane) {
+              values[lane] = Philox4x32::ToCauchy(block[lane]);
+            }
+            break;
+          }
+        }
+
+        for (auto lane = static_cast<int>(element % 4); lane < 4 && j < dimension; ++lane, ++j) {
+          row[j] = static_cast<ValueType>(location + scale * values[lane]);
+        }
       }
 
-      distribution_dataset[current_row * 784 + current_col - 1] = static_cast<ValueType>(std::stod(cell));
-      current_col++;
+      // Normalization phase
+      Normalize(row, 1, dimension, normalization_type);
     }
+  });
+}
 
-    current_row ++;
-  }
 
-  // Normalization phase
-  Normalize(distribution_dataset.get(), size, 784, normalization_type);
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_PROCESSOR_TYPE::MNISTDistributionDataset(int size,
+                                                            const std::string& directory_name_,
+                                                            distribution_lsh::NormalizationType normalization_type) -> std::unique_ptr<ValueType[]> {
+  std::unique_ptr<ValueType[]> distribution_dataset(new ValueType[size * MNIST_DIMENSION]); // MNIST dataset is 28x28, so dimension is 784
 
-  // Close file
-  ifs.close();
+  auto reader = OpenRawDataSetReader<ValueType>(DataSetType::MNIST, directory_name_, true);
+  ReadDistributionDataset(reader.get(), distribution_dataset.get(), size, normalization_type);
 
   return distribution_dataset;
 }
@@ -108,57 +183,49 @@ DISTRIBUTION_DATASET_TEMPLATE
 auto DISTRIBUTION_DATASET_PROCESSOR_TYPE::CIFAR10DistributionDataset(int size,
                                                               std::string directory_name_,
                                                               distribution_lsh::NormalizationType normalization_type) -> std::unique_ptr<ValueType[]> {
-  std::unique_ptr<ValueType[]> distribution_dataset(new ValueType[size * 32 * 32 * 3]); // CIFAR dataset dimension is 32*32*3
+  std::unique_ptr<ValueType[]> distribution_dataset(new ValueType[size * CIFAR10_DIMENSION]); // CIFAR dataset dimension is 32*32*3
 
+  auto reader = OpenRawDataSetReader<ValueType>(DataSetType::CIFAR10, directory_name_, true);
+  ReadDistributionDataset(reader.get(), distribution_dataset.get(), size, normalization_type);
 
   return distribution_dataset;
 }
 
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_PROCESSOR_TYPE::ReadDistributionDataset(RawDataSetReader<ValueType> *reader,
+                                                           ValueType *distribution_dataset,
+                                                           int size,
+                                                           NormalizationType normalization_type) -> int {
+  auto rows = reader->Read(distribution_dataset, size);
+
+  // Normalization phase
+  Normalize(distribution_dataset, rows, reader->GetDimension(), normalization_type);
+
+  return rows;
+}
+
 DISTRIBUTION_DATASET_TEMPLATE
 void DISTRIBUTION_DATASET_PROCESSOR_TYPE::Normalize(float *distribution_dataset,
                                              int size,
                                              int dimension,
                                              distribution_lsh::NormalizationType normalization_type) {
   // Normalize raw data into [0, 1]
-  // Softmax normalization
-  // Determine the appropriate SIMD instruction set
-  if (normalization_type == NormalizationType::SOFTMAX) {
-    for (int i = 0; i < size; i++) {
-      // TODO : Use SIMD to accelerate this part
-      for (int j = 0; j < dimension; j++) {
-        distribution_dataset[i * dimension + j] = std::exp(distribution_dataset[i * dimension + j]);
-      }
-      auto sum = static_cast<ValueType>(std::accumulate(distribution_dataset + i * dimension,
-                                                    distribution_dataset + (i + 1) * dimension,
-                                                    0.0));
-      for (int j = 0; j < dimension; j++) {
-        distribution_dataset[i * dimension + j] /= sum;
-      }
-    }
+  if (normalization_type != NormalizationType::SOFTMAX && normalization_type != NormalizationType::MIN_MAX) {
+    throw Exception("Normalization type not supported");
   }
-    // Min-max normalization
-  else if (normalization_type == NormalizationType::MIN_MAX) {
-    for (int i = 0; i < size; i++) {
-      // TODO : Use SIMD to accelerate this part
-      auto min_value = 0.0F;
-      for (int j = 0; j < dimension; j++) {
-        if (distribution_dataset[i * dimension + j] < min_value) {
-          min_value = distribution_dataset[i * dimension + j];
-        }
-      }
-      auto sum = static_cast<ValueType>(std::accumulate(distribution_dataset + i * dimension,
-                                                    distribution_dataset + (i + 1) * dimension,
-                                                    0.0));
-      sum += static_cast<ValueType>(std::abs(min_value)) * static_cast<ValueType>(dimension);
-      for (int j = 0; j < dimension; j++) {
-        distribution_dataset[i * dimension + j] = (distribution_dataset[i * dimension + j] + static_cast<ValueType>(std::abs(min_value))) / sum;
+
+  // Rows are independent, split them across threads and vectorize inside a row
+  auto grain_size = static_cast<int>(std::max<int64_t>(PARALLEL_GRAIN_SIZE / dimension, 1));
+  ParallelFor(&WorkStealingPool::GetInstance(), 0, size, grain_size, [&](int begin, int end) {
+    for (int i = begin; i < end; i++) {
+      auto row = distribution_dataset + static_cast<int64_t>(i) * dimension;
+      if (normalization_type == NormalizationType::SOFTMAX) {
+        SoftmaxKernel(row, dimension);
+      } else {
+        MinMaxKernel(row, dimension);
       }
     }
-  }
-    // Exception
-  else {
-    throw Exception("Normalization type not supported");
-  }
+  });
 }
 
 
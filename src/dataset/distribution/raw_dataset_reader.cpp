@@ -0,0 +1,226 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/10.
+// src/dataset/distribution/raw_dataset_reader.cpp
+//
+//===-----------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+
+#include <common/exception.h>
+#include <common/work_stealing_pool.h>
+#include <dataset/distribution/raw_dataset_reader.h>
+
+namespace distribution_lsh {
+
+namespace {
+
+/** Parse a cell of a csv line, pixels are integers so the float parser is only the fallback */
+DISTRIBUTION_DATASET_TEMPLATE
+auto ParseCsvCell(const char *&cursor, const char *end, ValueType *value) -> bool {
+  auto start = cursor;
+  uint32_t integer = 0;
+  while (cursor < end && *cursor >= '0' && *cursor <= '9') {
+    integer = integer * 10 + static_cast<uint32_t>(*cursor - '0');
+    ++cursor;
+  }
+
+  if (cursor != start && (cursor == end || *cursor == ',' || *cursor == '\r' || *cursor == '\n')) {
+    *value = static_cast<ValueType>(integer);
+  } else {
+    float floating = 0.0F;
+    auto [next, error] = std::from_chars(start, end, floating);
+    if (error != std::errc()) {
+      return false;
+    }
+    cursor = next;
+    *value = static_cast<ValueType>(floating);
+  }
+
+  if (cursor < end && *cursor == ',') {
+    ++cursor;
+  }
+  return true;
+}
+
+/** Parse a "label,pixel,...,pixel" line, the label is skipped */
+DISTRIBUTION_DATASET_TEMPLATE
+auto ParseMNISTCsvLine(const char *cursor, const char *end, ValueType *distribution_data) -> bool {
+  ValueType label;
+  if (!ParseCsvCell(cursor, end, &label)) {
+    return false;
+  }
+  for (int i = 0; i < MNIST_DIMENSION; ++i) {
+    if (!ParseCsvCell(cursor, end, &distribution_data[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+auto ReadBigEndian(const char *data) -> uint32_t {
+  auto bytes = reinterpret_cast<const unsigned char *>(data);
+  return (static_cast<uint32_t>(bytes[0]) << 24) | (static_cast<uint32_t>(bytes[1]) << 16) |
+      (static_cast<uint32_t>(bytes[2]) << 8) | static_cast<uint32_t>(bytes[3]);
+}
+
+} // namespace
+
+DISTRIBUTION_DATASET_TEMPLATE
+MNISTCsvReader<ValueType>::MNISTCsvReader(const std::string &file_name) : file_(file_name) {
+  // Skip the title line
+  auto line_end = static_cast<const char *>(memchr(file_.Data(), '\n', file_.Size()));
+  position_ = line_end == nullptr ? file_.Size() : static_cast<size_t>(line_end - file_.Data()) + 1;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto MNISTCsvReader<ValueType>::Read(ValueType *distribution_dataset, int size) -> int {
+  // Locate the lines of this chunk, the file is scanned once by memchr
+  std::vector<size_t> line_starts;
+  std::vector<size_t> line_ends;
+  while (static_cast<int>(line_starts.size()) < size && position_ < file_.Size()) {
+    auto line_end = static_cast<const char *>(memchr(file_.Data() + position_, '\n', file_.Size() - position_));
+    auto end = line_end == nullptr ? file_.Size() : static_cast<size_t>(line_end - file_.Data());
+    if (end > position_ && !(end == position_ + 1 && file_.Data()[position_] == '\r')) {
+      line_starts.emplace_back(position_);
+      line_ends.emplace_back(end);
+    }
+    position_ = end + 1;
+  }
+
+  // Parse lines in parallel
+  auto rows = static_cast<int>(line_starts.size());
+  std::atomic<bool> is_malformed{false};
+  ParallelFor(&WorkStealingPool::GetInstance(), 0, rows, static_cast<int>(PARALLEL_GRAIN_SIZE / MNIST_DIMENSION),
+              [&](int begin, int end) {
+    for (int row = begin; row < end; ++row) {
+      if (!ParseMNISTCsvLine(file_.Data() + line_starts[row],
+                             file_.Data() + line_ends[row],
+                             &distribution_dataset[static_cast<int64_t>(row) * MNIST_DIMENSION])) {
+        is_malformed.store(true, std::memory_order_relaxed);
+      }
+    }
+  });
+
+  if (is_malformed.load()) {
+    throw Exception("Malformed MNIST csv line");
+  }
+  return rows;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+MNISTIdxReader<ValueType>::MNISTIdxReader(const std::string &file_name) : file_(file_name) {
+  // magic number 0x00000803 (unsigned byte, 3 dimensions), number of images, rows, columns
+  if (file_.Size() < 16 || ReadBigEndian(file_.Data()) != 0x0000'0803U) {
+    throw Exception("Invalid MNIST idx3 file");
+  }
+
+  size_ = static_cast<int>(ReadBigEndian(file_.Data() + 4));
+  if (ReadBigEndian(file_.Data() + 8) * ReadBigEndian(file_.Data() + 12) != MNIST_DIMENSION
+      || file_.Size() < 16 + static_cast<size_t>(size_) * MNIST_DIMENSION) {
+    throw Exception("Invalid MNIST idx3 file");
+  }
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto MNISTIdxReader<ValueType>::Read(ValueType *distribution_dataset, int size) -> int {
+  auto rows = std::min(size, size_ - current_row_);
+  auto pixels = reinterpret_cast<const unsigned char *>(file_.Data() + 16) + static_cast<int64_t>(current_row_) * MNIST_DIMENSION;
+  auto length = static_cast<int64_t>(rows) * MNIST_DIMENSION;
+
+  ParallelFor(&WorkStealingPool::GetInstance(), int64_t{0}, length, PARALLEL_GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+#pragma omp simd
+    for (int64_t i = begin; i < end; ++i) {
+      distribution_dataset[i] = static_cast<ValueType>(pixels[i]);
+    }
+  });
+
+  current_row_ += rows;
+  return rows;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+CIFAR10BinaryReader<ValueType>::CIFAR10BinaryReader(std::vector<std::string> batch_file_names)
+    : batch_file_names_(std::move(batch_file_names)) {}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto CIFAR10BinaryReader<ValueType>::Read(ValueType *distribution_dataset, int size) -> int {
+  static constexpr size_t RECORD_SIZE = 1 + CIFAR10_DIMENSION;
+
+  auto rows = 0;
+  while (rows < size) {
+    // Open the next batch once the current one is exhausted
+    if (position_ + RECORD_SIZE > file_.Size()) {
+      if (next_batch_ == batch_file_names_.size()) {
+        break;
+      }
+      file_ = MappedFile(batch_file_names_[next_batch_++]);
+      if (file_.Size() % RECORD_SIZE != 0) {
+        throw Exception("Invalid CIFAR-10 batch file");
+      }
+      position_ = 0;
+      continue;
+    }
+
+    auto batch_rows = std::min(static_cast<size_t>(size - rows), (file_.Size() - position_) / RECORD_SIZE);
+    auto records = reinterpret_cast<const unsigned char *>(file_.Data() + position_);
+    auto output = &distribution_dataset[static_cast<int64_t>(rows) * CIFAR10_DIMENSION];
+
+    ParallelFor(&WorkStealingPool::GetInstance(), size_t{0}, batch_rows,
+                static_cast<size_t>(PARALLEL_GRAIN_SIZE / CIFAR10_DIMENSION), [&](size_t begin, size_t end) {
+      for (size_t row = begin; row < end; ++row) {
+        // Skip the label byte of the record
+        auto pixels = records + row * RECORD_SIZE + 1;
+        for (int i = 0; i < CIFAR10_DIMENSION; ++i) {
+          output[row * CIFAR10_DIMENSION + i] = static_cast<ValueType>(pixels[i]);
+        }
+      }
+    });
+
+    position_ += batch_rows * RECORD_SIZE;
+    rows += static_cast<int>(batch_rows);
+  }
+
+  return rows;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto OpenRawDataSetReader(DataSetType data_set_type,
+                          const std::string &directory_name,
+                          bool is_training_set) -> std::unique_ptr<RawDataSetReader<ValueType>> {
+  switch (data_set_type) {
+    case DataSetType::MNIST: {
+      auto idx_file_name = directory_name + (is_training_set ? "/train-images-idx3-ubyte" : "/t10k-images-idx3-ubyte");
+      if (std::filesystem::exists(idx_file_name)) {
+        return std::make_unique<MNISTIdxReader<ValueType>>(idx_file_name);
+      }
+      return std::make_unique<MNISTCsvReader<ValueType>>(
+          directory_name + (is_training_set ? "/mnist_train.csv" : "/mnist_test.csv"));
+    }
+    case DataSetType::CIFAR10: {
+      std::vector<std::string> batch_file_names;
+      if (is_training_set) {
+        for (int batch = 1; batch <= 5; ++batch) {
+          batch_file_names.emplace_back(directory_name + "/data_batch_" + std::to_string(batch) + ".bin");
+        }
+      } else {
+        batch_file_names.emplace_back(directory_name + "/test_batch.bin");
+      }
+      return std::make_unique<CIFAR10BinaryReader<ValueType>>(std::move(batch_file_names));
+    }
+    case DataSetType::INVALID_DATA_SET_TYPE:
+    case DataSetType::GENERATION:
+    default: throw Exception("Not a raw data set type");
+  }
+}
+
+template class MNISTCsvReader<float>;
+template class MNISTIdxReader<float>;
+template class CIFAR10BinaryReader<float>;
+template auto OpenRawDataSetReader<float>(DataSetType, const std::string &, bool) -> std::unique_ptr<RawDataSetReader<float>>;
+
+} // namespace distribution_lsh
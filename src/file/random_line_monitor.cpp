@@ -5,6 +5,8 @@
 //
 //===-----------------------------------------------------
 
+#include <cmath>
+#include <set>
 #include <string_view>
 
 #include <fmt/format.h>
@@ -22,15 +24,19 @@ RANDOM_LINE_MONITOR_TYPE::RandomLineMonitor(
     std::string relation_directory_name,
     int k,
     int pool_size,
+    int shared_pool_size,
     int b_plus_tree_internal_max_size,
     int b_plus_tree_leaf_max_size,
     int random_line_directory_page_max_size,
-    int random_line_data_page_max_size)
+    int random_line_data_page_max_size,
+    std::shared_ptr<BufferPool> buffer_pool)
     : b_plus_tree_directory_name_(std::move(b_plus_tree_directory_name)),
       random_line_directory_name_(std::move(random_line_directory_name)),
       relation_directory_name_(std::move(relation_directory_name)),
       k_(k),
       pool_size_(pool_size),
+      buffer_pool_(buffer_pool != nullptr ? std::move(buffer_pool)
+                   : shared_pool_size > 0 ? std::make_shared<BufferPool>(shared_pool_size, k) : nullptr),
       b_plus_tree_internal_max_size_(b_plus_tree_internal_max_size),
       b_plus_tree_leaf_max_size_(b_plus_tree_leaf_max_size),
       random_line_directory_page_max_size_(random_line_directory_page_max_size),
@@ -84,7 +90,7 @@ RANDOM_LINE_MONITOR_TYPE::RandomLineMonitor(
         if (std::string_view{FileFullExTension(entry.path().filename())} == RANDOM_LINE_FILE_SUFFIX) {
           auto disk_manager = std::make_shared<DiskManager>(entry.path().string());
           auto next_page_id = GetNextPageId(disk_manager.get(), entry.path().string());
-          auto bpm = std::make_shared<BufferPoolManager>(pool_size_, disk_manager, k_, nullptr, next_page_id);
+          auto bpm = CreateBufferPoolManager(buffer_pool_, pool_size_, k_, disk_manager, next_page_id);
           random_line_bpms_.insert({static_cast<file_id_t >(std::stoull(entry.path().filename())), bpm});
 
           random_lines_process.tick();
@@ -108,15 +114,18 @@ RANDOM_LINE_MONITOR_TYPE::RandomLineMonitor(
       std::distance(std::filesystem::recursive_directory_iterator{std::filesystem::path{b_plus_tree_directory_name_}},
                     std::filesystem::recursive_directory_iterator{});
   std::atomic<int> b_plus_trees_index = 0;
+  // B+ tree files are opened after the relation records tell which ones the packed indexes hold
+  std::set<file_id_t> b_plus_tree_file_ids;
 
   std::ranges::for_each(
       std::filesystem::directory_iterator{std::filesystem::path{b_plus_tree_directory_name_}},
       [&](const auto &entry) {
         if (std::string_view{FileFullExTension(entry.path().filename())} == B_PLUS_TREE_FILE_SUFFIX) {
-          auto disk_manager = std::make_shared<DiskManager>(entry.path().string());
-          auto next_page_id = GetNextPageId(disk_manager.get(), entry.path().string());
-          auto bpm = std::make_shared<BufferPoolManager>(pool_size_, disk_manager, k_, nullptr, next_page_id);
-          b_plus_tree_bpms_.insert({static_cast<file_id_t >(std::stoull(entry.path().filename())), bpm});
+          b_plus_tree_file_ids.insert(static_cast<file_id_t >(std::stoull(entry.path().filename())));
+        } else if (std::string_view{FileFullExTension(entry.path().filename())} == PACKED_INDEX_FILE_SUFFIX) {
+          // Packed index files are named after the random line file of their group
+          packed_indexes_.insert({static_cast<file_id_t >(std::stoull(entry.path().filename())),
+                                  std::make_shared<PackedProjectionIndex<RandomLineValueType>>(entry.path().string())});
         }
 
         b_plus_tree_process.tick();
@@ -146,7 +155,7 @@ RANDOM_LINE_MONITOR_TYPE::RandomLineMonitor(
         if (std::string_view{FileFullExTension(entry.path().filename())} == RELATION_FILE_SUFFIX) {
           auto disk_manager = std::make_shared<DiskManager>(entry.path().string());
           auto next_page_id = GetNextPageId(disk_manager.get(), entry.path().string());
-          auto bpm = std::make_shared<BufferPoolManager>(pool_size_, disk_manager, k_, nullptr, next_page_id);
+          auto bpm = CreateBufferPoolManager(buffer_pool_, pool_size_, k_, disk_manager, next_page_id);
           auto relation_manager = std::make_shared<RelationManager<RandomLineFileToBPlusTreeFileUnion>>(
               "relation manager",
               relation_directory_name_,
@@ -191,7 +200,7 @@ RANDOM_LINE_MONITOR_TYPE::RandomLineMonitor(
 
         // According to the relation record to find specific random line and b plus tree
         if (random_line_bpms_.find(relation_record.map_.random_line_file_id_) == random_line_bpms_.end()
-            || b_plus_tree_bpms_.find(relation_record.map_.b_plus_tree_file_id_) == b_plus_tree_bpms_.end()) {
+            || !b_plus_tree_file_ids.contains(relation_record.map_.b_plus_tree_file_id_)) {
           fmt::println("Random line file/B plus tree file not found(random line file id {}, b plus tree file id {})",
                        relation_record.map_.random_line_file_id_,
                        relation_record.map_.b_plus_tree_file_id_);
@@ -203,6 +212,7 @@ RANDOM_LINE_MONITOR_TYPE::RandomLineMonitor(
                   + B_PLUS_TREE_FILE_SUFFIX}) ? fmt::print("B plus tree file {} has successfully deleted\n",
                                                            relation_record.map_.b_plus_tree_file_id_) : fmt::print(
               "B plus tree file not found\n");
+          std::filesystem::remove(GetProjectionColumnFileName(relation_record.map_.b_plus_tree_file_id_));
           current_index_++;
           continue;
         }
@@ -226,23 +236,24 @@ RANDOM_LINE_MONITOR_TYPE::RandomLineMonitor(
         random_line_managers_.insert({{relation_record.map_.data_set_file_id_,
                                        random_line_manager->GetDistributionType(),
                                        random_line_manager->GetNormalizationType(),
-                                       static_cast<int>(random_line_manager->GetEpsilon())},
+                                       random_line_manager->IsSeeded() ? SEEDED_RANDOM_LINE_GROUP_EPSILON
+                                                                       : static_cast<int>(random_line_manager->GetEpsilon())},
                                       random_line_manager});
 
 #ifdef BY_PASS_ACCESS_RANDOM_LINE_MANAGER
         by_pass_random_line_managers_.insert({relation_record.map_.random_line_file_id_, random_line_manager});
 #endif
-        // Constructing B Plus Tree, use random line file id concat its directory id and slot as identifier
-        b_plus_trees_[{relation_record.map_.random_line_file_id_, {relation_record.map_.random_line_directory_page_id_,
-                                                                   static_cast<uint32_t >(relation_record.map_.random_line_slot_)}}] =
-            std::make_shared<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>>(
-                std::to_string(relation_record.map_.random_line_file_id_) + "-"
-                    + std::to_string(relation_record.map_.random_line_directory_page_id_) + "-"
-                    + std::to_string(relation_record.map_.random_line_slot_),
-                HEADER_PAGE_ID,
-                b_plus_tree_bpms_[relation_record.map_.b_plus_tree_file_id_],
-                b_plus_tree_leaf_max_size_,
-                b_plus_tree_internal_max_size_);
+        // Constructing B Plus Tree, unless the packed index of the group holds the line and serves it instead
+        RID random_line_rid{relation_record.map_.random_line_directory_page_id_,
+                            static_cast<uint32_t >(relation_record.map_.random_line_slot_)};
+        auto packed_index = packed_indexes_.find(relation_record.map_.random_line_file_id_);
+        b_plus_tree_file_ids_[{relation_record.map_.random_line_file_id_, random_line_rid}] =
+            relation_record.map_.b_plus_tree_file_id_;
+        if (packed_index == packed_indexes_.end() || packed_index->second->GetSize(random_line_rid) < 0) {
+          OpenBPlusTree(relation_record.map_.random_line_file_id_,
+                        random_line_rid,
+                        relation_record.map_.b_plus_tree_file_id_);
+        }
 
         current_index_++;
       } catch (Exception &exception) {
@@ -256,7 +267,7 @@ RANDOM_LINE_MONITOR_TYPE::RandomLineMonitor(
     auto relation_file_id = GenerateFileIdentification(relation_directory_name_, FileType::RELATION_FILE);
     auto relation_disk_manager = std::make_shared<DiskManager>(
         relation_directory_name_ + "/" + std::to_string(relation_file_id) + RELATION_FILE_SUFFIX);
-    auto relation_bpm = std::make_shared<BufferPoolManager>(pool_size_, relation_disk_manager, k_, nullptr);
+    auto relation_bpm = CreateBufferPoolManager(buffer_pool_, pool_size_, k_, relation_disk_manager);
     auto relation_manager = std::make_shared<RelationManager<RandomLineFileToBPlusTreeFileUnion>>(
         "relation manager-" + std::to_string(relation_file_id),
         relation_directory_name_,
@@ -276,14 +287,17 @@ auto RANDOM_LINE_MONITOR_TYPE::RandomProjection(
     RandomLineNormalizationType normalization_type,
     float epsilon,
     int random_line_size,
-    file_id_t training_set_file_id) -> std::shared_ptr<std::vector<std::vector<std::pair<file_id_t, RID>>>> {
+    file_id_t training_set_file_id,
+    std::optional<uint64_t> seed) -> std::shared_ptr<std::vector<std::vector<std::pair<file_id_t, RID>>>> {
+  // A seed-defined group keeps no average, so it is told apart by its epsilon key
+  auto group_epsilon = seed.has_value() ? SEEDED_RANDOM_LINE_GROUP_EPSILON : static_cast<int>(epsilon);
   // If the random line manager not exists
   {
     std::scoped_lock<std::mutex> lock(latch_);
     if (random_line_managers_.find(std::tuple(training_set_file_id,
                                               distribution_type,
                                               normalization_type,
-                                              static_cast<int>(epsilon))) == random_line_managers_.end()) {
+                                              group_epsilon)) == random_line_managers_.end()) {
       // Prepare buffer pool manager
       auto random_line_file_id = GenerateFileIdentification(random_line_directory_name_, FileType::RANDOM_LINE_FILE);
       auto random_line_disk_manager = std::make_shared<DiskManager>(
@@ -292,11 +306,7 @@ auto RANDOM_LINE_MONITOR_TYPE::RandomProjection(
                                                     random_line_directory_name_ + "/"
                                                         + std::to_string(random_line_file_id)
                                                         + RANDOM_LINE_FILE_SUFFIX);
-      auto random_line_bpm = std::make_shared<BufferPoolManager>(pool_size_,
-                                                                 random_line_disk_manager,
-                                                                 k_,
-                                                                 nullptr,
-                                                                 random_line_next_page_id);
+      auto random_line_bpm = CreateBufferPoolManager(buffer_pool_, pool_size_, k_, random_line_disk_manager, random_line_next_page_id);
       // Prepare random line generator
       auto rlg = std::make_shared<RandomLineGenerator<RandomLineValueType>>();
       random_line_bpms_.insert({random_line_file_id, random_line_bpm});
@@ -312,7 +322,7 @@ auto RANDOM_LINE_MONITOR_TYPE::RandomProjection(
           distribution_type,
           normalization_type,
           static_cast<int>(epsilon));
-      random_line_managers_.insert({{training_set_file_id, distribution_type, normalization_type, epsilon}, rlm});
+      random_line_managers_.insert({{training_set_file_id, distribution_type, normalization_type, group_epsilon}, rlm});
 #ifdef BY_PASS_ACCESS_RANDOM_LINE_MANAGER
       by_pass_random_line_managers_.insert({random_line_file_id, rlm});
 #endif
@@ -320,53 +330,49 @@ auto RANDOM_LINE_MONITOR_TYPE::RandomProjection(
   }
 
   auto random_line_manager =
-      random_line_managers_[{training_set_file_id, distribution_type, normalization_type, static_cast<int>(epsilon)}];
-  // Generate more random line for request
-  if (random_line_manager->GetSize() < random_line_size) {
+      random_line_managers_[{training_set_file_id, distribution_type, normalization_type, group_epsilon}];
+  // Generate more random line for request, a seed-defined group extends its own stream
+  if (seed.has_value() && random_line_manager->IsEmpty()) {
+    random_line_manager->GenerateSeededRandomLineGroup(random_line_size, seed.value());
+  } else if (random_line_manager->GetSize() < random_line_size) {
     random_line_manager->GenerateRandomLineGroup(random_line_size - random_line_manager->GetSize());
   }
 
+  // The packed index of the group would miss the data inserted below, so it is dropped for the B+ trees
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    if (packed_indexes_.erase(random_line_manager->GetFileId()) != 0) {
+      std::filesystem::remove(GetPackedIndexFileName(random_line_manager->GetFileId()));
+    }
+  }
+
   // Prepare result
   std::shared_ptr<std::vector<std::vector<std::pair<file_id_t, RID>>>> results =
       std::make_shared<std::vector<std::vector<std::pair<file_id_t, RID>>>>
       (data_rids->size(), std::vector<std::pair<file_id_t, RID>>(random_line_size));
   // Calculate the random projection value and insert it into the b plus tree
+  std::vector<RID> random_line_rids;
+  std::vector<RandomLineValueType> random_projection_values;
   for (size_t data_rid_index = 0; data_rid_index < data_rids->size(); ++data_rid_index) {
-    for (auto current_index = 0; current_index < random_line_size; current_index++) {
-      auto random_line_directory_page_id = INVALID_PAGE_ID;
-      auto random_line_slot = INVALID_SLOT;
-      auto random_projection_value =
-          random_line_manager->InnerProduct(current_index, &random_line_directory_page_id, &random_line_slot, {data, data.get() + data_rid_index * dimension});
-
+    // Project onto the whole group at once, so that the group can use its own projection kernel
+    random_line_rids.clear();
+    random_projection_values.clear();
+    random_line_manager->Project({data, data.get() + data_rid_index * dimension}, &random_line_rids, &random_projection_values);
+    for (auto current_index = 0; current_index < static_cast<int>(random_line_rids.size()) && current_index < random_line_size; current_index++) {
+      auto random_line_directory_page_id = random_line_rids[current_index].GetPageId();
+      auto random_line_slot = static_cast<int>(random_line_rids[current_index].GetSlotNum());
+      auto random_projection_value = random_projection_values[current_index];
+
+      std::shared_ptr<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>> b_plus_tree;
+      std::shared_ptr<ProjectionColumnWriter<RandomLineValueType>> projection_column;
       {
         std::scoped_lock<std::mutex> lock(latch_);
-        if (b_plus_trees_.find({random_line_manager->GetFileId(), RID(random_line_directory_page_id, random_line_slot)})
-            == b_plus_trees_.end()) {
+        RID random_line_rid{random_line_directory_page_id, static_cast<uint32_t>(random_line_slot)};
+        b_plus_tree = GetBPlusTree(random_line_manager->GetFileId(), random_line_rid);
+        if (b_plus_tree == nullptr) {
           auto b_plus_tree_file_id = GenerateFileIdentification(b_plus_tree_directory_name_, FileType::B_PLUS_TREE_FILE);
-          auto b_plus_tree_disk_manager = std::make_shared<DiskManager>(
-              b_plus_tree_directory_name_ + "/" + std::to_string(b_plus_tree_file_id)
-                  + B_PLUS_TREE_FILE_SUFFIX);
-          auto b_plus_tree_next_page_id = GetNextPageId(b_plus_tree_disk_manager.get(),
-                                                        b_plus_tree_directory_name_ + "/"
-                                                            + std::to_string(b_plus_tree_file_id)
-                                                            + B_PLUS_TREE_FILE_SUFFIX);
-          auto b_plus_tree_bpm = std::make_shared<BufferPoolManager>(
-              pool_size_,
-              b_plus_tree_disk_manager,
-              k_,
-              nullptr,
-              b_plus_tree_next_page_id);
-          b_plus_tree_bpms_.insert({b_plus_tree_file_id, b_plus_tree_bpm});
-          b_plus_trees_.insert({{random_line_manager->GetFileId(),
-                                 RID(random_line_directory_page_id, random_line_slot)},
-                                std::make_shared<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>>(
-                                    std::to_string(random_line_manager->GetFileId()) + "-"
-                                        + std::to_string(random_line_directory_page_id) + "-"
-                                        + std::to_string(random_line_slot),
-                                    HEADER_PAGE_ID,
-                                    b_plus_tree_bpms_[b_plus_tree_file_id],
-                                    b_plus_tree_leaf_max_size_,
-                                    b_plus_tree_internal_max_size_)});
+          b_plus_tree = OpenBPlusTree(random_line_manager->GetFileId(), random_line_rid, b_plus_tree_file_id);
+          b_plus_tree_file_ids_[{random_line_manager->GetFileId(), random_line_rid}] = b_plus_tree_file_id;
 
           // Insert into the relation page
           auto index{0};
@@ -374,10 +380,10 @@ auto RANDOM_LINE_MONITOR_TYPE::RandomProjection(
                                                             random_line_directory_page_id, random_line_slot,
                                                             b_plus_tree_file_id, training_set_file_id}}, &index);
         }
+        projection_column = GetProjectionColumnWriter(random_line_manager->GetFileId(), random_line_rid);
       }
 
-      auto b_plus_tree =
-          b_plus_trees_[{random_line_manager->GetFileId(), RID(random_line_directory_page_id, random_line_slot)}];
+      projection_column->Append(random_projection_value, data_rids->data()[data_rid_index]);
       b_plus_tree->Insert(std::move(random_projection_value), data_rids->data()[data_rid_index]);
       results->data()[data_rid_index][current_index] =
           {random_line_manager->GetFileId(), {random_line_directory_page_id, static_cast<uint32_t>(random_line_slot)}};
@@ -396,14 +402,186 @@ void RANDOM_LINE_MONITOR_TYPE::List() {
     auto random_line_rids = std::make_shared<std::vector<RID>>();
     rlm.second->GetSize(nullptr, random_line_rids);
     for (const auto &random_line_rid : *random_line_rids) {
-      auto b_plus_tree =
-          b_plus_trees_[{rlm.second->GetFileId(), random_line_rid}];
+      std::shared_ptr<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>> b_plus_tree;
+      {
+        std::scoped_lock<std::mutex> lock(latch_);
+        b_plus_tree = GetBPlusTree(rlm.second->GetFileId(), random_line_rid);
+      }
+      if (b_plus_tree == nullptr) {
+        continue;
+      }
       fmt::print("B PLUS TREE(random line file id: {}, rid: {})\n", rlm.second->GetFileId(), random_line_rid.Get());
       std::cout << b_plus_tree->ToString();
     }
   }
 }
 
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::GetProjectionColumn(file_id_t random_line_file_id, RID random_line_rid)
+    -> std::unique_ptr<ProjectionColumnReader<RandomLineValueType>> {
+  std::string file_name;
+  std::shared_ptr<ProjectionColumnWriter<RandomLineValueType>> projection_column;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    auto b_plus_tree_file_id = b_plus_tree_file_ids_.find({random_line_file_id, random_line_rid});
+    if (b_plus_tree_file_id == b_plus_tree_file_ids_.end()) {
+      return nullptr;
+    }
+    file_name = GetProjectionColumnFileName(b_plus_tree_file_id->second);
+    auto iterator = projection_columns_.find({random_line_file_id, random_line_rid});
+    if (iterator != projection_columns_.end()) {
+      projection_column = iterator->second;
+    }
+  }
+
+  // Records still buffered are made visible to the reader, a column without a writer is read as it is on disk
+  if (projection_column != nullptr) {
+    projection_column->Flush();
+  }
+  if (!std::filesystem::exists(file_name)) {
+    return nullptr;
+  }
+  return std::make_unique<ProjectionColumnReader<RandomLineValueType>>(file_name);
+}
+
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::BuildPackedIndex(file_id_t random_line_file_id)
+    -> std::shared_ptr<PackedProjectionIndex<RandomLineValueType>> {
+  // (random line rid, column file name, writer if opened, B+ tree) of the lines of the group
+  std::vector<std::tuple<RID,
+                         std::string,
+                         std::shared_ptr<ProjectionColumnWriter<RandomLineValueType>>,
+                         std::shared_ptr<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>>>> projection_columns;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    for (auto iterator = b_plus_tree_file_ids_.lower_bound({random_line_file_id, RID()});
+         iterator != b_plus_tree_file_ids_.end() && iterator->first.first == random_line_file_id; ++iterator) {
+      auto projection_column = projection_columns_.find(iterator->first);
+      projection_columns.emplace_back(iterator->first.second,
+                                      GetProjectionColumnFileName(iterator->second),
+                                      projection_column == projection_columns_.end() ? nullptr : projection_column->second,
+                                      GetBPlusTree(random_line_file_id, iterator->first.second));
+    }
+  }
+  if (projection_columns.empty()) {
+    return nullptr;
+  }
+
+  // Read the columns of the group, they stay mapped until the index is written. A column may miss records of its tree,
+  // as a tree built before the columns has none and a column lags its tree after a crash, such a line is read from the
+  // leaves of its tree instead.
+  std::vector<std::unique_ptr<ProjectionColumnReader<RandomLineValueType>>> readers;
+  std::vector<std::vector<ProjectionRecord<RandomLineValueType>>> scanned_records;
+  std::vector<typename PackedProjectionIndex<RandomLineValueType>::Line> lines;
+  scanned_records.reserve(projection_columns.size());
+  for (const auto &[random_line_rid, file_name, projection_column, b_plus_tree] : projection_columns) {
+    if (projection_column != nullptr) {
+      projection_column->Flush();
+    }
+    std::vector<std::pair<BPlusTreeKeyType, BPlusTreeValueType>> entries;
+    b_plus_tree->Scan(&entries);
+    if (std::filesystem::exists(file_name)) {
+      auto reader = std::make_unique<ProjectionColumnReader<RandomLineValueType>>(file_name);
+      if (reader->GetSize() == entries.size()) {
+        readers.emplace_back(std::move(reader));
+        lines.emplace_back(random_line_rid, readers.back()->GetRecords());
+        continue;
+      }
+    }
+
+    auto &records = scanned_records.emplace_back();
+    records.reserve(entries.size());
+    for (const auto &[value, data_rid] : entries) {
+      records.push_back({value, data_rid.GetPageId(), data_rid.GetSlotNum()});
+    }
+    lines.emplace_back(random_line_rid, records);
+  }
+
+  auto file_name = GetPackedIndexFileName(random_line_file_id);
+  PackedProjectionIndex<RandomLineValueType>::Build(file_name, lines);
+  auto packed_index = std::make_shared<PackedProjectionIndex<RandomLineValueType>>(file_name);
+
+  std::scoped_lock<std::mutex> lock(latch_);
+  packed_indexes_[random_line_file_id] = packed_index;
+  return packed_index;
+}
+
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::GetPackedIndex(file_id_t random_line_file_id)
+    -> std::shared_ptr<PackedProjectionIndex<RandomLineValueType>> {
+  std::scoped_lock<std::mutex> lock(latch_);
+  auto iterator = packed_indexes_.find(random_line_file_id);
+  return iterator == packed_indexes_.end() ? nullptr : iterator->second;
+}
+
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::GetProjectionColumnFileName(file_id_t b_plus_tree_file_id) -> std::string {
+  return b_plus_tree_directory_name_ + "/" + std::to_string(b_plus_tree_file_id) + PROJECTION_COLUMN_FILE_SUFFIX;
+}
+
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::GetPackedIndexFileName(file_id_t random_line_file_id) -> std::string {
+  return b_plus_tree_directory_name_ + "/" + std::to_string(random_line_file_id) + PACKED_INDEX_FILE_SUFFIX;
+}
+
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::OpenBPlusTree(file_id_t random_line_file_id,
+                                             RID random_line_rid,
+                                             file_id_t b_plus_tree_file_id)
+    -> std::shared_ptr<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>> {
+  auto file_name = b_plus_tree_directory_name_ + "/" + std::to_string(b_plus_tree_file_id) + B_PLUS_TREE_FILE_SUFFIX;
+  auto disk_manager = std::make_shared<DiskManager>(file_name);
+  auto next_page_id = GetNextPageId(disk_manager.get(), file_name);
+  auto bpm = CreateBufferPoolManager(buffer_pool_, pool_size_, k_, disk_manager, next_page_id);
+  b_plus_tree_bpms_.insert({b_plus_tree_file_id, bpm});
+
+  // Use random line file id concat its directory id and slot as identifier
+  auto b_plus_tree = std::make_shared<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>>(
+      std::to_string(random_line_file_id) + "-"
+          + std::to_string(random_line_rid.GetPageId()) + "-"
+          + std::to_string(random_line_rid.GetSlotNum()),
+      HEADER_PAGE_ID,
+      bpm,
+      b_plus_tree_leaf_max_size_,
+      b_plus_tree_internal_max_size_);
+  b_plus_trees_[{random_line_file_id, random_line_rid}] = b_plus_tree;
+  return b_plus_tree;
+}
+
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::GetBPlusTree(file_id_t random_line_file_id, RID random_line_rid)
+    -> std::shared_ptr<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>> {
+  auto iterator = b_plus_trees_.find({random_line_file_id, random_line_rid});
+  if (iterator != b_plus_trees_.end()) {
+    return iterator->second;
+  }
+
+  // The loading of the tree was deferred to the packed index
+  auto b_plus_tree_file_id = b_plus_tree_file_ids_.find({random_line_file_id, random_line_rid});
+  if (b_plus_tree_file_id == b_plus_tree_file_ids_.end()) {
+    return nullptr;
+  }
+  return OpenBPlusTree(random_line_file_id, random_line_rid, b_plus_tree_file_id->second);
+}
+
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::GetProjectionColumnWriter(file_id_t random_line_file_id, RID random_line_rid)
+    -> std::shared_ptr<ProjectionColumnWriter<RandomLineValueType>> {
+  auto iterator = projection_columns_.find({random_line_file_id, random_line_rid});
+  if (iterator != projection_columns_.end()) {
+    return iterator->second;
+  }
+
+  auto b_plus_tree_file_id = b_plus_tree_file_ids_.find({random_line_file_id, random_line_rid});
+  if (b_plus_tree_file_id == b_plus_tree_file_ids_.end()) {
+    return nullptr;
+  }
+  auto projection_column =
+      std::make_shared<ProjectionColumnWriter<RandomLineValueType>>(GetProjectionColumnFileName(b_plus_tree_file_id->second));
+  projection_columns_[{random_line_file_id, random_line_rid}] = projection_column;
+  return projection_column;
+}
+
 #ifdef BY_PASS_ACCESS_RANDOM_LINE_MANAGER
 RANDOM_LINE_MONITOR_TEMPLATE
 auto RANDOM_LINE_MONITOR_TYPE::GetConstituencyPoints(
@@ -420,17 +598,111 @@ auto RANDOM_LINE_MONITOR_TYPE::GetConstituencyPoints(
                                                                        random_line_rid.GetSlotNum(),
                                                                        query);
 
-  if (b_plus_trees_.find({random_line_file_id, random_line_rid}) == b_plus_trees_.end()) {
+  auto constituency = std::make_shared<std::vector<RID>>();
+  if (!RangeRead(random_line_file_id, random_line_rid, random_projection_value - radius,
+                 random_projection_value + radius, constituency.get())) {
     throw new Exception(ExceptionType::INVALID_ARGUMENT, "Invalid random line rid, not related b plus tree");
   }
+  return constituency;
+}
 
-  auto constituency = std::make_shared<std::vector<RID>>();
-  auto b_plus_tree = b_plus_trees_[{random_line_file_id, random_line_rid}];
-  b_plus_tree->RangeRead(random_projection_value - radius, random_projection_value + radius, constituency.get());
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::GetMultiProbeConstituencyPoints(
+    file_id_t random_line_file_id,
+    const std::vector<RID> &random_line_rids,
+    std::shared_ptr<RandomLineValueType[]> query,
+    int radius,
+    int probe_count) -> std::shared_ptr<std::vector<std::pair<RID, RID>>> {
+  if (by_pass_random_line_managers_.find(random_line_file_id) == by_pass_random_line_managers_.end()) {
+    throw Exception(ExceptionType::INVALID_ARGUMENT, "Invalid random line file id");
+  }
+  if (radius <= 0) {
+    throw Exception(ExceptionType::INVALID_ARGUMENT, "Radius of multi-probe must be positive");
+  }
+
+  auto random_line_manager = by_pass_random_line_managers_[random_line_file_id];
+  std::vector<RandomLineValueType> projections;
+  projections.reserve(random_line_rids.size());
+  for (const auto &random_line_rid : random_line_rids) {
+    projections.emplace_back(random_line_manager->InnerProduct(random_line_rid.GetPageId(),
+                                                               random_line_rid.GetSlotNum(),
+                                                               query));
+  }
+
+  // Buckets are half-open, the right key is moved below the next bucket so that no data is read twice
+  auto constituency = std::make_shared<std::vector<std::pair<RID, RID>>>();
+  MultiProbeSequence<RandomLineValueType> probe_sequence(std::move(projections),
+                                                         static_cast<RandomLineValueType>(2 * radius),
+                                                         static_cast<float>(radius),
+                                                         random_line_manager->GetDistributionType());
+  ProbeInterval<RandomLineValueType> interval{};
+  std::vector<RID> result;
+  while (probe_sequence.GetProbeCount() < static_cast<int>(random_line_rids.size()) + probe_count
+      && probe_sequence.Next(&interval)) {
+    result.clear();
+    const auto &random_line_rid = random_line_rids[interval.line_];
+    if (!RangeRead(random_line_file_id, random_line_rid, interval.lkey_,
+                   std::nextafter(interval.rkey_, interval.lkey_), &result)) {
+      throw Exception(ExceptionType::INVALID_ARGUMENT, "Invalid random line rid, not related b plus tree");
+    }
+    for (const auto &data_rid : result) {
+      constituency->emplace_back(random_line_rid, data_rid);
+    }
+  }
   return constituency;
 }
 #endif
 
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::RangeRead(file_id_t random_line_file_id,
+                                         RID random_line_rid,
+                                         RandomLineValueType lkey,
+                                         RandomLineValueType rkey,
+                                         std::vector<RID> *result) -> bool {
+  // The packed index of a finished group serves without touching the B+ tree pages
+  auto packed_index = GetPackedIndex(random_line_file_id);
+  if (packed_index != nullptr && packed_index->GetSize(random_line_rid) >= 0) {
+    packed_index->RangeRead(random_line_rid, lkey, rkey, result);
+    return true;
+  }
+
+  std::shared_ptr<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>> b_plus_tree;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    b_plus_tree = GetBPlusTree(random_line_file_id, random_line_rid);
+    if (b_plus_tree == nullptr) {
+      return false;
+    }
+  }
+  b_plus_tree->RangeRead(lkey, rkey, result);
+  return true;
+}
+
+RANDOM_LINE_MONITOR_TEMPLATE
+auto RANDOM_LINE_MONITOR_TYPE::RangeReadAsync(file_id_t random_line_file_id,
+                                              RID random_line_rid,
+                                              RandomLineValueType lkey,
+                                              RandomLineValueType rkey,
+                                              std::vector<RID> *result) -> Task<bool> {
+  // The packed index is mapped in memory, it never waits for the disk scheduler
+  auto packed_index = GetPackedIndex(random_line_file_id);
+  if (packed_index != nullptr && packed_index->GetSize(random_line_rid) >= 0) {
+    packed_index->RangeRead(random_line_rid, lkey, rkey, result);
+    co_return true;
+  }
+
+  std::shared_ptr<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>> b_plus_tree;
+  {
+    std::scoped_lock<std::mutex> lock(latch_);
+    b_plus_tree = GetBPlusTree(random_line_file_id, random_line_rid);
+    if (b_plus_tree == nullptr) {
+      co_return false;
+    }
+  }
+  co_await b_plus_tree->RangeReadAsync(lkey, rkey, result);
+  co_return true;
+}
+
 template
 class RandomLineMonitor<float>;
 } // namespace distribution_lsh
\ No newline at end of file
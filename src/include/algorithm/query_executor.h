@@ -0,0 +1,147 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/include/algorithm/query_executor.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <functional>
+#include <limits>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include <common/config.h>
+#include <common/rid.h>
+#include <common/work_stealing_pool.h>
+
+namespace distribution_lsh {
+
+#define QUERY_EXECUTOR_TEMPLATE template<typename ValueType>
+#define QUERY_EXECUTOR_TYPE QueryExecutor<ValueType>
+
+/** A verified neighbor of a query */
+struct Neighbor {
+  float distance_;
+  RID rid_;
+
+  auto operator<(const Neighbor &other) const -> bool { return distance_ < other.distance_; }
+};
+
+/** Reason a query stops */
+enum class QueryTermination : std::uint8_t {
+  INVALID_TERMINATION = 0,
+  ACCURATE,           // the k-th verified neighbor is within c * R
+  CANDIDATE_BUDGET,   // candidate budget is used up
+  SCAN_BUDGET,        // scan budget is used up
+  MAX_RADIUS          // radius reaches its limit
+};
+
+/**
+ * @brief c-k-ANN query with early termination over the random lines of a group, in the way of QALSH.
+ * Every random line is scanned outwards from the projection of the query, the window of a line is
+ * [projection - w * R / 2, projection + w * R / 2] for the radius R and the bucket width w, and the radius grows by c
+ * in rounds. Only the part of a window not scanned yet is read. A data is verified as soon as it collides with the
+ * query on collision threshold lines, verified neighbors are kept in a bounded max-heap of size k.
+ * The query stops once the k-th neighbor is within c * R, or the candidate budget (verified data) or the scan budget
+ * (index entries read) is used up, or the radius passes its limit.
+ * Lines are read and data verified through the callbacks, so that any index and data set can be plugged in.
+ * With a pool, the reads of a round fan out over the lines and scatter the data read into partitions, collision counts
+ * are merged by partitions that are owned by one task each, and the new candidates are verified in parallel batches.
+ * They are taken in the order of a serial query and the termination is checked between the batches, so that both modes
+ * return the same neighbors. The callbacks must be thread safe in this mode.
+ */
+QUERY_EXECUTOR_TEMPLATE
+class QueryExecutor {
+ public:
+  /** Read the data whose projection onto a line lies in [lkey, rkey] */
+  using RangeReader = std::function<bool(int line, ValueType lkey, ValueType rkey, std::vector<RID> *result)>;
+  /** Compute the distance between the query and a data, false if the data does not exist */
+  using Verifier = std::function<bool(const RID &rid, float *distance)>;
+
+  /**
+   * @param k number of neighbors
+   * @param collision_threshold lines a data collides with before it is verified
+   * @param approximation_ratio approximation ratio c, greater than 1
+   * @param bucket_width bucket width w of the projection windows
+   * @param pool pool the probes of a query fan out on, the shared pool by default, nullptr to run a query on the
+   * calling thread
+   */
+  QueryExecutor(RangeReader range_reader,
+                Verifier verifier,
+                int k,
+                int collision_threshold,
+                float approximation_ratio = 2.0F,
+                float bucket_width = 1.0F,
+                int candidate_budget = QUERY_CANDIDATE_BUDGET,
+                int64_t scan_budget = QUERY_SCAN_BUDGET,
+                WorkStealingPool *pool = &WorkStealingPool::GetInstance());
+
+  /**
+   * Search the k nearest neighbors of a query
+   * @param projections projections of the query onto the random lines
+   * @param initial_radius radius of the first round
+   * @param max_radius the query stops after the round of this radius
+   * @return verified neighbors in increasing distance, at most k
+   */
+  auto Execute(const std::vector<ValueType> &projections,
+               float initial_radius = 1.0F,
+               float max_radius = std::numeric_limits<float>::max()) -> std::vector<Neighbor>;
+
+  /** Statistics of the last query */
+  [[nodiscard]] auto GetTermination() const -> QueryTermination { return termination_; }
+  [[nodiscard]] auto GetRadius() const -> float { return radius_; }
+  [[nodiscard]] auto GetRoundCount() const -> int { return round_count_; }
+  [[nodiscard]] auto GetCandidateCount() const -> int { return candidate_count_; }
+  [[nodiscard]] auto GetScanCount() const -> int64_t { return scan_count_; }
+
+ private:
+  /** A data crossing the collision threshold, at position of the data read from line in a round */
+  struct Crossing {
+    int line_;
+    size_t position_;
+    RID rid_;
+  };
+
+  /** Read the part of the window [left, right] of a line outside the window scanned before */
+  void ReadWindow(int line, ValueType left, ValueType right, bool is_scanned, ValueType scanned_left,
+                  ValueType scanned_right, std::vector<RID> *result);
+
+  /** Count the collisions of the data read, verify the data crossing the threshold */
+  auto Collide(const std::vector<RID> &rids) -> bool;
+
+  /** Run a round over all the lines on the pool */
+  auto ParallelRound(const std::vector<ValueType> &lefts, const std::vector<ValueType> &rights,
+                     const std::vector<ValueType> &scanned_lefts, const std::vector<ValueType> &scanned_rights,
+                     const std::vector<bool> &is_scanned) -> bool;
+
+  /** Take a verified neighbor into the heap */
+  void Push(float distance, const RID &rid);
+
+  /** Check the termination conditions, the reason is kept if the query stops */
+  auto IsTerminated() -> bool;
+
+  RangeReader range_reader_;
+  Verifier verifier_;
+  int k_;
+  int collision_threshold_;
+  float approximation_ratio_;
+  float bucket_width_;
+  int candidate_budget_;
+  int64_t scan_budget_;
+  WorkStealingPool *pool_;
+
+  /** State of the last query, collision counts are split into partitions of the data in the parallel mode */
+  std::unordered_map<int64_t /* rid */, int> collision_counts_;
+  std::vector<std::unordered_map<int64_t /* rid */, int>> collision_partitions_;
+  std::priority_queue<Neighbor> neighbors_;
+  QueryTermination termination_{QueryTermination::INVALID_TERMINATION};
+  float radius_{0.0F};
+  int round_count_{0};
+  int candidate_count_{0};
+  int64_t scan_count_{0};
+};
+
+} // namespace distribution_lsh
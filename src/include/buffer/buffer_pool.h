@@ -0,0 +1,90 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/include/buffer/buffer_pool.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <coroutine>
+#include <list>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <buffer/lru_k_replacer.h>
+#include <common/config.h>
+#include <storage/page/page.h>
+
+namespace distribution_lsh {
+
+class BufferPoolManager;
+
+/**
+ * @brief Frames of a buffer pool, which can be shared by the buffer pool managers of many files.
+ * Pages are keyed by (file key, page id), where every buffer pool manager attached to the pool gets its own file key,
+ * so that all the files are under one memory budget and one replacer, and frames move to the files being used.
+ * Each buffer pool manager keeps its own disk scheduler and page allocation, a dirty page evicted by another file
+ * is written back through the disk scheduler of its owner.
+ */
+class BufferPool {
+ public:
+  /**
+   * @param pool_size number of frames shared by all the attached files
+   * @param replacer_k the LookBack constant k for the LRU-K replacer
+   */
+  explicit BufferPool(size_t pool_size, size_t replacer_k = LRUK_REPLACER_K);
+
+  BufferPool(const BufferPool &) = delete;
+  auto operator=(const BufferPool &) -> BufferPool & = delete;
+
+  /** @brief Return the size (number of frames) of the buffer pool. */
+  auto GetPoolSize() const -> size_t { return pool_size_; }
+
+  /** @brief Return the number of frames that hold no page. */
+  auto GetFreeFrameCount() -> size_t;
+
+ private:
+  friend class BufferPoolManager;
+
+  using PageKey = std::pair<uint32_t /* file key */, page_id_t>;
+
+  struct PageKeyHash {
+    auto operator()(const PageKey &key) const -> size_t {
+      return std::hash<uint64_t>{}(static_cast<uint64_t>(key.first) << 32 | static_cast<uint32_t>(key.second));
+    }
+  };
+
+  /** Number of pages in the buffer pool. */
+  const size_t pool_size_;
+  /** Array of buffer pool pages. */
+  std::shared_ptr<Page []> pages_;
+  /** Buffer pool manager whose page is in each frame, nullptr for a free frame. */
+  std::vector<BufferPoolManager *> frame_owners_;
+  /** Page table for keeping track of buffer pool pages of all the files. */
+  std::unordered_map<PageKey, frame_id_t, PageKeyHash> page_table_;
+  /** Replacer to find unpinned pages for replacement. */
+  std::unique_ptr<LRUKReplacer> replacer_;
+  /** List of free frames that don't have any pages on them. */
+  std::list<frame_id_t> free_list_;
+  /** This latch protects the frames, the page table, the replacer and the free list. */
+  std::mutex latch_;
+  /** Frames whose page is being read by an asynchronous fetch, with the coroutines waiting for the page. */
+  std::unordered_map<frame_id_t, std::vector<std::coroutine_handle<>>> loading_frames_;
+  /**
+   * This latch protects the loading frames, it is taken after the pool latch if both are held. The disk thread takes
+   * it alone to mark a frame loaded, so that a read never waits for a thread holding the pool latch.
+   */
+  std::mutex load_latch_;
+  /** Notified under the load latch when a frame finishes loading. */
+  std::condition_variable loaded_cv_;
+  /** The next file key given to an attached buffer pool manager. */
+  std::atomic<uint32_t> next_file_key_{0};
+};
+
+}// namespace distribution_lsh
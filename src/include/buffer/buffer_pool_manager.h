@@ -7,13 +7,16 @@
 
 #pragma once
 
+#include <coroutine>
 #include <list>
 #include <memory>
 #include <mutex>  // NOLINT
 #include <unordered_map>
 
+#include <buffer/buffer_pool.h>
 #include <buffer/lru_k_replacer.h>
 #include <common/config.h>
+#include <common/task.h>
 #include <recovery/log_manager.h>
 #include <storage/disk/disk_scheduler.h>
 #include <storage/page/page.h>
@@ -36,15 +39,27 @@ class BufferPoolManager {
                     LogManager *log_manager = nullptr, page_id_t next_page_id = HEADER_PAGE_ID);
 
   /**
-   * @brief Destroy an existing BufferPoolManager.
+   * @brief Creates a new BufferPoolManager of a file on a buffer pool shared with other files.
+   * @param buffer_pool the shared buffer pool
+   * @param disk_manager the disk manager of the file
+   * @param log_manager the log manager (for testing only: nullptr = disable logging).
+   */
+  BufferPoolManager(std::shared_ptr<BufferPool> buffer_pool, std::shared_ptr<DiskManager> disk_manager,
+                    LogManager *log_manager = nullptr, page_id_t next_page_id = HEADER_PAGE_ID);
+
+  /**
+   * @brief Destroy an existing BufferPoolManager, its pages are flushed and their frames are given back to the pool.
    */
   ~BufferPoolManager();
 
   /** @brief Return the size (number of frames) of the buffer pool. */
-  auto GetPoolSize() const -> size_t { return pool_size_; }
+  auto GetPoolSize() const -> size_t { return pool_->GetPoolSize(); }
 
   /** @brief Return the pointer to all the pages in the buffer pool. */
-  auto GetPages() -> std::shared_ptr<Page[]> { return pages_; }
+  auto GetPages() -> std::shared_ptr<Page[]> { return pool_->pages_; }
+
+  /** @brief Return the buffer pool, which may be shared with other files. */
+  auto GetBufferPool() const -> std::shared_ptr<BufferPool> { return pool_; }
 
   /**
    * @brief Create a new page in the buffer pool. Set page_id to the new page's id, or nullptr if all frames
@@ -53,7 +68,7 @@ class BufferPoolManager {
    * @param[out] page_id id of created page
    * @return nullptr if no new pages could be created, otherwise pointer to new page
    */
-  auto NewPage(page_id_t *page_id) -> std::shared_ptr<Page>;
+  auto NewPage(page_id_t *page_id) -> Page *;
 
   /**
    * @brief PageGuard wrapper for NewPage
@@ -63,6 +78,26 @@ class BufferPoolManager {
    */
   auto NewPageGuarded(page_id_t *page_id) -> BasicPageGuard;
 
+  /**
+   * @brief Reserve a run of contiguous page ids at the end of the file, so that the pages of a chain are laid out
+   * sequentially. The pages are created by NewReservedPageGuarded, the ids left unused are given back by ReleasePages.
+   *
+   * @param count number of page ids
+   * @return the first page id of the run
+   */
+  auto ReservePages(int count) -> page_id_t;
+
+  /**
+   * @brief Create the page of a reserved page id
+   *
+   * @param[in,out] page_id reserved page id, set to INVALID_PAGE_ID if all frames are pinned
+   * @return BasicPageGuard holding the new page
+   */
+  auto NewReservedPageGuarded(page_id_t *page_id) -> BasicPageGuard;
+
+  /** @brief Give back the reserved page ids [first_page_id, first_page_id + count) whose pages were not created */
+  void ReleasePages(page_id_t first_page_id, int count);
+
   /**
   * @brief Fetch the requested page from the buffer pool. Return nullptr if page_id needs to be fetched from the disk
   * but all frames are currently in use and not evictable (in another word, pinned).
@@ -71,7 +106,7 @@ class BufferPoolManager {
   * @param access_type type of access to the page, only needed for leaderboard test.
   * @return nullptr if page_id cannot be fetched, otherwise pointer to the requested page
   */
-  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> std::shared_ptr<Page>;
+  auto FetchPage(page_id_t page_id, AccessType access_type = AccessType::Unknown) -> Page *;
 
   /**
    * @brief PageGuard wrappers for FetchPage
@@ -83,6 +118,19 @@ class BufferPoolManager {
   auto FetchPageRead(page_id_t page_id) -> ReadPageGuard;
   auto FetchPageWrite(page_id_t page_id) -> WritePageGuard;
 
+  /**
+   * @brief Fetch a page for reading in a coroutine, as co_await bpm->FetchPageReadAsync(page_id).
+   *
+   * A miss suspends the coroutine instead of blocking the thread: the read is queued to the disk scheduler without
+   * holding the pool latch, and the coroutine resumes on the work-stealing pool once the page is in. Fetches of a page
+   * being read wait for the same read. The read latch is taken without blocking the thread, and it is owned by the
+   * thread the caller goes on with: the guard must be dropped before the next co_await of the caller.
+   *
+   * @param page_id, the id of the page to fetch
+   * @return ReadPageGuard holding the fetched page, holding nullptr if all frames are pinned
+   */
+  auto FetchPageReadAsync(page_id_t page_id) -> Task<ReadPageGuard>;
+
   /**
    * @brief Unpin the target page from the buffer pool. If page_id is not in the buffer pool or its pin count is already
    * 0, return false.
@@ -103,7 +151,8 @@ class BufferPoolManager {
   auto FlushPage(page_id_t page_id) -> bool;
 
   /**
-   * @brief Flush all the pages in the buffer pool to disk.
+   * @brief Flush all the pages of this file in the buffer pool to disk. The pages are written from copies, the
+   * unpinned ones are clean afterwards.
    */
   void FlushAllPages();
 
@@ -117,30 +166,68 @@ class BufferPoolManager {
   auto DeletePage(page_id_t page_id) -> bool;
 
  private:
-  /** Number of pages in the buffer pool. */
-  const size_t pool_size_;
-
-  /** Array of buffer pool pages. */
-  std::shared_ptr<Page []> pages_;
+  /** Frames, page table and replacer, possibly shared with other files. */
+  std::shared_ptr<BufferPool> pool_;
+  /** Key of this file in the page table of the pool. */
+  uint32_t file_key_;
   /** Temporary page for null page record. */
   std::shared_ptr<Page []> extra_pages_;
   /** Pointer to the disk scheduler. */
   std::unique_ptr<DiskScheduler> disk_scheduler_ __attribute__((__unused__));
   /** Pointer to the log manager. Please ignore this for P1. */
   LogManager *log_manager_ __attribute__((__unused__));
-  /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
-  std::unique_ptr<LRUKReplacer> replacer_;
-  /** List of free frames that don't have any pages on them. */
-  std::list<frame_id_t> free_list_;
   /** List of free page which is deleted before*/
   std::list<page_id_t> free_page_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
-  std::mutex latch_;
   /** The next page id to be allocated. */
   std::atomic<page_id_t> next_page_id_ = 0;
 
+  /** Awaiter pinning a page for a coroutine, the coroutine is suspended while the page is read from disk */
+  class FetchPageAwaiter {
+   public:
+    FetchPageAwaiter(BufferPoolManager *bpm, page_id_t page_id) : bpm_(bpm), page_id_(page_id) {}
+
+    /** Pin the page, a miss takes a frame and marks it loading */
+    auto await_ready() -> bool;
+    /** Wait for the read of the page, which is queued here by the fetch that missed */
+    auto await_suspend(std::coroutine_handle<> handle) -> bool;
+    auto await_resume() -> Page *;
+
+   private:
+    BufferPoolManager *bpm_;
+    page_id_t page_id_;
+    frame_id_t frame_id_{-1};
+    bool is_reader_{false};
+  };
+
+  /**
+   * Take a frame out of the loading frames once its page is read, and resume the coroutines waiting for it on the
+   * work-stealing pool. It takes the load latch only, so that the disk thread can run it for an asynchronous fetch.
+   */
+  void FinishLoad(frame_id_t frame_id);
+
+  /** @return true if the page of the frame is being read by an asynchronous fetch */
+  auto IsLoading(frame_id_t frame_id) -> bool;
+
+  /**
+   * @brief Find the frame holding a page of this file. Caller should acquire the pool latch.
+   * @return the frame, -1 if the page is not in the buffer pool
+   */
+  auto FindFrame(page_id_t page_id) -> frame_id_t;
+
+  /**
+   * @brief Take a free frame or evict one, a dirty page is copied and written back through the disk scheduler of its
+   * owner without waiting. Caller should acquire the pool latch.
+   * @param[out] frame_id the frame taken
+   * @return false if all frames are pinned
+   */
+  auto AcquireFrame(frame_id_t *frame_id) -> bool;
+
+  /**
+   * @brief Set up a taken frame for a new page, pinned and not evictable. Caller should acquire the pool latch.
+   * @return the new page
+   */
+  auto InstallNewPage(frame_id_t target_frame, page_id_t page_id) -> Page *;
+
   /**
    * @brief Allocate a page on disk. Caller should acquire the latch before calling this function.
    * @return the id of the allocated page
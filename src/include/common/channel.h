@@ -8,48 +8,147 @@
 
 #pragma once
 
-#include <condition_variable>  // NOLINT
-#include <mutex>               // NOLINT
-#include <queue>
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <optional>
 #include <utility>
 
+#include <common/config.h>
+
 namespace distribution_lsh {
 /**
  * Channels allow for safe sharing of data between threads. This is a multi-producer multi-consumer channel.
+ *
+ * Elements are kept in a bounded lock-free ring. Every slot carries a sequence number telling whether it is ready for
+ * the producer or the consumer of a round, a thread claims a slot by advancing the enqueue or dequeue position.
+ * A consumer of an empty channel (a producer of a full one) sleeps on an epoch counter that is bumped by every put
+ * (get), and a single sleeper is woken per element, so that a put costs no lock and wakes no more than one thread.
  */
 template<class T>
 class Channel {
  public:
-  Channel() = default;
+  /** @param capacity number of elements buffered at most, rounded up to a power of two */
+  explicit Channel(size_t capacity = CHANNEL_CAPACITY)
+      : mask_(std::bit_ceil(std::max<size_t>(capacity, 2)) - 1), slots_(new Slot[mask_ + 1]) {
+    for (size_t i = 0; i <= mask_; ++i) {
+      slots_[i].sequence_.store(i, std::memory_order_relaxed);
+    }
+  }
   ~Channel() = default;
 
+  Channel(const Channel &) = delete;
+  auto operator=(const Channel &) -> Channel & = delete;
+
   /**
-   * @brief Inserts an element into a shared queue.
+   * @brief Inserts an element into a shared queue. If the queue is full, blocks until a slot is available.
    *
    * @param element The element to be inserted.
    */
   void Put(T element) {
-    std::unique_lock<std::mutex> lk(m_);
-    q_.push(std::move(element));
-    lk.unlock();
-    cv_.notify_all();
+    while (!TryPut(&element)) {
+      auto epoch = get_epoch_.load();
+      if (TryPut(&element)) {
+        break;
+      }
+      Sleep(&get_epoch_, &put_sleepers_, epoch);
+    }
+    Wake(&put_epoch_, &get_sleepers_);
   }
 
   /**
    * @brief Gets an element from the shared queue. If the queue is empty, blocks until an element is available.
    */
   auto Get() -> T {
-    std::unique_lock<std::mutex> lk(m_);
-    cv_.wait(lk, [&]() { return !q_.empty(); });
-    T element = std::move(q_.front());
-    q_.pop();
-    return element;
+    std::optional<T> element;
+    while (!TryGet(&element)) {
+      auto epoch = put_epoch_.load();
+      if (TryGet(&element)) {
+        break;
+      }
+      Sleep(&put_epoch_, &get_sleepers_, epoch);
+    }
+    Wake(&get_epoch_, &put_sleepers_);
+    return std::move(*element);
   }
 
  private:
-  std::mutex m_;
-  std::condition_variable cv_;
-  std::queue<T> q_;
+  struct Slot {
+    /** Equal to the position for a producer, to the position + 1 for a consumer */
+    std::atomic<size_t> sequence_;
+    std::optional<T> element_;
+  };
+
+  /** Move the element into a free slot, the element is kept if the channel is full */
+  auto TryPut(T *element) -> bool {
+    auto position = enqueue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      auto &slot = slots_[position & mask_];
+      auto difference = static_cast<int64_t>(slot.sequence_.load(std::memory_order_acquire) - position);
+      if (difference == 0) {
+        if (enqueue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          slot.element_.emplace(std::move(*element));
+          slot.sequence_.store(position + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = enqueue_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /** Move the oldest element out of its slot, false if the channel is empty */
+  auto TryGet(std::optional<T> *element) -> bool {
+    auto position = dequeue_position_.load(std::memory_order_relaxed);
+    while (true) {
+      auto &slot = slots_[position & mask_];
+      auto difference = static_cast<int64_t>(slot.sequence_.load(std::memory_order_acquire) - (position + 1));
+      if (difference == 0) {
+        if (dequeue_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+          element->emplace(std::move(*slot.element_));
+          slot.element_.reset();
+          // The slot is free for the producer of the next round
+          slot.sequence_.store(position + mask_ + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (difference < 0) {
+        return false;
+      } else {
+        position = dequeue_position_.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /**
+   * Sleep until the epoch moves on from the one read before the last try. The sleeper is counted before the epoch is
+   * checked again, so that either the waker sees the sleeper or the sleeper sees the new epoch.
+   */
+  static void Sleep(std::atomic<uint32_t> *epoch, std::atomic<uint32_t> *sleepers, uint32_t old_epoch) {
+    sleepers->fetch_add(1);
+    epoch->wait(old_epoch);
+    sleepers->fetch_sub(1);
+  }
+
+  static void Wake(std::atomic<uint32_t> *epoch, std::atomic<uint32_t> *sleepers) {
+    epoch->fetch_add(1);
+    if (sleepers->load() > 0) {
+      epoch->notify_one();
+    }
+  }
+
+  size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+  /** Positions and epochs are written by different sides, keep them on their own cache lines */
+  alignas(64) std::atomic<size_t> enqueue_position_{0};
+  alignas(64) std::atomic<size_t> dequeue_position_{0};
+  alignas(64) std::atomic<uint32_t> put_epoch_{0};
+  std::atomic<uint32_t> get_sleepers_{0};
+  alignas(64) std::atomic<uint32_t> get_epoch_{0};
+  std::atomic<uint32_t> put_sleepers_{0};
 };
 
 }// namespace distribution_lsh
@@ -30,11 +30,24 @@ static const int INVALID_LSN = -1;
 static const int HEADER_PAGE_ID = 0;                                                          // the header page id
 static const int DISTRIBUTION_LSH_PAGE_SIZE = 4096;                                           // size of a data page in byte
 static const int BUFFER_POOL_SIZE = 10;                                                       // size of buffer pool
+static const int MONITOR_SHARED_POOL_SIZE = 4096;                                            // frames of the pool shared by the files of a monitor
 static const int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * DISTRIBUTION_LSH_PAGE_SIZE);     // size of a log buffer in byte
 static const int BUCKET_SIZE = 50;                                                            // size of extendable hash bucket
 static const int LRUK_REPLACER_K = 10;                                                        // lookback window for lru-k replacer
 static const float EPSILON = 0.1;                                                              // epsilon for generating random line
+static const int SEEDED_RANDOM_LINE_GROUP_EPSILON = -1;                                      // epsilon key of a seed-defined random line group, which keeps no average
 static const int RANDOM_LINE_GROUP_MAX_SIZE = 1000;                                           // max size of random line group
+static const int RANDOM_LINE_GENERATION_BATCH_SIZE = 256;                                    // candidate lines generated per batch
+static const int DISTRIBUTION_DATASET_CHUNK_SIZE = 1024;                                      // rows generated / ingested per chunk
+static const int DISTRIBUTION_DATASET_INGEST_QUEUE_DEPTH = 4;                                  // chunks in flight while ingesting
+static const int DISTRIBUTION_DATASET_COLUMN_BLOCK_SIZE = 64;                                 // vectors per block of a column store
+static const int PROJECTION_COLUMN_BUFFER_SIZE = 1024;                                        // records buffered by a projection column writer
+static const int PACKED_INDEX_FENCE_INTERVAL = 256;                                           // records between two fences of a packed index
+static const int QUERY_CANDIDATE_BUDGET = 1024;                                              // candidates verified by a query at most
+static const int64_t QUERY_SCAN_BUDGET = 1 << 20;                                             // index entries scanned by a query at most
+static const int QUERY_VERIFICATION_BATCH_SIZE = 64;                                        // candidates verified in parallel between two termination checks
+static const int CHANNEL_CAPACITY = 1024;                                                    // elements buffered by a channel at most
+static const int64_t PARALLEL_GRAIN_SIZE = 1 << 14;                                           // values handled by a task of a parallel for at least
 static const int INVALID_DIMENSION = -1;                                                      // invalid dimension  number
 static const int NULL_SLOT_END = -1;                                                          // null end signal
 static const int INVALID_SLOT_VALUE = -2;                                                     // invalid slot value
@@ -42,6 +55,9 @@ static const char DATASET_FILE_SUFFIX[] = ".dd";
 static const char B_PLUS_TREE_FILE_SUFFIX[] = ".bt";                                               // suffix of b plus tree file
 static const char RANDOM_LINE_FILE_SUFFIX[] = ".rl";                                          // suffix of random file
 static const char RELATION_FILE_SUFFIX[] = ".re";                                             // suffix of relation file
+static const char COLUMN_STORE_FILE_SUFFIX[] = ".dc";                                         // suffix of column store file
+static const char PROJECTION_COLUMN_FILE_SUFFIX[] = ".pc";                                    // suffix of projection column file
+static const char PACKED_INDEX_FILE_SUFFIX[] = ".pi";                                         // suffix of packed projection index file
 
 using frame_id_t = int32_t;     // frame id type
 using page_id_t = int32_t;      // page id type
@@ -0,0 +1,196 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/include/common/task.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <atomic>
+#include <coroutine>
+#include <exception>
+#include <future>  // NOLINT
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include <common/work_stealing_pool.h>
+
+namespace distribution_lsh {
+
+/**
+ * Lazy coroutine producing a value. It starts when it is awaited and resumes its awaiter when it finishes, the first
+ * exception thrown in the coroutine is thrown by co_await. A task may finish on another thread than it started on,
+ * e.g. a page fetch resumes on the work-stealing pool once the disk scheduler has read the page.
+ */
+template<typename T>
+class Task {
+ public:
+  struct promise_type {
+    /** Resume the awaiter of the task, if any, without growing the stack */
+    struct FinalAwaiter {
+      auto await_ready() noexcept -> bool { return false; }
+      auto await_suspend(std::coroutine_handle<promise_type> handle) noexcept -> std::coroutine_handle<> {
+        auto continuation = handle.promise().continuation_;
+        return continuation ? continuation : std::noop_coroutine();
+      }
+      void await_resume() noexcept {}
+    };
+
+    auto get_return_object() -> Task { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    auto initial_suspend() noexcept -> std::suspend_always { return {}; }
+    auto final_suspend() noexcept -> FinalAwaiter { return {}; }
+    void return_value(T value) { value_.emplace(std::move(value)); }
+    void unhandled_exception() { exception_ = std::current_exception(); }
+
+    std::coroutine_handle<> continuation_{nullptr};
+    std::optional<T> value_;
+    std::exception_ptr exception_{nullptr};
+  };
+
+  Task(Task &&that) noexcept : handle_(std::exchange(that.handle_, nullptr)) {}
+  auto operator=(Task &&that) noexcept -> Task & {
+    if (this != &that) {
+      if (handle_) {
+        handle_.destroy();
+      }
+      handle_ = std::exchange(that.handle_, nullptr);
+    }
+    return *this;
+  }
+  Task(const Task &) = delete;
+  auto operator=(const Task &) -> Task & = delete;
+
+  ~Task() {
+    if (handle_) {
+      handle_.destroy();
+    }
+  }
+
+  auto operator co_await() && noexcept {
+    struct Awaiter {
+      auto await_ready() noexcept -> bool { return false; }
+      auto await_suspend(std::coroutine_handle<> continuation) noexcept -> std::coroutine_handle<> {
+        handle_.promise().continuation_ = continuation;
+        return handle_;
+      }
+      auto await_resume() -> T {
+        if (handle_.promise().exception_ != nullptr) {
+          std::rethrow_exception(handle_.promise().exception_);
+        }
+        return std::move(*handle_.promise().value_);
+      }
+
+      std::coroutine_handle<promise_type> handle_;
+    };
+    return Awaiter{handle_};
+  }
+
+ private:
+  explicit Task(std::coroutine_handle<promise_type> handle) : handle_(handle) {}
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+/**
+ * Awaiter moving the coroutine onto the shared work-stealing pool, as co_await ResumeOnPool(). A coroutine waiting
+ * for a latch it failed to take awaits it to give the thread back instead of blocking it.
+ */
+struct ResumeOnPool {
+  auto await_ready() noexcept -> bool { return false; }
+  void await_suspend(std::coroutine_handle<> handle) {
+    WorkStealingPool::GetInstance().Submit([handle]() { handle.resume(); });
+  }
+  void await_resume() noexcept {}
+};
+
+namespace detail {
+
+/** Coroutine that starts at once and frees itself when it finishes, exceptions must be caught inside */
+struct DetachedTask {
+  struct promise_type {
+    auto get_return_object() -> DetachedTask { return {}; }
+    auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+    auto final_suspend() noexcept -> std::suspend_never { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+};
+
+}  // namespace detail
+
+/**
+ * Run a task to the end and block the calling thread until it finishes. It must not be called on a thread the task
+ * resumes on, e.g. a worker of the work-stealing pool.
+ */
+template<typename T>
+auto SyncWait(Task<T> task) -> T {
+  std::promise<T> promise;
+  auto future = promise.get_future();
+  // The promise lives in the coroutine frame, the waiting thread only holds the future
+  [](Task<T> task, std::promise<T> promise) -> detail::DetachedTask {
+    try {
+      promise.set_value(co_await std::move(task));
+    } catch (...) {
+      promise.set_exception(std::current_exception());
+    }
+  }(std::move(task), std::move(promise));
+  return future.get();
+}
+
+/**
+ * Run tasks concurrently and wait for all of them, so that the page reads they suspend on are in flight together.
+ * @return results in the order of the tasks, the first exception of the tasks is thrown once all of them finish
+ */
+template<typename T>
+auto WhenAll(std::vector<Task<T>> tasks) -> Task<std::vector<T>> {
+  struct Awaiter {
+    auto await_ready() -> bool { return tasks_->empty(); }
+
+    auto await_suspend(std::coroutine_handle<> continuation) -> bool {
+      continuation_ = continuation;
+      remaining_.store(tasks_->size() + 1);
+      for (size_t i = 0; i < tasks_->size(); ++i) {
+        Run(this, i);
+      }
+      // Tasks that all finished without suspending leave the awaiter running
+      return remaining_.fetch_sub(1) != 1;
+    }
+
+    void await_resume() {}
+
+    static auto Run(Awaiter *awaiter, size_t index) -> detail::DetachedTask {
+      try {
+        (*awaiter->results_)[index].emplace(co_await std::move((*awaiter->tasks_)[index]));
+      } catch (...) {
+        (*awaiter->exceptions_)[index] = std::current_exception();
+      }
+      if (awaiter->remaining_.fetch_sub(1) == 1) {
+        awaiter->continuation_.resume();
+      }
+    }
+
+    std::vector<Task<T>> *tasks_;
+    std::vector<std::optional<T>> *results_;
+    std::vector<std::exception_ptr> *exceptions_;
+    std::atomic<size_t> remaining_{0};
+    std::coroutine_handle<> continuation_{nullptr};
+  };
+
+  std::vector<std::optional<T>> results(tasks.size());
+  std::vector<std::exception_ptr> exceptions(tasks.size(), nullptr);
+  co_await Awaiter{&tasks, &results, &exceptions};
+
+  std::vector<T> values;
+  values.reserve(results.size());
+  for (size_t i = 0; i < results.size(); ++i) {
+    if (exceptions[i] != nullptr) {
+      std::rethrow_exception(exceptions[i]);
+    }
+    values.emplace_back(std::move(*results[i]));
+  }
+  co_return values;
+}
+
+}// namespace distribution_lsh
@@ -0,0 +1,88 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/10.
+// src/include/common/util/mapped_file.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <string>
+#include <utility>
+
+#include <common/exception.h>
+
+namespace distribution_lsh {
+
+/**
+ * @brief Read-only memory mapping of a whole file, unmapped when the object is destroyed
+ */
+class MappedFile {
+ public:
+  MappedFile() = default;
+
+  /** @param advice madvise advice of the whole mapping, raw data sets are read from the beginning to the end */
+  explicit MappedFile(const std::string &file_name, int advice = MADV_SEQUENTIAL) {
+    auto fd = open(file_name.c_str(), O_RDONLY);
+    if (fd < 0) {
+      throw Exception("Cannot open file " + file_name);
+    }
+
+    struct stat file_stat {};
+    if (fstat(fd, &file_stat) != 0) {
+      close(fd);
+      throw Exception("Cannot stat file " + file_name);
+    }
+
+    size_ = static_cast<size_t>(file_stat.st_size);
+    if (size_ > 0) {
+      auto data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (data == MAP_FAILED) {
+        close(fd);
+        throw Exception("Cannot map file " + file_name);
+      }
+      madvise(data, size_, advice);
+      data_ = static_cast<const char *>(data);
+    }
+    close(fd);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+  auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+  MappedFile(MappedFile &&that) noexcept
+      : data_(std::exchange(that.data_, nullptr)), size_(std::exchange(that.size_, 0)) {}
+
+  auto operator=(MappedFile &&that) noexcept -> MappedFile & {
+    if (this != &that) {
+      Unmap();
+      data_ = std::exchange(that.data_, nullptr);
+      size_ = std::exchange(that.size_, 0);
+    }
+    return *this;
+  }
+
+  ~MappedFile() { Unmap(); }
+
+  [[nodiscard]] auto Data() const -> const char * { return data_; }
+  [[nodiscard]] auto Size() const -> size_t { return size_; }
+
+ private:
+  void Unmap() {
+    if (data_ != nullptr) {
+      munmap(const_cast<char *>(data_), size_);
+      data_ = nullptr;
+      size_ = 0;
+    }
+  }
+
+  const char *data_{nullptr};
+  size_t size_{0};
+};
+
+} // namespace distribution_lsh
@@ -0,0 +1,253 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/include/common/work_stealing_pool.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>               // NOLINT
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace distribution_lsh {
+
+/**
+ * Pool of worker threads, each with its own deque of tasks.
+ * A worker runs the newest task of its own deque first and steals the oldest task of another deque when its own is
+ * empty. Tasks submitted by a worker go to its own deque, tasks submitted by other threads are spread over the deques.
+ */
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(size_t thread_count = std::max(1U, std::thread::hardware_concurrency())) {
+    for (size_t i = 0; i < thread_count; ++i) {
+      workers_.emplace_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < thread_count; ++i) {
+      threads_.emplace_back([this, i]() { Run(i); });
+    }
+  }
+
+  WorkStealingPool(const WorkStealingPool &) = delete;
+  auto operator=(const WorkStealingPool &) -> WorkStealingPool & = delete;
+
+  /** Tasks still queued are run before the workers stop */
+  ~WorkStealingPool() {
+    {
+      std::scoped_lock<std::mutex> lock(sleep_latch_);
+      is_stopped_ = true;
+    }
+    sleep_cv_.notify_all();
+    for (auto &thread : threads_) {
+      thread.join();
+    }
+  }
+
+  /**
+   * Pool shared by the build, ingest and query stages, so that the threads of the process are not oversubscribed by
+   * one team of threads per stage. It is created on first use with a worker per hardware thread.
+   */
+  static auto GetInstance() -> WorkStealingPool & {
+    static WorkStealingPool pool;
+    return pool;
+  }
+
+  [[nodiscard]] auto GetThreadCount() const -> size_t { return workers_.size(); }
+
+  /** Queue a task, it must not throw */
+  void Submit(std::function<void()> task) {
+    auto index = current_pool_ == this ? current_index_ : next_worker_.fetch_add(1) % workers_.size();
+    {
+      std::scoped_lock<std::mutex> lock(workers_[index]->latch_);
+      workers_[index]->tasks_.emplace_back(std::move(task));
+    }
+    {
+      std::scoped_lock<std::mutex> lock(sleep_latch_);
+      ++pending_;
+    }
+    sleep_cv_.notify_one();
+  }
+
+ private:
+  struct Worker {
+    std::mutex latch_;
+    std::deque<std::function<void()>> tasks_;
+  };
+
+  void Run(size_t index) {
+    current_pool_ = this;
+    current_index_ = index;
+    std::function<void()> task;
+    while (true) {
+      if (Pop(index, &task)) {
+        task();
+        continue;
+      }
+
+      std::unique_lock<std::mutex> lock(sleep_latch_);
+      sleep_cv_.wait(lock, [&]() { return is_stopped_ || pending_ > 0; });
+      if (is_stopped_ && pending_ == 0) {
+        return;
+      }
+    }
+  }
+
+  /** Take the newest task of the own deque, or steal the oldest task of another one */
+  auto Pop(size_t index, std::function<void()> *task) -> bool {
+    for (size_t i = 0; i < workers_.size(); ++i) {
+      auto &worker = *workers_[(index + i) % workers_.size()];
+      std::scoped_lock<std::mutex> lock(worker.latch_);
+      if (worker.tasks_.empty()) {
+        continue;
+      }
+      if (i == 0) {
+        *task = std::move(worker.tasks_.back());
+        worker.tasks_.pop_back();
+      } else {
+        *task = std::move(worker.tasks_.front());
+        worker.tasks_.pop_front();
+      }
+      std::scoped_lock<std::mutex> sleep_lock(sleep_latch_);
+      --pending_;
+      return true;
+    }
+    return false;
+  }
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::vector<std::thread> threads_;
+  std::atomic<size_t> next_worker_{0};
+  /** Number of queued tasks, guarded by the sleep latch */
+  int64_t pending_{0};
+  bool is_stopped_{false};
+  std::mutex sleep_latch_;
+  std::condition_variable sleep_cv_;
+
+  /** Pool and deque of the worker running on this thread */
+  static inline thread_local WorkStealingPool *current_pool_{nullptr};
+  static inline thread_local size_t current_index_{0};
+};
+
+/**
+ * Tasks run on a pool and waited for together. The waiting thread runs the tasks of the group not started yet, never
+ * tasks of other groups, as it may hold latches those tasks take. It then blocks until the started ones finish. A
+ * group can be waited for inside a task of the same pool, since every task it waits for is running on some thread.
+ * The first exception thrown by a task is thrown by Wait.
+ */
+class TaskGroup {
+ public:
+  explicit TaskGroup(WorkStealingPool *pool) : pool_(pool), state_(std::make_shared<State>()) {}
+
+  TaskGroup(const TaskGroup &) = delete;
+  auto operator=(const TaskGroup &) -> TaskGroup & = delete;
+
+  ~TaskGroup() {
+    try {
+      Wait();
+    } catch (...) {
+    }
+  }
+
+  void Run(std::function<void()> task) {
+    state_->pending_.fetch_add(1);
+    {
+      std::scoped_lock<std::mutex> lock(state_->latch_);
+      state_->tasks_.emplace_back(std::move(task));
+    }
+    // The pool runs whichever task of the group is left, the waiting thread may have run this one already
+    pool_->Submit([state = state_]() { RunOne(state.get()); });
+  }
+
+  void Wait() {
+    while (RunOne(state_.get())) {
+    }
+    for (auto pending = state_->pending_.load(); pending > 0; pending = state_->pending_.load()) {
+      state_->pending_.wait(pending);
+    }
+
+    std::scoped_lock<std::mutex> lock(state_->latch_);
+    if (state_->exception_ != nullptr) {
+      std::rethrow_exception(std::exchange(state_->exception_, nullptr));
+    }
+  }
+
+ private:
+  /** Shared with the tasks submitted to the pool, which may outlive the group once it has nothing left to run */
+  struct State {
+    std::mutex latch_;
+    std::deque<std::function<void()>> tasks_;    // tasks not started yet, guarded by the latch
+    std::exception_ptr exception_{nullptr};      // guarded by the latch
+    std::atomic<int64_t> pending_{0};            // tasks not finished yet
+  };
+
+  /**
+   * Run the oldest task of the group not started yet
+   * @return false if every task of the group has started
+   */
+  static auto RunOne(State *state) -> bool {
+    std::function<void()> task;
+    {
+      std::scoped_lock<std::mutex> lock(state->latch_);
+      if (state->tasks_.empty()) {
+        return false;
+      }
+      task = std::move(state->tasks_.front());
+      state->tasks_.pop_front();
+    }
+
+    try {
+      task();
+    } catch (...) {
+      std::scoped_lock<std::mutex> lock(state->latch_);
+      if (state->exception_ == nullptr) {
+        state->exception_ = std::current_exception();
+      }
+    }
+    if (state->pending_.fetch_sub(1) == 1) {
+      state->pending_.notify_all();
+    }
+    return true;
+  }
+
+  WorkStealingPool *pool_;
+  std::shared_ptr<State> state_;
+};
+
+/**
+ * Run body(begin, end) over the ranges of [first, last) on a pool, a range holds grain size indexes at least and a
+ * worker gets a few ranges so that stealing balances uneven ranges. The calling thread runs the first range itself,
+ * and a single range runs without any task. The first exception thrown by the body is thrown once all ranges finish.
+ */
+template<typename Index, typename Body>
+void ParallelFor(WorkStealingPool *pool, Index first, Index last, Index grain_size, const Body &body) {
+  if (first >= last) {
+    return;
+  }
+
+  auto length = static_cast<int64_t>(last - first);
+  auto range_count = std::min<int64_t>((length + std::max<int64_t>(grain_size, 1) - 1) / std::max<int64_t>(grain_size, 1),
+                                       static_cast<int64_t>(pool->GetThreadCount()) * 4);
+  if (range_count <= 1) {
+    body(first, last);
+    return;
+  }
+
+  auto range_begin = [&](int64_t range) { return static_cast<Index>(first + length * range / range_count); };
+  TaskGroup task_group(pool);
+  for (int64_t range = 1; range < range_count; ++range) {
+    task_group.Run([&body, begin = range_begin(range), end = range_begin(range + 1)]() { body(begin, end); });
+  }
+  body(first, range_begin(1));
+  task_group.Wait();
+}
+
+}// namespace distribution_lsh
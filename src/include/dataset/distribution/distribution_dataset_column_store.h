@@ -0,0 +1,81 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/include/dataset/distribution/distribution_dataset_column_store.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <span>
+#include <string>
+
+#include <common/config.h>
+#include <common/rid.h>
+#include <common/util/mapped_file.h>
+#include <dataset/distribution/distribution_dataset_manager.h>
+
+namespace distribution_lsh {
+
+#define DISTRIBUTION_DATASET_COLUMN_STORE_TYPE DistributionDataSetColumnStore<ValueType>
+#define DISTRIBUTION_DATASET_COLUMN_STORE_MAGIC 0x3130'4C4F'4348'534CUL    // "LSHCOL01"
+#define DISTRIBUTION_DATASET_COLUMN_STORE_ALIGNMENT 64
+
+/**
+ * @brief Column-blocked copy of a set of a distribution dataset, which is read by sequential scans.
+ * The set is cut into blocks of block size vectors, a block keeps its values dimension by dimension
+ * so that projecting a block onto a line reads it from the start to the end.
+ * ----------------------------------------------------------------------------------------------
+ * | MAGIC (8) | DIMENSION (4) | BLOCK_SIZE (4) | SIZE (8) | ... | RIDS (8 * SIZE) | ... | BLOCKS |
+ * ----------------------------------------------------------------------------------------------
+ * Value of dimension d of vector j in block b is at blocks[(b * dimension + d) * block_size + j], the last
+ * block is padded with zeros. RIDs locate the vectors in the dataset pages, in the order of the blocks.
+ * The file is a snapshot, data stored or deleted in the dataset later is not reflected in it.
+ */
+DISTRIBUTION_DATASET_TEMPLATE
+class DistributionDataSetColumnStore {
+ public:
+  /** Open a column store file */
+  explicit DistributionDataSetColumnStore(const std::string &file_name);
+
+  /**
+   * Write the column store of a set
+   * @brief data is read from the dataset pages block by block through GetDistributionDataBatch
+   */
+  static void Build(DistributionDataSetManager<ValueType> *manager,
+                    bool is_training_set,
+                    const std::string &file_name,
+                    int block_size = DISTRIBUTION_DATASET_COLUMN_BLOCK_SIZE);
+
+  [[nodiscard]] auto GetSize() const -> int64_t { return size_; }
+  [[nodiscard]] auto GetDimension() const -> int { return dimension_; }
+  [[nodiscard]] auto GetBlockSize() const -> int { return block_size_; }
+  [[nodiscard]] auto GetBlockCount() const -> int64_t { return (size_ + block_size_ - 1) / block_size_; }
+
+  /** Location of the vector at index in the dataset pages */
+  [[nodiscard]] auto GetRID(int64_t index) const -> RID;
+
+  /**
+   * Values of a block, dimension by dimension
+   * @param[return] rows number of vectors in the block
+   */
+  auto GetBlock(int64_t block_index, int *rows) const -> const ValueType *;
+
+  /**
+   * Project every vector of the set onto the lines
+   * @brief the blocks are scanned once, each block is multiplied with all the lines while it is in cache
+   * @param lines row-major matrix of line_count * dimension
+   * @param[return] projections row-major matrix of size * line_count, row i belongs to GetRID(i)
+   */
+  void Project(const ValueType *lines, int line_count, ValueType *projections) const;
+
+ private:
+  MappedFile file_;
+  int dimension_{0};
+  int block_size_{0};
+  int64_t size_{0};
+  const int64_t *rids_{nullptr};
+  const ValueType *blocks_{nullptr};
+};
+
+} // namespace distribution_lsh
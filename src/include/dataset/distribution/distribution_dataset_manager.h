@@ -7,14 +7,22 @@
 
 #pragma once
 
+#include <algorithm>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <span>
+#include <utility>
+#include <vector>
 
 #include <fmt/color.h>
 #include <fmt/format.h>
 
+#include <common/channel.h>
 #include <common/config.h>
 #include <common/exception.h>
 #include <common/rid.h>
+#include <common/task.h>
 #include <buffer/buffer_pool_manager.h>
 #include <dataset/distribution/distribution_dataset_processor.h>
 #include <storage/page/dataset/distribution_dataset_header_page.h>
@@ -79,6 +87,18 @@ class DistributionDataSetManager {
   auto GetSize(bool is_training_set) -> int;
   auto GetTrainingSetFileID() -> file_id_t { return training_set_file_id_; }
   auto GetTestingSetFileID() -> file_id_t { return testing_set_file_id_; }
+  auto GetSeed() -> uint64_t { return seed_; }
+  auto GetVectorEncoding() -> VectorEncoding { return vector_encoding_; }
+
+  /** Seed of the synthetic data set, the same seed generates the same data set. It is kept in the header pages. */
+  void SetSeed(uint64_t seed);
+
+  /**
+   * Set the encoding of the data pages, only allowed before any data is stored
+   * @param data_page_max_size values per data page, 0 to fill the pages in the encoding
+   * @return false if the data set is not empty
+   */
+  auto SetVectorEncoding(VectorEncoding vector_encoding, int data_page_max_size = 0) -> bool;
 
 
   /** Get single distribution data
@@ -86,6 +106,14 @@ class DistributionDataSetManager {
    * */
   auto GetDistributionData(bool is_training_set, page_id_t directory_page_id, int index) -> std::shared_ptr<ValueType[]>;
 
+  /**
+   * Get single distribution data in a coroutine, page misses suspend it instead of blocking the thread
+   * @brief get data by directory page id and its logical slot, nullptr if the slot is empty
+   */
+  auto GetDistributionDataAsync(bool is_training_set,
+                                page_id_t directory_page_id,
+                                int index) -> Task<std::shared_ptr<ValueType[]>>;
+
   /**3
    * @param is_training_set set type
    * @param index total index of the data
@@ -93,6 +121,44 @@ class DistributionDataSetManager {
    */
   auto GetDistributionData(bool is_training_set, int index, page_id_t *directory_page_id, int *slot) -> std::shared_ptr<ValueType[]>;
 
+  /**
+   * Get a batch of distribution data located by RIDs (directory page id, logical slot)
+   * @brief RIDs are grouped by directory page so that each directory page is fetched once, and the data pages of
+   * one group are visited in page id order. Data is copied straight into the caller provided matrix.
+   * @param rids locations of the data
+   * @param[return] distribution_data row-major matrix of rids.size() * dimension, row i holds the data of rids[i]
+   * @param[return] is_found optional flags, is_found[i] is false if rids[i] is an empty slot
+   * @return number of data found
+   */
+  auto GetDistributionDataBatch(bool is_training_set,
+                                std::span<const RID> rids,
+                                ValueType *distribution_data,
+                                std::vector<bool> *is_found = nullptr) -> int;
+
+  /**
+   * Locations of all the data of a set in global index order
+   * @return RIDs (directory page id, logical slot) of the occupied slots
+   */
+  auto GetRIDs(bool is_training_set) -> std::vector<RID>;
+
+  /**
+   * Stream a single distribution data through the visitor without copying it out of the buffer pool.
+   * Each data page is pinned only while the visitor runs over it.
+   * @param visitor callable invoked as visitor(const ValueType *chunk, int offset, int length) for every data page
+   * @return false if the logical slot is empty
+   */
+  template<typename Visitor>
+  auto VisitDistributionData(bool is_training_set, page_id_t directory_page_id, int index, Visitor &&visitor) -> bool;
+
+  /**
+   * Lp distance between the query and the data located by directory page id and logical slot
+   * @param query query vector with the dimension of the data set
+   * @param p order of the distance, p in (0, 2]
+   * @param[return] distance result distance
+   * @return false if the logical slot is empty
+   */
+  auto Distance(bool is_training_set, page_id_t directory_page_id, int index, const ValueType *query, float p, float *distance) -> bool;
+
   /**
    * @param is_training_set set type
    * @param directory_page_id directory page id
@@ -107,7 +173,62 @@ class DistributionDataSetManager {
   /** Store a distribution data into page */
   auto Store(bool is_training_set, ValueType *distribution, DistributionDataSetContext *ctx = nullptr) -> RID;
 
+  /**
+   * Store a batch of distribution data
+   * @brief the header page and the tail directory page are latched once for the whole batch, data is appended
+   * through a cursor on the tail directory page. Data stored before a failure stays stored.
+   * @param distribution row-major matrix of size * dimension
+   * @return RIDs of the data in input order
+   */
+  auto StoreBatch(bool is_training_set,
+                  const ValueType *distribution,
+                  int size,
+                  DistributionDataSetContext *ctx = nullptr) -> std::vector<RID>;
+
  private:
+  /** Header page of a set, taken from the context if it is latched there, otherwise latched into dataset_ctx */
+  auto FetchHeaderPageWrite(bool is_training_set,
+                            DistributionDataSetContext *ctx,
+                            DistributionDataSetContext *dataset_ctx) -> DistributionDataSetHeaderPage *;
+
+  /** Allocate a directory page behind the full tail directory page */
+  auto AppendDirectoryPage(BufferPoolManager *bpm,
+                           DistributionDataSetDirectoryPage *directory_page,
+                           std::vector<page_id_t> *directory_page_ids) -> WritePageGuard;
+
+  /** Write a distribution data into a new chain of data pages and return its start page id */
+  auto StoreDataPages(BufferPoolManager *bpm, const ValueType *distribution) -> page_id_t;
+
+  /** Rebuild the in-memory directory index of a set from its directory chain */
+  void BuildDirectoryIndex(bool is_training_set);
+
+  /** Count the data of a set in a legacy file, written before the header page kept the size, and bring its header up */
+  void UpgradeLegacyHeaderPage(bool is_training_set);
+
+  /**
+   * Producer of a data set, fills chunk with the rows [start_row, start_row + size) of the set
+   * @return number of rows produced, less than size at the end of the data
+   */
+  using DataProducer = std::function<int(ValueType *chunk, int64_t start_row, int size)>;
+
+  /** Producer of the synthetic data set defined by the seed */
+  auto GenerationProducer(uint64_t seed) -> DataProducer;
+
+  /** Producer reading the raw files of a real world data set from the first row */
+  auto RawDataSetProducer(bool is_training_set) -> DataProducer;
+
+  /**
+   * Stream a set into pages, the producer runs on its own thread and fills bounded chunks while
+   * this thread stores the previous ones
+   */
+  void IngestAndStore(bool is_training_set, int size, const DataProducer &producer, DistributionDataSetContext *ctx);
+
+  /**
+   * Visit the data pages chained from the start data page one by one, encoded pages are decoded on the fly
+   * @param decoded buffer the encoded pages are decoded into, grown on the first encoded page and reused by the caller
+   */
+  template<typename Visitor>
+  void VisitDataPages(BufferPoolManager *bpm, page_id_t data_page_id, std::vector<ValueType> *decoded, Visitor &&visitor);
 
   std::string manager_name_;
   DataSetType data_set_type_;
@@ -125,9 +246,82 @@ class DistributionDataSetManager {
   std::string directory_name_;
   int directory_page_max_size_;
   int data_page_max_size_;
+  VectorEncoding vector_encoding_{VectorEncoding::FLOAT32};
 
   file_id_t training_set_file_id_;
   file_id_t testing_set_file_id_;
+  uint64_t seed_;
+
+  /**
+   * Directory page ids in chain order, so that a global index is located by index / directory_page_max_size_
+   * without walking the chain. Guarded by the latch of the header page.
+   */
+  std::vector<page_id_t> training_set_directory_page_ids_;
+  std::vector<page_id_t> testing_set_directory_page_ids_;
 };
 
+DISTRIBUTION_DATASET_TEMPLATE
+template<typename Visitor>
+auto DISTRIBUTION_DATASET_MANAGER_TYPE::VisitDistributionData(bool is_training_set,
+                                                              page_id_t directory_page_id,
+                                                              int index,
+                                                              Visitor &&visitor) -> bool {
+  auto bpm = is_training_set ? training_set_bpm_.get() : testing_set_bpm_.get();
+
+  // Keep the directory page latched so that the slot can not be deleted while visiting
+  auto directory_page_guard = bpm->FetchPageRead(directory_page_id);
+  auto data_set_page = directory_page_guard.template As<DistributionDataSetPage>();
+  if (!data_set_page->IsDirectoryPage()) {
+    throw Exception("The input page is not a directory page");
+  }
+
+  auto directory_page = reinterpret_cast<const DistributionDataSetDirectoryPage *>(data_set_page);
+  auto data_page_id = directory_page->IndexAt(index);
+  if (data_page_id == INVALID_PAGE_ID) {
+    LOG_DEBUG("Invalid index page");
+    return false;
+  }
+
+  // Reused by all the visits of a thread, the visitor does not visit other data
+  thread_local std::vector<ValueType> decoded;
+  VisitDataPages(bpm, data_page_id, &decoded, std::forward<Visitor>(visitor));
+  return true;
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+template<typename Visitor>
+void DISTRIBUTION_DATASET_MANAGER_TYPE::VisitDataPages(BufferPoolManager *bpm,
+                                                       page_id_t data_page_id,
+                                                       std::vector<ValueType> *decoded,
+                                                       Visitor &&visitor) {
+  auto data_page_guard = bpm->FetchPageRead(data_page_id);
+  const DataPage *data_page = data_page_guard.template As<DataPage>();
+
+  // Pages of the chain are decoded one at a time into the buffer, float pages are visited in place
+  if (vector_encoding_ != VectorEncoding::FLOAT32 && decoded->size() < DISTRIBUTION_LSH_PAGE_SIZE) {
+    decoded->resize(DISTRIBUTION_LSH_PAGE_SIZE);
+  }
+
+  auto current_size = 0;
+  while (current_size < this->dimension_) {
+    auto length = std::min(this->dimension_ - current_size, data_page->GetSize());
+    if (length <= 0) {
+      throw Exception("The data page is empty");
+    }
+    visitor(data_page->Decode(vector_encoding_, decoded->data()), current_size, length);
+    current_size += length;
+
+    if (current_size < this->dimension_) {
+      auto next_page_id = data_page->next_page_id_;
+      if (next_page_id == INVALID_PAGE_ID) {
+        throw Exception("The data page is not a linked list");
+      }
+
+      data_page_guard.Drop();
+      data_page_guard = bpm->FetchPageRead(next_page_id);
+      data_page = data_page_guard.template As<DataPage>();
+    }
+  }
+}
+
 } // namespace distribution_lsh
\ No newline at end of file
@@ -36,6 +36,10 @@ class DistributionDataSetMonitor : public Monitor {
   /**
   * Constructor.
   * @param directory_name The directory name of the distribution dataset.
+  * @param pool_size number of frames of the private pool of each file, used only when the files share no pool
+  * @param shared_pool_size number of frames of the pool shared by all the files of the monitor, 0 gives each file
+  * a private pool of pool_size frames as before the pools were shared
+  * @param buffer_pool buffer pool shared with other monitors, a pool of shared_pool_size frames is created if nullptr
   */
   explicit DistributionDataSetMonitor(
       std::string raw_data_directory_name,
@@ -44,8 +48,10 @@ class DistributionDataSetMonitor : public Monitor {
       std::string relation_directory_name,
       int k = 16,
       int pool_size = 50,
+      int shared_pool_size = MONITOR_SHARED_POOL_SIZE,
       int directory_page_max_size = DISTRIBUTION_DATASET_DIRECTORY_PAGE_SIZE,
-      int data_page_max_size = DISTRIBUTION_DATASET_DATA_PAGE_SIZE);
+      int data_page_max_size = DISTRIBUTION_DATASET_DATA_PAGE_SIZE,
+      std::shared_ptr<BufferPool> buffer_pool = nullptr);
 
   virtual ~DistributionDataSetMonitor() = default;
 
@@ -76,6 +82,15 @@ class DistributionDataSetMonitor : public Monitor {
    */
   auto GetDistributionData(int manager_index, bool is_training_set, page_id_t directory_page_id, int index) -> std::shared_ptr<ValueType[]>;
 
+  /**
+   * Get specific data by directory page id and index in a coroutine, the manager must not be removed before it ends
+   * @return nullptr if the manager or the data does not exist
+   */
+  auto GetDistributionDataAsync(int manager_index,
+                                bool is_training_set,
+                                page_id_t directory_page_id,
+                                int index) -> Task<std::shared_ptr<ValueType[]>>;
+
 
   /**
    * Get specific data by global index
@@ -91,6 +106,36 @@ class DistributionDataSetMonitor : public Monitor {
                            page_id_t *directory_page_id,
                            int *slot) -> std::shared_ptr<ValueType[]>;
 
+  /**
+   * Get a batch of data located by RIDs into a caller provided row-major matrix
+   * @param manager_index distribution dataset manager index
+   * @param rids locations of the data
+   * @param[return] distribution_data matrix of rids.size() * dimension
+   * @param[return] is_found optional flags of the found data
+   * @return number of data found, -1 if the manager does not exist
+   */
+  auto GetDistributionDataBatch(int manager_index,
+                                bool is_training_set,
+                                std::span<const RID> rids,
+                                ValueType *distribution_data,
+                                std::vector<bool> *is_found = nullptr) -> int;
+
+  /**
+   * Lp distance between the query and a data, computed over the pinned data pages without copying the data
+   * @param manager_index distribution dataset manager index
+   * @param query query vector
+   * @param p order of the distance
+   * @param[return] distance result distance
+   * @return false if the manager or the data does not exist
+   */
+  auto Distance(int manager_index,
+                bool is_training_set,
+                page_id_t directory_page_id,
+                int index,
+                const ValueType *query,
+                float p,
+                float *distance) -> bool;
+
   /**
    * Delete a data in dataset
    * @param manager_index  distribution dataset manager index
@@ -123,6 +168,7 @@ class DistributionDataSetMonitor : public Monitor {
   std::string relation_directory_name_;
   int k_;
   int pool_size_;
+  std::shared_ptr<BufferPool> buffer_pool_;    // shared by all the files if not nullptr
   int directory_page_max_size_;
   int data_page_max_size_;
   std::mutex latch_;
@@ -12,6 +12,8 @@
 #include <memory>
 
 #include <common/config.h>
+#include <common/work_stealing_pool.h>
+#include <dataset/distribution/raw_dataset_reader.h>
 #include <storage/page/dataset/distribution_dataset_header_page.h>
 #include <storage/page/dataset/distribution_dataset_data_page.h>
 
@@ -35,10 +37,37 @@ class DistributionDatasetProcessor {
                                      NormalizationType normalization_type = NormalizationType::SOFTMAX,
                                      float *param = nullptr) -> std::unique_ptr<ValueType[]>;
 
+  /**
+   * Generate rows [start_row, start_row + size) of the synthetic data set defined by the seed
+   * @brief every value is derived from (seed, element index) by a counter-based generator, so the data set is
+   * reproducible whatever the chunking or the number of threads. Rows are generated and normalized in parallel.
+   * @param[return] distribution_dataset output buffer of size * dimension
+   * @param pool pool the rows are generated on
+   */
+  void GenerationDistributionDataset(ValueType *distribution_dataset,
+                                     int dimension,
+                                     int64_t start_row,
+                                     int size,
+                                     DistributionType distribution_type,
+                                     NormalizationType normalization_type,
+                                     const float *param,
+                                     uint64_t seed,
+                                     WorkStealingPool *pool = &WorkStealingPool::GetInstance());
+
   auto MNISTDistributionDataset(int size,
                                 const std::string& directory_name_,
                                 NormalizationType normalization_type = NormalizationType::SOFTMAX) -> std::unique_ptr<ValueType[]>;
 
+  /**
+   * Read and normalize the next rows of a raw data set
+   * @param[return] distribution_dataset output buffer of size * dimension of the data set
+   * @return number of rows read, less than size at the end of the data set
+   */
+  auto ReadDistributionDataset(RawDataSetReader<ValueType> *reader,
+                               ValueType *distribution_dataset,
+                               int size,
+                               NormalizationType normalization_type) -> int;
+
   auto CIFAR10DistributionDataset(int size,
                                   std::string directory_name_,
                                   NormalizationType normalization_type = NormalizationType::SOFTMAX) -> std::unique_ptr<ValueType[]>;
@@ -0,0 +1,109 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/10.
+// src/include/dataset/distribution/raw_dataset_reader.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <common/config.h>
+#include <common/util/mapped_file.h>
+#include <storage/page/dataset/distribution_dataset_header_page.h>
+#include <storage/page/dataset/distribution_dataset_data_page.h>
+
+namespace distribution_lsh {
+
+static constexpr int MNIST_DIMENSION = 28 * 28;
+static constexpr int CIFAR10_DIMENSION = 32 * 32 * 3;
+
+/**
+ * @brief Sequential reader of the raw files of a real world data set.
+ * Rows are read chunk by chunk so that the data set never needs to be materialized as a whole.
+ */
+DISTRIBUTION_DATASET_TEMPLATE
+class RawDataSetReader {
+ public:
+  virtual ~RawDataSetReader() = default;
+
+  /**
+   * Read the next rows of the data set
+   * @param[return] distribution_dataset output buffer of size * dimension
+   * @return number of rows read, less than size at the end of the data set
+   */
+  virtual auto Read(ValueType *distribution_dataset, int size) -> int = 0;
+
+  [[nodiscard]] virtual auto GetDimension() const -> int = 0;
+};
+
+/**
+ * @brief MNIST in csv form, a title line then one "label,pixel,...,pixel" line per image.
+ * Lines of a chunk are located first and parsed in parallel, pixels take an integer fast path.
+ */
+DISTRIBUTION_DATASET_TEMPLATE
+class MNISTCsvReader : public RawDataSetReader<ValueType> {
+ public:
+  explicit MNISTCsvReader(const std::string &file_name);
+
+  auto Read(ValueType *distribution_dataset, int size) -> int override;
+
+  [[nodiscard]] auto GetDimension() const -> int override { return MNIST_DIMENSION; }
+
+ private:
+  MappedFile file_;
+  size_t position_{0};    // start of the next line
+};
+
+/**
+ * @brief MNIST in its native IDX form (idx3-ubyte), a big-endian header then one byte per pixel
+ */
+DISTRIBUTION_DATASET_TEMPLATE
+class MNISTIdxReader : public RawDataSetReader<ValueType> {
+ public:
+  explicit MNISTIdxReader(const std::string &file_name);
+
+  auto Read(ValueType *distribution_dataset, int size) -> int override;
+
+  [[nodiscard]] auto GetDimension() const -> int override { return MNIST_DIMENSION; }
+
+ private:
+  MappedFile file_;
+  int size_{0};
+  int current_row_{0};
+};
+
+/**
+ * @brief CIFAR-10 binary batches, records of one label byte followed by 3072 pixel bytes (R, G, B planes).
+ * Batches are read one after another.
+ */
+DISTRIBUTION_DATASET_TEMPLATE
+class CIFAR10BinaryReader : public RawDataSetReader<ValueType> {
+ public:
+  explicit CIFAR10BinaryReader(std::vector<std::string> batch_file_names);
+
+  auto Read(ValueType *distribution_dataset, int size) -> int override;
+
+  [[nodiscard]] auto GetDimension() const -> int override { return CIFAR10_DIMENSION; }
+
+ private:
+  std::vector<std::string> batch_file_names_;
+  size_t next_batch_{0};
+  MappedFile file_;
+  size_t position_{0};
+};
+
+/**
+ * Open the reader of a raw data set
+ * @brief MNIST is read from the IDX files if they exist in the directory, otherwise from the csv files.
+ * CIFAR-10 training set is data_batch_1.bin ~ data_batch_5.bin, testing set is test_batch.bin.
+ */
+DISTRIBUTION_DATASET_TEMPLATE
+auto OpenRawDataSetReader(DataSetType data_set_type,
+                          const std::string &directory_name,
+                          bool is_training_set) -> std::unique_ptr<RawDataSetReader<ValueType>>;
+
+} // namespace distribution_lsh
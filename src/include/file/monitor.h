@@ -8,6 +8,7 @@
 #pragma once
 
 #include <map>
+#include <memory>
 #include <filesystem>
 #include <random>
 #include <mutex>
@@ -52,5 +53,20 @@ class Monitor {
   static auto GetNextPageId(DiskManager *manager, const std::string &file_name) -> page_id_t {
     return manager->GetFileSize(file_name) %  DISTRIBUTION_LSH_PAGE_SIZE == 0 ?  manager->GetFileSize(file_name) /  DISTRIBUTION_LSH_PAGE_SIZE : manager->GetFileSize(file_name) / DISTRIBUTION_LSH_PAGE_SIZE + 1;
   }
+
+  /**
+   * Create the buffer pool manager of a file
+   * @param buffer_pool buffer pool shared by all the files, nullptr to give the file its own pool of pool_size frames
+   */
+  static auto CreateBufferPoolManager(const std::shared_ptr<BufferPool> &buffer_pool,
+                                      int pool_size,
+                                      int k,
+                                      std::shared_ptr<DiskManager> disk_manager,
+                                      page_id_t next_page_id = HEADER_PAGE_ID) -> std::shared_ptr<BufferPoolManager> {
+    if (buffer_pool != nullptr) {
+      return std::make_shared<BufferPoolManager>(buffer_pool, std::move(disk_manager), nullptr, next_page_id);
+    }
+    return std::make_shared<BufferPoolManager>(pool_size, std::move(disk_manager), k, nullptr, next_page_id);
+  }
 };
 } // namespace distribution_lsh
@@ -12,12 +12,16 @@
 #include <map>
 #include <unordered_map>
 #include <mutex>
+#include <optional>
 #include <tuple>
 #include <utility>
 
 #include <common/util/file.h>
 #include <storage/index/random_line_manager.h>
 #include <storage/index/b_plus_tree.h>
+#include <storage/index/multi_probe.h>
+#include <storage/index/packed_projection_index.h>
+#include <storage/index/projection_column.h>
 #include <file/monitor.h>
 #include <storage/page/relation/relation_header_page.h>
 #include <storage/index/relation_manager.h>
@@ -40,16 +44,24 @@ class RandomLineMonitor : public Monitor {
   using BPlusTreeKeyType = ValueType;
   using BPlusTreeValueType = RID;
  public:
+  /**
+   * @param pool_size number of frames of the private pool of each file, used only when the files share no pool
+   * @param shared_pool_size number of frames of the pool shared by all the files of the monitor, 0 gives each file
+   * a private pool of pool_size frames as before the pools were shared
+   * @param buffer_pool buffer pool shared with other monitors, a pool of shared_pool_size frames is created if nullptr
+   */
     explicit RandomLineMonitor(
       std::string b_plus_tree_directory_name,
       std::string random_line_directory_name,
       std::string relation_directory_name,
       int k = 16,
       int pool_size = 50,
+      int shared_pool_size = MONITOR_SHARED_POOL_SIZE,
       int b_plus_tree_internal_max_size = GetInternalPageSize<BPlusTreeKeyType, BPlusTreeValueType>(),
       int b_plus_tree_leaf_max_size = GetLeafPageSize<BPlusTreeKeyType, BPlusTreeValueType>(),
       int random_line_directory_page_max_size = GetRandomLineDirectoryPageSize(),
-      int random_line_data_page_max_size = GetRandomLineDataPageSize<RandomLineValueType>());
+      int random_line_data_page_max_size = GetRandomLineDataPageSize<RandomLineValueType>(),
+      std::shared_ptr<BufferPool> buffer_pool = nullptr);
 
   virtual ~RandomLineMonitor() = default;
 
@@ -62,6 +74,9 @@ class RandomLineMonitor : public Monitor {
    * @param epsilon random line group epsilon, greater than 0 is valid
    * @param random_line_size random line group size
    * @param training_set_file_id training set file id corresponding to the data
+   * @param seed draw the group from the reproducible stream of the seed, epsilon is then ignored. Only the seed is
+   * persisted and the lines are regenerated when the group is loaded again. A training set has one seed-defined group
+   * per distribution and normalization type, an existing one keeps its own seed.
    * @return
    */
   auto RandomProjection(
@@ -72,7 +87,8 @@ class RandomLineMonitor : public Monitor {
       RandomLineNormalizationType normalization_type,
       float epsilon,
       int random_line_size,
-      file_id_t training_set_file_id) -> std::shared_ptr<std::vector<std::vector<std::pair<file_id_t, RID>>>>;
+      file_id_t training_set_file_id,
+      std::optional<uint64_t> seed = std::nullopt) -> std::shared_ptr<std::vector<std::vector<std::pair<file_id_t, RID>>>>;
 
 #ifdef BY_PASS_ACCESS_RANDOM_LINE_MANAGER
   /**
@@ -91,19 +107,102 @@ class RandomLineMonitor : public Monitor {
        RID random_line_rid,
          std::shared_ptr<RandomLineValueType[] > query,
        int radius) ->std::shared_ptr<std::vector<RID>>;
+
+  /**
+   * Multi-probe query over several random lines of a group
+   * @brief projections are cut into buckets of width 2 * radius, the home bucket of the query on every line is read,
+   * then probe count neighbouring buckets of all the lines in decreasing collision probability of a near neighbor.
+   * Fewer random lines reach the recall of single probing with more of them.
+   * @param random_line_rids random lines to probe, each with its B+ tree
+   * @param probe_count number of neighbouring buckets read after the home buckets
+   * @return (random line rid, data rid) of the data in the probed buckets, a data is given once per random line
+   */
+  auto GetMultiProbeConstituencyPoints(
+      file_id_t random_line_file_id,
+      const std::vector<RID> &random_line_rids,
+      std::shared_ptr<RandomLineValueType[]> query,
+      int radius,
+      int probe_count) -> std::shared_ptr<std::vector<std::pair<RID, RID>>>;
 #endif
 
-  
+  /**
+   * Projection values of a random line in insertion order, read from its projection column file
+   * @brief the column is written along with the B+ tree of the random line, so that the tree can be rebuilt,
+   * or the projections be analyzed, by one sequential scan
+   * @return nullptr if the random line has no B+ tree or no projection column file
+   */
+  auto GetProjectionColumn(file_id_t random_line_file_id,
+                           RID random_line_rid) -> std::unique_ptr<ProjectionColumnReader<RandomLineValueType>>;
+
+  /**
+   * Pack the projection columns of all the random lines of a group into one sorted-array index file
+   * @brief the index is immutable, it is meant for serving a group whose building is finished. The file is
+   * kept in the B+ tree directory and loaded by later monitors, which open the B+ trees of the lines it holds only
+   * on demand. A later insert into the group drops the index and removes its file. A line whose column misses records
+   * of its B+ tree, or has no column, is packed from a scan of the leaves of the tree.
+   * @return the packed index, nullptr if the group has no random line with a B+ tree
+   */
+  auto BuildPackedIndex(file_id_t random_line_file_id) -> std::shared_ptr<PackedProjectionIndex<RandomLineValueType>>;
+
+  /** Packed index of a group, nullptr if it has not been built */
+  auto GetPackedIndex(file_id_t random_line_file_id) -> std::shared_ptr<PackedProjectionIndex<RandomLineValueType>>;
+
+  /**
+   * Data whose projection onto a random line lies in [lkey, rkey], read from the packed index of the group if it
+   * holds the line, otherwise from the B+ tree of the line
+   * @return false if the random line has no B+ tree
+   */
+  auto RangeRead(file_id_t random_line_file_id,
+                 RID random_line_rid,
+                 RandomLineValueType lkey,
+                 RandomLineValueType rkey,
+                 std::vector<RID> *result) -> bool;
+
+  /**
+   * RangeRead in a coroutine, misses on the B+ tree pages suspend it instead of blocking, result must outlive the task.
+   * The B+ trees of the monitor are only inserted into, which the read of the tree allows alongside.
+   * @return false if the random line has no B+ tree
+   */
+  auto RangeReadAsync(file_id_t random_line_file_id,
+                      RID random_line_rid,
+                      RandomLineValueType lkey,
+                      RandomLineValueType rkey,
+                      std::vector<RID> *result) -> Task<bool>;
+
   void List() override;
 
  private:
+  /** Projection column file lives next to the B+ tree file and shares its file id */
+  auto GetProjectionColumnFileName(file_id_t b_plus_tree_file_id) -> std::string;
+
+  /** Packed index file lives in the B+ tree directory and is named after the random line file of its group */
+  auto GetPackedIndexFileName(file_id_t random_line_file_id) -> std::string;
 
+  /** Open the B+ tree file of a random line and register its tree, latch_ must be held */
+  auto OpenBPlusTree(file_id_t random_line_file_id,
+                     RID random_line_rid,
+                     file_id_t b_plus_tree_file_id) -> std::shared_ptr<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>>;
+
+  /**
+   * B+ tree of a random line, opened here if its loading was deferred to the packed index, latch_ must be held
+   * @return nullptr if the random line has no B+ tree
+   */
+  auto GetBPlusTree(file_id_t random_line_file_id,
+                    RID random_line_rid) -> std::shared_ptr<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>>;
+
+  /**
+   * Projection column writer of a random line, opened here on the first insert into the line, latch_ must be held
+   * @return nullptr if the random line has no B+ tree
+   */
+  auto GetProjectionColumnWriter(file_id_t random_line_file_id,
+                                 RID random_line_rid) -> std::shared_ptr<ProjectionColumnWriter<RandomLineValueType>>;
 
   std::string b_plus_tree_directory_name_;
   std::string random_line_directory_name_;
   std::string relation_directory_name_;
   int k_;
   int pool_size_;
+  std::shared_ptr<BufferPool> buffer_pool_;    // shared by all the files if not nullptr
   int b_plus_tree_internal_max_size_;
   int b_plus_tree_leaf_max_size_;
   int random_line_directory_page_max_size_;
@@ -114,6 +213,11 @@ class RandomLineMonitor : public Monitor {
   std::map<file_id_t, std::shared_ptr<BufferPoolManager>> random_line_bpms_;
   std::map<file_id_t, std::shared_ptr<RelationManager<RandomLineFileToBPlusTreeFileUnion>>> relation_managers_;
   std::map<std::pair<file_id_t /* random  line file id*/, RID>, std::shared_ptr<BPlusTree<BPlusTreeKeyType, BPlusTreeValueType>>> b_plus_trees_;
+  // B+ tree file of every random line with a tree, whether the tree is opened or not
+  std::map<std::pair<file_id_t /* random  line file id*/, RID>, file_id_t /* b plus tree file id*/> b_plus_tree_file_ids_;
+  // Projection column writers, opened by the first insert into a random line
+  std::map<std::pair<file_id_t /* random  line file id*/, RID>, std::shared_ptr<ProjectionColumnWriter<RandomLineValueType>>> projection_columns_;
+  std::map<file_id_t /* random line file id*/, std::shared_ptr<PackedProjectionIndex<RandomLineValueType>>> packed_indexes_;
   std::map<std::tuple<file_id_t /* training set file id*/, RandomLineDistributionType, RandomLineNormalizationType, int>, std::shared_ptr<RandomLineManager<RandomLineValueType>>> random_line_managers_;
   std::unordered_map<file_id_t /* random line manager file id*/,  std::shared_ptr<RandomLineManager<RandomLineValueType>>> by_pass_random_line_managers_;
 };
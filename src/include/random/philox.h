@@ -0,0 +1,73 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/8.
+// src/include/random/philox.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+
+namespace distribution_lsh {
+
+/**
+ * @brief Counter-based random generator (Philox4x32-10, Salmon et al. SC'11).
+ *
+ * A block of four 32-bit random words is a pure function of (key, counter), so any element of a random stream can be
+ * computed independently. Data generated in parallel is therefore identical whatever the chunking or thread count.
+ */
+class Philox4x32 {
+ public:
+  using Block = std::array<uint32_t, 4>;
+
+  explicit Philox4x32(uint64_t seed) : key_{static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32)} {}
+
+  /** Random block at position counter of the stream */
+  auto operator()(uint64_t counter, uint64_t stream = 0) const -> Block {
+    Block block{static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32),
+                static_cast<uint32_t>(stream), static_cast<uint32_t>(stream >> 32)};
+    auto key = key_;
+    for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+      auto product0 = static_cast<uint64_t>(PHILOX_M0) * block[0];
+      auto product1 = static_cast<uint64_t>(PHILOX_M1) * block[2];
+      block = {static_cast<uint32_t>(product1 >> 32) ^ block[1] ^ key[0], static_cast<uint32_t>(product1),
+               static_cast<uint32_t>(product0 >> 32) ^ block[3] ^ key[1], static_cast<uint32_t>(product0)};
+      key[0] += PHILOX_W0;
+      key[1] += PHILOX_W1;
+    }
+    return block;
+  }
+
+  /** Map a random word into the open interval (0, 1) */
+  static auto ToUniform(uint32_t word) -> float {
+    return (static_cast<float>(word >> 8) + 0.5F) * (1.0F / 16777216.0F);
+  }
+
+  /** Box-Muller transform of two uniform words into two standard normal values */
+  static void ToGaussian(uint32_t word0, uint32_t word1, float *gaussian0, float *gaussian1) {
+    auto radius = std::sqrt(-2.0F * std::log(ToUniform(word0)));
+    auto theta = 2.0F * std::numbers::pi_v<float> * ToUniform(word1);
+    *gaussian0 = radius * std::cos(theta);
+    *gaussian1 = radius * std::sin(theta);
+  }
+
+  /** Inverse transform of a uniform word into a standard cauchy value */
+  static auto ToCauchy(uint32_t word) -> float {
+    return std::tan(std::numbers::pi_v<float> * (ToUniform(word) - 0.5F));
+  }
+
+ private:
+  static constexpr int PHILOX_ROUNDS = 10;
+  static constexpr uint32_t PHILOX_M0 = 0xD251'1F53U;
+  static constexpr uint32_t PHILOX_M1 = 0xCD9E'8D57U;
+  static constexpr uint32_t PHILOX_W0 = 0x9E37'79B9U;
+  static constexpr uint32_t PHILOX_W1 = 0xBB67'AE85U;
+
+  std::array<uint32_t, 2> key_;
+};
+
+} // namespace distribution_lsh
@@ -7,24 +7,67 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
 #include <common/config.h>
+#include <random/philox.h>
 #include <storage/page/random_line/random_line_header_page.h>
-#include <memory>
 
 namespace distribution_lsh {
 
 /**
  * @brief random line generator which based on gaussian distribution and epsilon
+ * Lines are drawn from a counter-based stream of a seed, line i of the stream is a pure function of (seed, i),
+ * so a generator with the same seed produces the same lines whatever the batch sizes and thread count.
  */
 template<typename RandomLineValueType>
 class RandomLineGenerator {
  public:
+  /** Generator seeded once from the random device */
+  RandomLineGenerator();
+
+  /** Generator of the reproducible stream of a seed */
+  explicit RandomLineGenerator(uint64_t seed);
+
   // Generate a random line based on average_random_line and epsilon
   auto GenerateRandomLine(RandomLineDistributionType distribution_type,
                           RandomLineNormalizationType normalization_type,
                           int dimension) -> std::shared_ptr<RandomLineValueType[]>;
 
+  /**
+   * Generate the next count lines of the stream, lines are generated in parallel
+   * @param[return] lines row-major matrix of count * dimension
+   * @return false if the distribution type or normalization type is not supported
+   */
+  auto GenerateRandomLines(RandomLineDistributionType distribution_type,
+                           RandomLineNormalizationType normalization_type,
+                           int dimension,
+                           int count,
+                           RandomLineValueType *lines) -> bool;
+
   auto Normalization(std::shared_ptr<RandomLineValueType[]> data, RandomLineNormalizationType normalization_type, int dimension) -> std::shared_ptr<RandomLineValueType[]>;
+
+  /** Length of the hadamard transform of a SRHT line, the smallest power of two not below the dimension */
+  static auto GetHadamardDimension(int dimension) -> int;
+
+  /** Row of the hadamard matrix taken by line index of the SRHT stream */
+  [[nodiscard]] auto GetHadamardRow(uint64_t index, int dimension) const -> int;
+
+  /** Random sign at a position, shared by all the SRHT lines of the stream */
+  [[nodiscard]] auto GetHadamardSign(int position) const -> int;
+
+  [[nodiscard]] auto GetSeed() const -> uint64_t { return seed_; }
+
+  /** Index in the stream of the next line to be generated */
+  [[nodiscard]] auto GetNextIndex() const -> uint64_t { return next_index_.load(); }
+  void SetNextIndex(uint64_t index) { next_index_ = index; }
+
+ private:
+  uint64_t seed_;
+  Philox4x32 philox_;
+  std::atomic<uint64_t> next_index_{0};
 };
 } // namespace distribution_lsh
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <functional>
 #include <future> //NOLINT
 #include <optional>
 #include <memory>
@@ -36,6 +37,9 @@ struct DiskRequest {
 
   /** Callback used to signal to the request issuer when the request has been completed. */
   std::promise<bool> callback_;
+
+  /** Called on the background thread after the callback is set, it must not block. Empty if no one is called. */
+  std::function<void(bool)> continuation_{};
 };
 
 /**
@@ -20,6 +20,7 @@
 #include <common/config.h>
 #include <common/macro.h>
 #include <common/rid.h>
+#include <common/task.h>
 #include <buffer/buffer_pool_manager.h>
 #include <storage/page/b_plus_tree/b_plus_tree_page.h>
 #include <storage/page/b_plus_tree/b_plus_tree_leaf_page.h>
@@ -90,6 +91,14 @@ class BPlusTree {
   // Range read for c-ANN
   auto RangeRead(const BPlusTreeKeyType &lkey, const BPlusTreeKeyType &rkey, std::vector<BPlusTreeValueType> *result) -> bool;
 
+  // Read all the entries in key order by one scan of the leaves
+  auto Scan(std::vector<std::pair<BPlusTreeKeyType, BPlusTreeValueType>> *result) -> bool;
+
+  // Range read for c-ANN in a coroutine, page misses suspend it instead of blocking, result must outlive the task.
+  // Pages are not latch-crabbed, as a latch cannot be held across a suspension: inserts may run alongside, but no
+  // Delete may run until the task finishes.
+  auto RangeReadAsync(BPlusTreeKeyType lkey, BPlusTreeKeyType rkey, std::vector<BPlusTreeValueType> *result) -> Task<bool>;
+
   void SubTreeToString(page_id_t page_id, const BPlusTreePage *page, std::stringstream& ss);
 
   auto ToString() -> std::string;
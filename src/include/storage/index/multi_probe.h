@@ -0,0 +1,84 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/include/storage/index/multi_probe.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <queue>
+#include <vector>
+
+#include <common/config.h>
+#include <storage/page/random_line/random_line_header_page.h>
+
+namespace distribution_lsh {
+
+#define MULTI_PROBE_TEMPLATE template<typename ValueType>
+#define MULTI_PROBE_TYPE MultiProbeSequence<ValueType>
+
+/** A projection interval [lkey, rkey) of a random line to be read */
+MULTI_PROBE_TEMPLATE
+struct ProbeInterval {
+  int line_;              // index of the random line in the query
+  int bucket_;            // bucket offset from the bucket of the query, 0 for the home bucket
+  ValueType lkey_;
+  ValueType rkey_;
+  float probability_;     // probability that the projection of a near neighbor falls into the interval
+};
+
+/**
+ * @brief Probing sequence of a query over the projection buckets of several random lines.
+ * The projection line of each random line is cut into buckets of the bucket width, the home bucket of every line
+ * holding the projection of the query comes first. Neighbouring buckets of all the lines follow in decreasing
+ * probability of holding the projection of a near neighbor, whose offset from the query projection follows the
+ * stable distribution of the random lines with the scale given. Cauchy lines are 1-stable, the other line types
+ * are Gaussian or close to it.
+ * Buckets of a line are expanded lazily, the neighbours of a line on each side are ordered by their distance.
+ */
+MULTI_PROBE_TEMPLATE
+class MultiProbeSequence {
+ public:
+  /**
+   * @param projections projection values of the query onto the random lines
+   * @param bucket_width width of a projection bucket
+   * @param scale scale of the offset of a near neighbor projection, half the bucket width if not positive
+   * @param distribution_type distribution type of the random lines
+   */
+  MultiProbeSequence(std::vector<ValueType> projections,
+                     ValueType bucket_width,
+                     float scale = 0.0F,
+                     RandomLineDistributionType distribution_type = RandomLineDistributionType::GAUSSIAN);
+
+  /**
+   * Next interval to probe
+   * @return false if there is no random line
+   */
+  auto Next(ProbeInterval<ValueType> *interval) -> bool;
+
+  /** Number of intervals returned so far */
+  [[nodiscard]] auto GetProbeCount() const -> int { return probe_count_; }
+
+ private:
+  struct ProbeOrder {
+    auto operator()(const ProbeInterval<ValueType> &left, const ProbeInterval<ValueType> &right) const -> bool {
+      return left.probability_ < right.probability_;
+    }
+  };
+
+  auto MakeInterval(int line, int bucket) const -> ProbeInterval<ValueType>;
+
+  /** Probability of a standard offset below x */
+  auto Cdf(float x) const -> float;
+
+  std::vector<ValueType> projections_;
+  std::vector<int64_t> home_buckets_;
+  ValueType bucket_width_;
+  float scale_;
+  RandomLineDistributionType distribution_type_;
+  int probe_count_{0};
+  std::priority_queue<ProbeInterval<ValueType>, std::vector<ProbeInterval<ValueType>>, ProbeOrder> neighbours_;
+};
+
+} // namespace distribution_lsh
@@ -0,0 +1,73 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/include/storage/index/packed_projection_index.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <map>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <common/config.h>
+#include <common/rid.h>
+#include <common/util/mapped_file.h>
+#include <storage/index/projection_column.h>
+
+namespace distribution_lsh {
+
+#define PACKED_INDEX_TEMPLATE template<typename ValueType>
+#define PACKED_INDEX_TYPE PackedProjectionIndex<ValueType>
+#define PACKED_INDEX_MAGIC 0x3158'4449'4B43'4150UL    // "PACKIDX1"
+
+/**
+ * @brief Immutable index of all the random lines of a group in one file, each line is a sorted array of
+ * its projection records. Lines are located by a directory, records by an in-memory sparse fence index
+ * holding every fence interval-th value of a line.
+ * ----------------------------------------------------------------------------------------------------
+ * | MAGIC (8) | LINE_COUNT (4) | RECORD_SIZE (4) | ... | LINES (24 * LINE_COUNT) | ... | RECORDS ... |
+ * ----------------------------------------------------------------------------------------------------
+ * A line entry is (random line rid, offset of its first record, number of records).
+ * A range lookup is a binary search over the fences followed by one sequential read of the records.
+ */
+PACKED_INDEX_TEMPLATE
+class PackedProjectionIndex {
+ public:
+  /** Records of a random line to be packed */
+  using Line = std::pair<RID /* random line rid */, std::span<const ProjectionRecord<ValueType>>>;
+
+  /** Open a packed index file and build its fence index */
+  explicit PackedProjectionIndex(const std::string &file_name, int fence_interval = PACKED_INDEX_FENCE_INTERVAL);
+
+  /** Sort the records of every line by value and write them into a packed index file */
+  static void Build(const std::string &file_name, std::span<const Line> lines);
+
+  [[nodiscard]] auto GetLineCount() const -> int { return static_cast<int>(lines_.size()); }
+
+  /** Number of records of a random line, -1 if the line is not in the index */
+  auto GetSize(const RID &random_line_rid) const -> int64_t;
+
+  /**
+   * Data whose projection onto the random line lies in [lkey, rkey]
+   * @param[return] result rids of the data, in projection value order
+   * @return false if the random line is not in the index or the range is empty
+   */
+  auto RangeRead(const RID &random_line_rid, ValueType lkey, ValueType rkey, std::vector<RID> *result) const -> bool;
+
+ private:
+  struct LineIndex {
+    const ProjectionRecord<ValueType> *records_;
+    int64_t size_;
+    std::vector<ValueType> fences_;    // value of record i * fence interval
+  };
+
+  MappedFile file_;
+  int fence_interval_;
+  std::map<RID, LineIndex> lines_;
+};
+
+} // namespace distribution_lsh
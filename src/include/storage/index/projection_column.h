@@ -0,0 +1,89 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/include/storage/index/projection_column.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <common/config.h>
+#include <common/rid.h>
+#include <common/util/mapped_file.h>
+
+namespace distribution_lsh {
+
+#define PROJECTION_COLUMN_TEMPLATE template<typename ValueType>
+#define PROJECTION_COLUMN_MAGIC 0x314C'4F43'4A4F'5250UL    // "PROJCOL1"
+
+/** Projection value of a data onto a random line, with the location of the data */
+PROJECTION_COLUMN_TEMPLATE
+struct ProjectionRecord {
+  ValueType value_;
+  page_id_t page_id_;
+  uint32_t slot_;
+
+  [[nodiscard]] auto GetRID() const -> RID { return {page_id_, slot_}; }
+};
+
+/**
+ * @brief Append-only column of the projection values of one random line, written along with its B+ tree.
+ * --------------------------------------------------------------------
+ * | MAGIC (8) | RECORD_SIZE (4) | RESERVED (4) | RECORD | RECORD | ... |
+ * --------------------------------------------------------------------
+ * Records are in insertion order, so that a tree can be rebuilt by one sequential scan without projecting again.
+ */
+PROJECTION_COLUMN_TEMPLATE
+class ProjectionColumnWriter {
+ public:
+  /** Open the column for appending, the header is written if the file is new */
+  explicit ProjectionColumnWriter(std::string file_name, int buffer_size = PROJECTION_COLUMN_BUFFER_SIZE);
+
+  ProjectionColumnWriter(const ProjectionColumnWriter &) = delete;
+  auto operator=(const ProjectionColumnWriter &) -> ProjectionColumnWriter & = delete;
+
+  ~ProjectionColumnWriter();
+
+  /** Append a record, records are buffered until the buffer is full or Flush */
+  void Append(ValueType value, const RID &rid);
+
+  /** Write the buffered records to the file */
+  void Flush();
+
+  [[nodiscard]] auto GetFileName() const -> const std::string & { return file_name_; }
+
+ private:
+  void FlushLocked();
+
+  std::string file_name_;
+  size_t buffer_size_;
+  std::mutex latch_;
+  std::ofstream ofs_;
+  std::vector<ProjectionRecord<ValueType>> buffer_;
+};
+
+/**
+ * @brief Read-only view of a projection column file
+ */
+PROJECTION_COLUMN_TEMPLATE
+class ProjectionColumnReader {
+ public:
+  explicit ProjectionColumnReader(const std::string &file_name);
+
+  [[nodiscard]] auto GetSize() const -> size_t { return size_; }
+
+  /** Records in insertion order */
+  [[nodiscard]] auto GetRecords() const -> std::span<const ProjectionRecord<ValueType>>;
+
+ private:
+  MappedFile file_;
+  size_t size_{0};
+};
+
+} // namespace distribution_lsh
@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <deque>
 #include <mutex>
+#include <vector>
 
 #include <common/config.h>
 #include <common/rid.h>
@@ -61,14 +63,38 @@ class RandomLineManager {
   /** Judge if the random line group is empty*/
   auto IsEmpty(RandomLineContext *ctx = nullptr, bool is_read = true) -> bool;
 
-  /** Obtain the new random line group */
+  /**
+   * Obtain the new random line group
+   * @brief candidates are generated in batches and tested against the average random line kept in memory,
+   * the accepted lines are stored in one append and the average pages are written once
+   */
   auto GenerateRandomLineGroup(int group_size) -> bool;
 
+  /**
+   * Obtain a seed-defined random line group, only the seed is stored in the header page
+   * @brief lines are the first group size lines of the random stream of the seed, regenerated into memory when the
+   * file is opened. They are not tested against the average random line, the group keeps an epsilon of 0.
+   * Lines are addressed by RID(HEADER_PAGE_ID, index) and cannot be deleted.
+   * @return false if the group is not empty
+   */
+  auto GenerateSeededRandomLineGroup(int group_size, uint64_t seed) -> bool;
+
   /** Compute inner product by header page id and slot number */
   auto InnerProduct(int index, page_id_t *directory_page_id, int *slot, std::shared_ptr<RandomLineValueType[]> outer_array) -> RandomLineValueType;
 
   auto InnerProduct(page_id_t directory_page_id, int slot, std::shared_ptr<RandomLineValueType[]> outer_array) -> RandomLineValueType;
 
+  /**
+   * Project an array onto every random line of the group, line index order as InnerProduct by index
+   * @brief a seed-defined SRHT group is projected by one fast hadamard transform, a sparse group gathers the non-zero
+   * entries only
+   * @param[return] random_line_rids locations of the random lines
+   * @param[return] projections inner products with the random lines
+   */
+  auto Project(std::shared_ptr<RandomLineValueType[]> outer_array,
+               std::vector<RID> *random_line_rids,
+               std::vector<RandomLineValueType> *projections) -> bool;
+
   /** random line group information*/
   auto RandomLineGroupInformation() -> std::string;
 
@@ -80,6 +106,8 @@ class RandomLineManager {
   auto GetDataPageMaxSize() -> int;
   auto GetDistributionType() -> RandomLineDistributionType;
   auto GetNormalizationType() -> RandomLineNormalizationType;
+  auto IsSeeded() -> bool;
+  auto GetSeed() -> uint64_t;
   auto GetSize(RandomLineContext *ctx = nullptr, std::shared_ptr<std::vector<RID>> random_line_rids = nullptr) -> int;
 
   /** Information of the random line manager */
@@ -104,12 +132,41 @@ class RandomLineManager {
   /** Store a random line with called page*/
   auto Store(std::shared_ptr<RandomLineValueType[]> array, RandomLineContext *ctx = nullptr) -> bool;
 
-  /** Update average random line */
-  void UpdateAverageRandomLine(std::shared_ptr<RandomLineValueType[]> array, RandomLineContext *ctx = nullptr);
+  /**
+   * Append count random lines of a row-major matrix in bulk, the last directory page is latched once for all of them
+   * @brief the pages of all the lines are allocated and written before any line is published in the directory, a
+   * failure deletes them, so that either all the lines are stored or none
+   */
+  auto Store(const RandomLineValueType *lines, int count, RandomLineContext *ctx = nullptr) -> bool;
+
+  /** Store the values of a line in a chain of dense data pages, the allocated page ids are appended in chain order */
+  auto StoreDense(const RandomLineValueType *array, std::vector<page_id_t> *random_line_page_ids) -> bool;
+
+  /** Store the non-zero entries of a line in a chain of sparse data pages, the allocated page ids are appended in chain
+   * order */
+  auto StoreSparse(const RandomLineValueType *array, std::vector<page_id_t> *random_line_page_ids) -> bool;
+
+  /** Read the average random line pages into memory */
+  auto LoadAverageRandomLine(RandomLineContext *ctx = nullptr) -> bool;
+
+  /** Write the average random line in memory back to its pages */
+  void FlushAverageRandomLine(RandomLineContext *ctx = nullptr);
 
   /** A random line with called page*/
   auto RandomLineInformation(page_id_t random_line_page_id) -> std::string;
 
+  /** Rebuild the in-memory directory index from the directory chain */
+  void BuildDirectoryIndex();
+
+  /** Count the lines of a legacy file, written before the header page kept the size, and bring its header up */
+  void UpgradeLegacyHeaderPage();
+
+  /** Regenerate the lines of a seed-defined group from index start up to size */
+  auto GenerateSeededRandomLines(int start, int size) -> bool;
+
+  /** Inner product with a line of a seed-defined group */
+  auto SeededInnerProduct(int index, const RandomLineValueType *outer_array) -> RandomLineValueType;
+
   std::string manager_name_;
   file_id_t file_id_{INVALID_FILE_ID};
   std::shared_ptr<BufferPoolManager> bpm_{nullptr};
@@ -121,6 +178,23 @@ class RandomLineManager {
   RandomLineDistributionType distribution_type_{RandomLineDistributionType::INVALID_DISTRIBUTION_TYPE};
   RandomLineNormalizationType normalization_type_{RandomLineNormalizationType::INVALID_NORMALIZATION_TYPE};
   float epsilon_{EPSILON};
+
+  /** Directory page ids in chain order, guarded by the latch of the header page */
+  std::vector<page_id_t> directory_page_ids_;
+
+  /** Average random line, loaded from its pages on the first generation, guarded by the latch of the header page */
+  std::vector<RandomLineValueType> average_random_line_;
+
+  /** Seed-defined group, lines are kept in a row-major matrix of size * dimension */
+  bool is_seeded_{false};
+  uint64_t seed_{0};
+  std::vector<RandomLineValueType> seeded_random_lines_;
+  /** Non-zero entries of a sparse seed-defined group, line i holds entries [offsets[i], offsets[i + 1]) */
+  std::vector<int64_t> seeded_sparse_offsets_;
+  std::vector<RandomLineSparseEntry<RandomLineValueType>> seeded_sparse_entries_;
+  /** Random signs and hadamard rows of a SRHT seed-defined group */
+  std::vector<int> seeded_hadamard_signs_;
+  std::vector<int> seeded_hadamard_rows_;
 };
 
 } // namespace distribution_lsh
\ No newline at end of file
@@ -7,6 +7,7 @@
 
 #pragma once
 
+#include <deque>
 #include <mutex>
 #include <optional>
 
@@ -11,6 +11,7 @@
 #include <common/logger.h>
 #include <fmt/format.h>
 #include <storage/page/dataset/distribution_dataset_page.h>
+#include <storage/page/dataset/vector_encoding.h>
 
 namespace distribution_lsh {
 
@@ -43,6 +44,25 @@ class DistributionDataSetDataPage : public DistributionDataSetPage {
 
   auto ToString() -> std::string override;
 
+  /**
+   * Max number of values of a page in the encoding.
+   * UINT8 pages keep the scale and the offset of the vector in front of the codes.
+   */
+  static auto GetEncodedCapacity(VectorEncoding encoding) -> int;
+
+  /**
+   * Encode values into the page and set its size
+   * @param scale, offset quantization parameters of the whole vector, only used by UINT8
+   */
+  void Encode(const ValueType *values, int length, VectorEncoding encoding, float scale = 0.0F, float offset = 0.0F);
+
+  /**
+   * Decode the values of the page
+   * @param[return] buffer room for GetSize() values, unused by FLOAT32 pages
+   * @return the values, which are the page itself for FLOAT32 pages
+   */
+  auto Decode(VectorEncoding encoding, ValueType *buffer) const -> const ValueType *;
+
  private:
   ValueType array_[0];
 };
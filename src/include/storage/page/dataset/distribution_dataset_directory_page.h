@@ -14,7 +14,9 @@
 namespace distribution_lsh {
 
 #define DISTRIBUTION_DATASET_DIRECTORY_PAGE_HEADER_SIZE (8 + DISTRIBUTION_DATASET_PAGE_HEADER_SIZE)
-#define DISTRIBUTION_DATASET_DIRECTORY_PAGE_SIZE ((DISTRIBUTION_LSH_PAGE_SIZE - DISTRIBUTION_DATASET_DIRECTORY_PAGE_HEADER_SIZE) / sizeof(page_id_t))
+/** The slot array starts within the in-memory class, whose vtable pointer the header size macro leaves out */
+#define DISTRIBUTION_DATASET_DIRECTORY_PAGE_SIZE \
+  GetOccupancyBitmapPageSize(sizeof(DistributionDataSetDirectoryPage), sizeof(page_id_t))
 
 
 class DistributionDataSetDirectoryPage : public distribution_lsh::DistributionDataSetPage {
@@ -25,7 +27,7 @@ class DistributionDataSetDirectoryPage : public distribution_lsh::DistributionDa
   DistributionDataSetDirectoryPage(const DistributionDataSetDirectoryPage &other) = delete;
 
   /**
-  * Init the directory page
+  * Init the directory page, see OccupancyBitmap for how the slots are tracked
   * @param max_size data the page can max hold
   */
  void Init(int max_size = DISTRIBUTION_DATASET_DIRECTORY_PAGE_SIZE);
@@ -60,6 +62,9 @@ class DistributionDataSetDirectoryPage : public distribution_lsh::DistributionDa
  void SetEndOfArray(int end_of_array);
 
  private:
+  [[nodiscard]] auto GetOccupancyWords() const -> const occupancy_word_t *;
+  auto GetOccupancyWords() -> occupancy_word_t *;
+
   int null_slot_start_{0};
   int end_of_array_{0};
   page_id_t array_[0];
@@ -31,18 +31,24 @@ class DistributionDataSetGenerationHeaderPage : public DistributionDataSetHeader
       float param1,
       float param2,
       int dimension,
-      page_id_t directory_start_page_id);
+      page_id_t directory_start_page_id,
+      uint64_t seed);
 
   auto GetDistributionType() const -> DistributionType;
   void SetDistributionType(DistributionType distribution_type);
 
   auto GetParameter() const -> std::shared_ptr<float [2]>;
 
+  /** Seed of the generated data, the data of a row is defined by the seed and the row index */
+  auto GetSeed() const -> uint64_t;
+  void SetSeed(uint64_t seed);
+
  private:
 
   void SetParameter(float param1, float param2);
 
   DistributionType distribution_type_;                                                  // distribution type
   float parameter_[2];                                                                   // parameters needed to generate data
+  uint64_t seed_;                                                                       // seed of the generated data
 };
 } // namespace distribution_lsh
@@ -12,10 +12,16 @@
 #include <common/config.h>
 #include <common/exception.h>
 #include <storage/page/header_page.h>
+#include <storage/page/dataset/vector_encoding.h>
 
 namespace distribution_lsh {
 
-#define DISTRIBUTION_DATASET_HEADER_PAGE_HEADER_SIZE (6 + COMMON_HEADER_PAGE_HEADER_SIZE)
+#define DISTRIBUTION_DATASET_HEADER_PAGE_HEADER_SIZE (15 + COMMON_HEADER_PAGE_HEADER_SIZE)
+
+/** Version of the header page layout, files written before the size was kept read 0, before the seed of a generation
+ * file was kept read 1 */
+#define DISTRIBUTION_DATASET_HEADER_PAGE_VERSION 2
+#define DISTRIBUTION_DATASET_HEADER_PAGE_SEED_VERSION 2
 
 class HeaderPage;
 
@@ -75,17 +81,36 @@ class DistributionDataSetHeaderPage : public HeaderPage {
   auto GetNormalizationType() const -> NormalizationType;
   void SetNormalizationType(NormalizationType normalization_type);
 
+  /** Encoding of the data pages, files written before the encodings existed read as FLOAT32 */
+  auto GetVectorEncoding() const -> VectorEncoding;
+  void SetVectorEncoding(VectorEncoding vector_encoding);
+
   auto GetDimension() const -> int;
   void SetDimension(int dimension);
 
   auto IsEmpty() const -> bool;
   void SetDirectoryId(page_id_t directory_start_page_id);
 
+  auto GetSize() const -> int;
+  void SetSize(int size);
+  void IncreaseSize(int amount);
+
+  /**
+   * A legacy file, of version 0, has no size and keeps the fields of its data set type 4 bytes earlier. The size is
+   * recounted from the directory pages on its first open, a generation file is refused as its parameters moved. A
+   * generation file of version 1 keeps no seed and is refused as well.
+   */
+  auto GetFormatVersion() const -> uint8_t;
+  void SetFormatVersion(uint8_t format_version);
+
  private:
   DataSetType data_set_type_;                    // data set type in this file
   NormalizationType normalization_type_;         // normalization type in this file
+  VectorEncoding vector_encoding_;               // encoding of the data pages, the former padding byte
+  uint8_t format_version_;                       // layout version, the last padding byte
   int dimension_;                                // dimension of the data
   page_id_t directory_start_page_id_;              // directory start page id
+  int size_;                                     // number of data stored in this file
 };
 
 }  // namespace distribution_lsh
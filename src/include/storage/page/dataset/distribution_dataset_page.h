@@ -10,6 +10,7 @@
 #include <common/config.h>
 #include <storage/page/header_page.h>
 #include <storage/page/data_page.h>
+#include <storage/page/occupancy_bitmap.h>
 
 namespace distribution_lsh {
 
@@ -32,8 +33,12 @@ class DistributionDataSetPage : public DataPage {
   void SetSize(int size);
 
   [[nodiscard]] auto GetMaxSize() const -> int;
+  /** Set the max size, the occupancy bitmap flag is cleared */
   void SetMaxSize(int max_size);
 
+  [[nodiscard]] auto HasOccupancyBitmap() const -> bool;
+  void SetOccupancyBitmap(bool has_occupancy_bitmap);
+
   [[nodiscard]] auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
 
@@ -0,0 +1,135 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/include/storage/page/dataset/vector_encoding.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <string>
+
+namespace distribution_lsh {
+
+/**
+ * Encoding of the distribution data on the data pages
+ * FLOAT32: values as is
+ * FLOAT16: IEEE 754 half precision
+ * BFLOAT16: upper half of a float, same range as float with 8 bits of mantissa
+ * UINT8: scalar quantization, value = offset + code * scale with per-vector scale and offset
+ */
+enum class VectorEncoding : std::uint8_t { FLOAT32 = 0, FLOAT16, BFLOAT16, UINT8 };
+
+inline auto VectorEncodingToString(VectorEncoding encoding) noexcept -> std::string {
+  switch (encoding) {
+    case VectorEncoding::FLOAT32: return "FLOAT32";
+    case VectorEncoding::FLOAT16: return "FLOAT16";
+    case VectorEncoding::BFLOAT16: return "BFLOAT16";
+    case VectorEncoding::UINT8: return "UINT8";
+    default: return "UNSUPPORTED VECTOR ENCODING";
+  }
+}
+
+/** Bytes of an encoded value */
+constexpr auto GetVectorEncodingWidth(VectorEncoding encoding) -> int {
+  switch (encoding) {
+    case VectorEncoding::FLOAT16:
+    case VectorEncoding::BFLOAT16: return 2;
+    case VectorEncoding::UINT8: return 1;
+    case VectorEncoding::FLOAT32:
+    default: return 4;
+  }
+}
+
+/** Float to half precision, rounded to nearest even */
+inline auto FloatToHalf(float value) -> uint16_t {
+  auto bits = std::bit_cast<uint32_t>(value);
+  auto sign = static_cast<uint16_t>((bits >> 16) & 0x8000U);
+  auto magnitude = bits & 0x7FFF'FFFFU;
+
+  // NaN and infinity
+  if (magnitude >= 0x7F80'0000U) {
+    return sign | (magnitude > 0x7F80'0000U ? 0x7E00U : 0x7C00U);
+  }
+  // Overflow to infinity
+  if (magnitude >= 0x4780'0000U) {
+    return sign | 0x7C00U;
+  }
+  // Subnormal half, shift the mantissa with its hidden bit into place
+  if (magnitude < 0x3880'0000U) {
+    if (magnitude < 0x3300'0000U) {
+      return sign;
+    }
+    auto exponent = magnitude >> 23;
+    auto mantissa = (magnitude & 0x007F'FFFFU) | 0x0080'0000U;
+    auto shift = 126 - exponent;
+    auto half = mantissa >> shift;
+    auto remainder = mantissa & ((1U << shift) - 1);
+    auto halfway = 1U << (shift - 1);
+    if (remainder > halfway || (remainder == halfway && (half & 1U) != 0)) {
+      ++half;
+    }
+    return sign | static_cast<uint16_t>(half);
+  }
+  // Normal half, rebias the exponent and round the mantissa
+  auto half = (magnitude - 0x3800'0000U) >> 13;
+  auto remainder = magnitude & 0x1FFFU;
+  if (remainder > 0x1000U || (remainder == 0x1000U && (half & 1U) != 0)) {
+    ++half;
+  }
+  return sign | static_cast<uint16_t>(half);
+}
+
+/** Half precision to float, exact */
+inline auto HalfToFloat(uint16_t half) -> float {
+  auto sign = static_cast<uint32_t>(half & 0x8000U) << 16;
+  auto exponent = (half >> 10) & 0x1FU;
+  auto mantissa = static_cast<uint32_t>(half & 0x03FFU);
+
+  if (exponent == 0x1FU) {
+    return std::bit_cast<float>(sign | 0x7F80'0000U | (mantissa << 13));
+  }
+  if (exponent == 0) {
+    // Zero or subnormal, mantissa * 2^-24
+    auto value = static_cast<float>(mantissa) * 0x1p-24F;
+    return sign != 0 ? -value : value;
+  }
+  return std::bit_cast<float>(sign | ((exponent + 112) << 23) | (mantissa << 13));
+}
+
+/** Float to bfloat16, rounded to nearest even */
+inline auto FloatToBFloat16(float value) -> uint16_t {
+  auto bits = std::bit_cast<uint32_t>(value);
+  if ((bits & 0x7FFF'FFFFU) > 0x7F80'0000U) {
+    return static_cast<uint16_t>((bits >> 16) | 0x0040U);
+  }
+  bits += 0x7FFFU + ((bits >> 16) & 1U);
+  return static_cast<uint16_t>(bits >> 16);
+}
+
+inline auto BFloat16ToFloat(uint16_t bfloat) -> float { return std::bit_cast<float>(static_cast<uint32_t>(bfloat) << 16); }
+
+/**
+ * Scalar quantization parameters of a vector, codes 0 ~ 255 cover [min, max] evenly
+ * @param[return] scale step between two codes, 0 if all the values are equal
+ * @param[return] offset value of code 0
+ */
+template<typename ValueType>
+void ComputeQuantizationRange(const ValueType *values, int length, float *scale, float *offset) {
+  auto [min, max] = std::minmax_element(values, values + length);
+  *offset = static_cast<float>(*min);
+  *scale = (static_cast<float>(*max) - *offset) / 255.0F;
+}
+
+inline auto QuantizeToUint8(float value, float scale, float offset) -> uint8_t {
+  if (scale == 0.0F) {
+    return 0;
+  }
+  return static_cast<uint8_t>(std::clamp(std::nearbyint((value - offset) / scale), 0.0F, 255.0F));
+}
+
+} // namespace distribution_lsh
@@ -0,0 +1,87 @@
+//===----------------------------------------------------
+//                          DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/9.
+// src/include/storage/page/occupancy_bitmap.h
+//
+//===-----------------------------------------------------
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+
+#include <common/config.h>
+
+namespace distribution_lsh {
+
+/**
+ * Flag kept in the max size field of a slotted page whose slots are tracked by an occupancy bitmap.
+ * Pages written before the bitmap existed have it clear and keep using the embedded null slot list.
+ */
+#define OCCUPANCY_BITMAP_FLAG (1 << 30)
+#define OCCUPANCY_BITMAP_WORD_BITS 32
+
+using occupancy_word_t = uint32_t;
+
+/**
+ * @brief Occupancy bitmap of a slotted page, bit i is set iff slot i holds a value.
+ * Init of a page stores the bitmap right behind the slot array if it fits in the page,
+ * otherwise the slots are tracked by the null slot list embedded in the free slots.
+ */
+class OccupancyBitmap {
+ public:
+  static constexpr auto WordCount(int slots) -> int {
+    return (slots + OCCUPANCY_BITMAP_WORD_BITS - 1) / OCCUPANCY_BITMAP_WORD_BITS;
+  }
+
+  /** Judge if a bitmap starting at bitmap with slots bits fits in the page */
+  static auto FitsInPage(const void *page, const void *bitmap, int slots) -> bool {
+    auto offset = static_cast<const char *>(bitmap) - static_cast<const char *>(page);
+    return offset + WordCount(slots) * static_cast<int64_t>(sizeof(occupancy_word_t)) <= DISTRIBUTION_LSH_PAGE_SIZE;
+  }
+
+  static void Reset(occupancy_word_t *words, int slots) { std::fill_n(words, WordCount(slots), 0); }
+
+  static auto Test(const occupancy_word_t *words, int slot) -> bool {
+    return ((words[slot / OCCUPANCY_BITMAP_WORD_BITS] >> (slot % OCCUPANCY_BITMAP_WORD_BITS)) & 1U) != 0;
+  }
+
+  static void Set(occupancy_word_t *words, int slot) {
+    words[slot / OCCUPANCY_BITMAP_WORD_BITS] |= 1U << (slot % OCCUPANCY_BITMAP_WORD_BITS);
+  }
+
+  static void Clear(occupancy_word_t *words, int slot) {
+    words[slot / OCCUPANCY_BITMAP_WORD_BITS] &= ~(1U << (slot % OCCUPANCY_BITMAP_WORD_BITS));
+  }
+
+  /** First clear slot in [start, end), end if all of them are set */
+  static auto FindFirstClear(const occupancy_word_t *words, int start, int end) -> int {
+    for (int word = start / OCCUPANCY_BITMAP_WORD_BITS; word * OCCUPANCY_BITMAP_WORD_BITS < end; ++word) {
+      auto clear_bits = ~words[word];
+      if (word == start / OCCUPANCY_BITMAP_WORD_BITS) {
+        clear_bits &= ~0U << (start % OCCUPANCY_BITMAP_WORD_BITS);
+      }
+      if (clear_bits != 0) {
+        return std::min(word * OCCUPANCY_BITMAP_WORD_BITS + std::countr_zero(clear_bits), end);
+      }
+    }
+    return end;
+  }
+};
+
+/**
+ * Max slots of a page whose slot array starts at header size, the largest n with
+ * header size + n * slot size + bytes of the n bits bitmap <= page size
+ */
+constexpr auto GetOccupancyBitmapPageSize(int header_size, int slot_size) -> int {
+  // Start from the bound of a bitmap of n / 8 bytes, words round it up by a few bytes at most
+  auto slots = (DISTRIBUTION_LSH_PAGE_SIZE - header_size) * 8 / (slot_size * 8 + 1);
+  while (header_size + slots * slot_size
+      + OccupancyBitmap::WordCount(slots) * static_cast<int>(sizeof(occupancy_word_t)) > DISTRIBUTION_LSH_PAGE_SIZE) {
+    slots--;
+  }
+  return slots;
+}
+
+} // namespace distribution_lsh
@@ -7,8 +7,9 @@
 
 #pragma once
 
+#include <mutex>  // NOLINT
+
 #include <storage/page/page.h>
-#include <memory>
 
 namespace distribution_lsh {
 
@@ -16,11 +17,16 @@ class BufferPoolManager;
 class ReadPageGuard;
 class WritePageGuard;
 
+/**
+ * @brief Handle of a pinned frame, the page is unpinned when the guard is dropped.
+ * A guard is a frame pointer and a buffer pool manager pointer, moving it touches no shared state.
+ */
 class BasicPageGuard {
  public:
   BasicPageGuard() = default;
 
-  BasicPageGuard(BufferPoolManager *bpm, std::shared_ptr<Page> page) : bpm_(bpm), page_(std::move(page)) { is_dirty_ = page_->IsDirty(); }
+  BasicPageGuard(BufferPoolManager *bpm, Page *page)
+      : bpm_(bpm), page_(page), is_dirty_(page != nullptr && page->IsDirty()) {}
 
   BasicPageGuard(const BasicPageGuard &) = delete;
   auto operator=(const BasicPageGuard &) = delete;
@@ -38,7 +44,7 @@ class BasicPageGuard {
   void Drop();
 
   /**
-   * @brief Move assignment for BasicPageGuard
+   * @brief Move assignment for BasicPageGuard, the page held before is dropped
    */
   auto operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard &;
 
@@ -82,14 +88,20 @@ class BasicPageGuard {
   friend class WritePageGuard;
 
   BufferPoolManager *bpm_{nullptr};
-  std::shared_ptr<Page> page_{nullptr};
+  Page *page_{nullptr};
   bool is_dirty_{false};
 };
 
 class ReadPageGuard {
  public:
   ReadPageGuard() = default;
-  ReadPageGuard(BufferPoolManager *bpm, std::shared_ptr<Page> page) : guard_(bpm, std::move(page)) { guard_.page_->RLatch(); }
+  ReadPageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {
+    if (guard_.page_ != nullptr) {
+      guard_.page_->RLatch();
+    }
+  }
+  /** Guard of a page whose read latch is already held by the calling thread */
+  ReadPageGuard(BufferPoolManager *bpm, Page *page, std::adopt_lock_t) : guard_(bpm, page) {}
   ReadPageGuard(const ReadPageGuard &) = delete;
   auto operator=(const ReadPageGuard &) -> ReadPageGuard & = delete;
 
@@ -123,13 +135,19 @@ class ReadPageGuard {
   }
 
  private:
+  friend class BasicPageGuard;
+
   BasicPageGuard guard_;
 };
 
 class WritePageGuard {
  public:
   WritePageGuard() = default;
-  WritePageGuard(BufferPoolManager *bpm, std::shared_ptr<Page> page) : guard_(bpm, std::move(page)) { guard_.page_->WLatch(); }
+  WritePageGuard(BufferPoolManager *bpm, Page *page) : guard_(bpm, page) {
+    if (guard_.page_ != nullptr) {
+      guard_.page_->WLatch();
+    }
+  }
   WritePageGuard(const WritePageGuard &) = delete;
   auto operator=(const WritePageGuard &) -> WritePageGuard & = delete;
 
@@ -170,6 +188,8 @@ class WritePageGuard {
   }
 
  private:
+  friend class BasicPageGuard;
+
   BasicPageGuard guard_;
 };
 }// namespace distribution_lsh
\ No newline at end of file
@@ -23,9 +23,26 @@ auto constexpr GetRandomLineDataPageSize() {
   }
 }
 
+/** Non-zero entry of a sparse random line */
+RANDOM_LINE_TEMPLATE
+struct RandomLineSparseEntry {
+  int32_t index_;
+  RandomLineValueType value_;
+};
+
+template <typename RandomLineValueType>
+auto constexpr GetRandomLineSparseDataPageSize() {
+  return (DISTRIBUTION_LSH_PAGE_SIZE - RANDOM_LINE_DATA_PAGE_HEADER_SIZE) / sizeof(RandomLineSparseEntry<RandomLineValueType>);
+}
+
 RANDOM_LINE_TEMPLATE
 class RandomLineManager;
 
+/**
+ * @brief page of a random line, a line spans a chain of data pages.
+ * A dense page (DATA_PAGE) holds the next size values of the line, a sparse page (SPARSE_DATA_PAGE) holds size
+ * non-zero entries (index, value) of the line in increasing index order.
+ */
 RANDOM_LINE_TEMPLATE
 class RandomLineDataPage : public RandomLinePage {
   friend class RandomLineManager<RandomLineValueType>;
@@ -35,9 +52,24 @@ class RandomLineDataPage : public RandomLinePage {
 
   void Init(int max_size = GetRandomLineDataPageSize<RandomLineValueType>());
 
+  /** Init a page of non-zero entries */
+  void InitSparse(int max_size = GetRandomLineSparseDataPageSize<RandomLineValueType>());
+
+  [[nodiscard]] auto IsSparse() const -> bool { return GetPageType() == RandomLinePageType::SPARSE_DATA_PAGE; }
+
+  /** Inner product of the part of the line on this page, offset is the index of the first value on a dense page */
+  auto InnerProduct(const RandomLineValueType *outer_array, int offset) const -> RandomLineValueType;
+
   auto ToString() -> std::string override;
 
  private:
+  auto GetEntries() -> RandomLineSparseEntry<RandomLineValueType> * {
+    return reinterpret_cast<RandomLineSparseEntry<RandomLineValueType> *>(array_);
+  }
+  [[nodiscard]] auto GetEntries() const -> const RandomLineSparseEntry<RandomLineValueType> * {
+    return reinterpret_cast<const RandomLineSparseEntry<RandomLineValueType> *>(array_);
+  }
+
   RandomLineValueType array_[0];
 };
 } // namespace distribution_lsh
@@ -14,11 +14,9 @@
 namespace distribution_lsh {
 
 #define RANDOM_LINE_DIRECTORY_PAGE_HEADER_SIZE (8 + RANDOM_LINE_PAGE_HEADER_SIZE)
-#define RANDOM_LINE_DIRECTORY_PAGE_SIZE ((DISTRIBUTION_LSH_PAGE_SIZE - RANDOM_LINE_DIRECTORY_PAGE_HEADER_SIZE)/ sizeof(page_id_t))
-
-auto constexpr GetRandomLineDirectoryPageSize() {
-  return static_cast<int>((DISTRIBUTION_LSH_PAGE_SIZE - RANDOM_LINE_DIRECTORY_PAGE_HEADER_SIZE) / sizeof(page_id_t));
-}
+/** The slot array starts within the in-memory class, whose vtable pointer the header size macro leaves out */
+#define RANDOM_LINE_DIRECTORY_PAGE_SIZE \
+  GetOccupancyBitmapPageSize(sizeof(RandomLineDirectoryPage), sizeof(page_id_t))
 
 class RandomLineDirectoryPage : public RandomLinePage {
   template<class RandomLineValueType>
@@ -28,10 +26,10 @@ class RandomLineDirectoryPage : public RandomLinePage {
   RandomLineDirectoryPage(const RandomLineDirectoryPage &other) = delete;
 
   /**
-  * Init the directory page
+  * Init the directory page, see OccupancyBitmap for how the slots are tracked
   * @param max_size data the page can max hold
   */
-  void Init(int max_size = GetRandomLineDirectoryPageSize());
+  void Init(int max_size = RANDOM_LINE_DIRECTORY_PAGE_SIZE);
 
   /**
    * Insert an entry into the page
@@ -62,10 +60,16 @@ class RandomLineDirectoryPage : public RandomLinePage {
   void SetEndOfArray(int end_of_array);
 
  private:
+  [[nodiscard]] auto GetOccupancyWords() const -> const occupancy_word_t *;
+  auto GetOccupancyWords() -> occupancy_word_t *;
+
   int null_slot_start_{0};
   int end_of_array_{0};
   page_id_t array_[0];
 };
 
+auto constexpr GetRandomLineDirectoryPageSize() {
+  return static_cast<int>(RANDOM_LINE_DIRECTORY_PAGE_SIZE);
+}
 
 } // namespace distribution_lsh
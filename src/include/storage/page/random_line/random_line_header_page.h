@@ -15,9 +15,18 @@ namespace distribution_lsh {
 enum class RandomLineDistributionType : std::uint8_t {
   INVALID_DISTRIBUTION_TYPE = 0,
   CAUCHY = static_cast<std::uint8_t>(1 << 1),
-  GAUSSIAN = static_cast<std::uint8_t>(1 << 2)
+  GAUSSIAN = static_cast<std::uint8_t>(1 << 2),
+  SPARSE = static_cast<std::uint8_t>(1 << 3),         // Achlioptas, sqrt(3) * {1, 0, -1} with {1/6, 2/3, 1/6}
+  VERY_SPARSE = static_cast<std::uint8_t>(1 << 4),    // Li, sqrt(s) * {1, 0, -1} with {1/2s, 1 - 1/s, 1/2s}, s = sqrt(dimension)
+  SRHT = static_cast<std::uint8_t>(1 << 5)            // rows of a randomized hadamard transform, sign(i) * H(row, i)
 };
 
+/** Lines of the distribution type are mostly zeros and stored as their non-zero entries */
+inline auto IsSparseDistributionType(RandomLineDistributionType distribution_type) -> bool {
+  return distribution_type == RandomLineDistributionType::SPARSE
+      || distribution_type == RandomLineDistributionType::VERY_SPARSE;
+}
+
 enum class RandomLineNormalizationType : std::uint8_t {
   INVALID_NORMALIZATION_TYPE = 0,
   NONE = static_cast<std::uint8_t>(1 << 1),
@@ -31,6 +40,9 @@ inline auto RandomLineDistributionTypeToString(RandomLineDistributionType distri
     case RandomLineDistributionType::INVALID_DISTRIBUTION_TYPE: return "INVALID DISTRIBUTION TYPE";
     case RandomLineDistributionType::CAUCHY: return "CAUCHY DISTRIBUTION TYPE";
     case RandomLineDistributionType::GAUSSIAN: return "GAUSSIAN DISTRIBUTION TYPE";
+    case RandomLineDistributionType::SPARSE: return "SPARSE DISTRIBUTION TYPE";
+    case RandomLineDistributionType::VERY_SPARSE: return "VERY_SPARSE DISTRIBUTION TYPE";
+    case RandomLineDistributionType::SRHT: return "SRHT DISTRIBUTION TYPE";
     default: return "UNSUPPORTED DISTRIBUTION TYPE";
   }
 }
@@ -46,6 +58,9 @@ inline auto RandomLineNormalizationTypeToString(RandomLineNormalizationType norm
 }
 
 
+/** Version of the header page layout, files written before the size and the seed were kept read 0 */
+#define RANDOM_LINE_HEADER_PAGE_VERSION 1
+
 /**
 * @breif page that contain the start page of each random line
 */
@@ -78,13 +93,30 @@ class RandomLineHeaderPage : HeaderPage {
   [[nodiscard]] auto GetDirectoryPageStartPageId() const -> page_id_t;
   void SetDirectoryPageStartPageId(page_id_t directory_page_start_page_id);
 
+  [[nodiscard]] auto GetSize() const -> int;
+  void SetSize(int size);
+  void IncreaseSize(int amount);
+
+  /** A legacy file, of version 0, has no size, it is recounted from the directory pages on its first open */
+  [[nodiscard]] auto GetFormatVersion() const -> uint8_t;
+  void SetFormatVersion(uint8_t format_version);
+
+  /** A seed-defined group stores no line, its lines are the first size lines of the random stream of the seed */
+  [[nodiscard]] auto IsSeeded() const -> bool;
+  [[nodiscard]] auto GetSeed() const -> uint64_t;
+  void SetSeed(uint64_t seed);
+
  private:
   int dimension_{0};
   RandomLineDistributionType distribution_type_{RandomLineDistributionType::INVALID_DISTRIBUTION_TYPE};
   RandomLineNormalizationType normalization_type_{RandomLineNormalizationType::INVALID_NORMALIZATION_TYPE};
+  uint8_t format_version_{0};       // layout version, in a former padding byte
   float epsilon_{EPSILON};
   page_id_t average_random_line_page_id_{INVALID_PAGE_ID};
   page_id_t directory_page_start_page_id_{INVALID_PAGE_ID};
+  int size_{0};                     // number of random lines stored in this file
+  bool is_seeded_{false};
+  uint64_t seed_{0};
 };
 
 }  // namespace distribution_lsh
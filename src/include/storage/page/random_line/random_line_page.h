@@ -10,13 +10,14 @@
 #include <common/config.h>
 #include <fmt/format.h>
 #include <storage/page/data_page.h>
+#include <storage/page/occupancy_bitmap.h>
 
 namespace distribution_lsh {
 
 #define RANDOM_LINE_TEMPLATE template<typename RandomLineValueType>
 #define RANDOM_LINE_PAGE_HEADER_SIZE 24
 
-enum class RandomLinePageType : std::uint8_t {INVALID_DATA_SET_PAGE_TYPE = 0 , AVERAGE_RANDOM_LINE_PAGE, DIRECTORY_PAGE, DATA_PAGE};
+enum class RandomLinePageType : std::uint8_t {INVALID_DATA_SET_PAGE_TYPE = 0 , AVERAGE_RANDOM_LINE_PAGE, DIRECTORY_PAGE, DATA_PAGE, SPARSE_DATA_PAGE};
 
 inline auto RandomLinePageTypeToString(RandomLinePageType type) -> std::string {
   switch (type) {
@@ -24,6 +25,7 @@ inline auto RandomLinePageTypeToString(RandomLinePageType type) -> std::string {
     case RandomLinePageType::AVERAGE_RANDOM_LINE_PAGE:return "AVERAGE_RANDOM_LINE_PAGE";
     case RandomLinePageType::DIRECTORY_PAGE:return "DIRECTORY_PAGE";
     case RandomLinePageType::DATA_PAGE:return "DATA_PAGE";
+    case RandomLinePageType::SPARSE_DATA_PAGE:return "SPARSE_DATA_PAGE";
     default:throw std::runtime_error("Invalid RandomLinePageType");
   }
 }
@@ -39,8 +41,12 @@ class RandomLinePage : public DataPage {
   void SetSize(int size);
 
   [[nodiscard]] auto GetMaxSize() const -> int;
+  /** Set the max size, the occupancy bitmap flag is cleared */
   void SetMaxSize(int max_size);
 
+  [[nodiscard]] auto HasOccupancyBitmap() const -> bool;
+  void SetOccupancyBitmap(bool has_occupancy_bitmap);
+
   [[nodiscard]] auto GetPageType() const -> RandomLinePageType;
   void SetPageType(RandomLinePageType type);
 
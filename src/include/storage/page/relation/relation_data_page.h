@@ -9,13 +9,15 @@
 
 #include <common/config.h>
 #include <storage/page/data_page.h>
+#include <storage/page/occupancy_bitmap.h>
 
 namespace distribution_lsh {
 
 #define RELATION_DATA_PAGE_HEADER_SIZE (12 + COMMON_DATA_PAGE_HEADER_SIZE)
 #define RELATION_TEMPLATE template<typename ValueType>
 #define RELATION_TYPE RelationDataPage<ValueType>
-#define RELATION_DATA_PAGE_SIZE ((DISTRIBUTION_LSH_PAGE_SIZE - RELATION_DATA_PAGE_HEADER_SIZE) / sizeof(ValueType))
+/** The slot array starts at the end of the in-memory class, the header size macro misses the slot list fields */
+#define RELATION_DATA_PAGE_SIZE GetOccupancyBitmapPageSize(sizeof(RELATION_TYPE), sizeof(ValueType))
 
 RELATION_TEMPLATE
 class RelationManager;
@@ -55,14 +57,19 @@ class RelationDataPage : public DataPage {
   RelationDataPage() = delete;
   RelationDataPage(RelationDataPage &&) = delete;
 
+  /** Init the data page, see OccupancyBitmap for how the slots are tracked */
   void Init(int max_size = RELATION_DATA_PAGE_SIZE);
 
   [[nodiscard]] auto GetSize() const -> int;
   void SetSize(int size);
 
   [[nodiscard]] auto GetMaxSize() const -> int;
+  /** Set the max size, the occupancy bitmap flag is cleared */
   void SetMaxSize(int max_size);
 
+  [[nodiscard]] auto HasOccupancyBitmap() const -> bool;
+  void SetOccupancyBitmap(bool has_occupancy_bitmap);
+
   [[nodiscard]] auto GetNextPageId() const -> page_id_t;
   void SetNextPageId(page_id_t next_page_id);
 
@@ -92,6 +99,9 @@ class RelationDataPage : public DataPage {
   auto Get(int index) const -> ValueType;
 
  private:
+  [[nodiscard]] auto GetOccupancyWords() const -> const occupancy_word_t *;
+  auto GetOccupancyWords() -> occupancy_word_t *;
+
   int size_;
   int max_size_;
   page_id_t next_page_id_{INVALID_PAGE_ID};
@@ -7,95 +7,201 @@
 
 #include <random/random_line_generator.h>
 #include <common/logger.h>
+#include <common/work_stealing_pool.h>
 
-#include <omp.h>
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
 #include <random>
+#include <vector>
 
 namespace distribution_lsh {
 
-template<typename ValueType>
-auto RandomLineGenerator<ValueType>::GenerateRandomLine(RandomLineDistributionType distribution_type, RandomLineNormalizationType normalization_type, int dimension) -> std::shared_ptr<ValueType[]> {
-  std::shared_ptr<ValueType[]> data (new ValueType[dimension]);
-  std::random_device rd;
-  std::mt19937 generator(rd());
+namespace {
 
-  switch (distribution_type) {
-    case RandomLineDistributionType::INVALID_DISTRIBUTION_TYPE : {
-      LOG_DEBUG("Invalid distribution type");
-      return nullptr;
-    }
-    case RandomLineDistributionType::CAUCHY : {
-      std::cauchy_distribution<> distribution(0.0, 1.0);
+/** Normalize a line in place, a line of zero norm is kept as it is */
+template<typename ValueType>
+auto NormalizeLine(ValueType *line, RandomLineNormalizationType normalization_type, int dimension) -> bool {
+  switch (normalization_type) {
+    case RandomLineNormalizationType::NONE : return true;
+    case RandomLineNormalizationType::L1_NORM : {
+      auto norm = 0.0F;
+#pragma omp simd reduction(+:norm)
       for (int i = 0; i < dimension; ++i) {
-        data[i] = static_cast<ValueType>(distribution(generator));
+        norm += std::abs(static_cast<float>(line[i]));
+      }
+      if (norm < 1E-5) {
+        return true;
       }
-      break;
-    }
-    case RandomLineDistributionType::GAUSSIAN : {
-      std::normal_distribution<> distribution(0.0, 1.0);
       for (int i = 0; i < dimension; ++i) {
-        data[i] = static_cast<ValueType>(distribution(generator));
+        line[i] = static_cast<ValueType>(line[i] / norm);
       }
-      break;
+      return true;
     }
-    default: {
-      LOG_DEBUG("Unsupported distribution type");
-      return nullptr;
+    case RandomLineNormalizationType::L2_NORM : {
+      auto norm = 0.0F;
+#pragma omp simd reduction(+:norm)
+      for (int i = 0; i < dimension; ++i) {
+        norm += static_cast<float>(line[i]) * static_cast<float>(line[i]);
+      }
+      norm = std::sqrt(norm);
+      if (norm < 1E-5) {
+        return true;
+      }
+      for (int i = 0; i < dimension; ++i) {
+        line[i] = static_cast<ValueType>(line[i] / norm);
+      }
+      return true;
     }
+    default: return false;
   }
+}
+
+/** The philox stream of the SRHT signs, line streams never reach it */
+constexpr auto HADAMARD_SIGN_STREAM = std::numeric_limits<uint64_t>::max();
 
-  return Normalization(data, normalization_type, dimension);
+/** Value of a sparse projection from a uniform word, +-scale with probability each, zero otherwise */
+inline auto ToSparse(uint32_t word, float probability, float scale) -> float {
+  auto uniform = Philox4x32::ToUniform(word);
+  if (uniform < probability) {
+    return scale;
+  }
+  return uniform < 2 * probability ? -scale : 0.0F;
 }
 
+} // namespace
+
 template<typename ValueType>
-auto RandomLineGenerator<ValueType>::Normalization(std::shared_ptr<ValueType[]> data, RandomLineNormalizationType normalization_type, int dimension) -> std::shared_ptr<ValueType[]> {
-  switch (normalization_type) {
-    case RandomLineNormalizationType::INVALID_NORMALIZATION_TYPE : {
-      LOG_DEBUG("Invalid normalization type");
-      return nullptr;
-    }
-    case RandomLineNormalizationType::NONE : {
-      return data;
-    }
-    case RandomLineNormalizationType::L1_NORM: {
-      auto norm = 0.0F;
+RandomLineGenerator<ValueType>::RandomLineGenerator()
+    : RandomLineGenerator((static_cast<uint64_t>(std::random_device{}()) << 32) | std::random_device{}()) {}
 
-#pragma omp parallel for reduction(+:norm) default(none) shared(data, dimension)
-      for (int i = 0; i < dimension; ++i) {
-        norm += std::abs(data[i]);
-      }
+template<typename ValueType>
+RandomLineGenerator<ValueType>::RandomLineGenerator(uint64_t seed) : seed_(seed), philox_(seed) {}
 
-      if (std::abs(norm - 0.0F) < 1E-5) {
-        return data;
-      }
+template<typename ValueType>
+auto RandomLineGenerator<ValueType>::GenerateRandomLine(RandomLineDistributionType distribution_type, RandomLineNormalizationType normalization_type, int dimension) -> std::shared_ptr<ValueType[]> {
+  std::shared_ptr<ValueType[]> data (new ValueType[dimension]);
+  if (!GenerateRandomLines(distribution_type, normalization_type, dimension, 1, data.get())) {
+    return nullptr;
+  }
+  return data;
+}
 
-#pragma omp parallel for shared(data, dimension, norm)
-      for (int i = 0; i < dimension; ++i) {
-        data[i] /= norm;
-      }
-      return data;
+template<typename ValueType>
+auto RandomLineGenerator<ValueType>::GenerateRandomLines(RandomLineDistributionType distribution_type,
+                                                         RandomLineNormalizationType normalization_type,
+                                                         int dimension,
+                                                         int count,
+                                                         ValueType *lines) -> bool {
+  if (distribution_type != RandomLineDistributionType::GAUSSIAN
+      && distribution_type != RandomLineDistributionType::CAUCHY
+      && distribution_type != RandomLineDistributionType::SPARSE
+      && distribution_type != RandomLineDistributionType::VERY_SPARSE
+      && distribution_type != RandomLineDistributionType::SRHT) {
+    LOG_DEBUG("Unsupported distribution type");
+    return false;
+  }
+  if (normalization_type != RandomLineNormalizationType::NONE
+      && normalization_type != RandomLineNormalizationType::L1_NORM
+      && normalization_type != RandomLineNormalizationType::L2_NORM) {
+    LOG_DEBUG("Unsupported normalization type");
+    return false;
+  }
+
+  // Line i of the stream is drawn from the philox stream i, one block gives four values
+  auto first_index = next_index_.fetch_add(static_cast<uint64_t>(count));
+  auto block_count = (dimension + 3) / 4;
+
+  // Achlioptas keeps a third of the entries, the very sparse projection 1 / sqrt(dimension) of them
+  auto sparsity = distribution_type == RandomLineDistributionType::SPARSE ? 3.0F
+      : std::max(1.0F, std::sqrt(static_cast<float>(dimension)));
+  auto sparse_probability = 1.0F / (2.0F * sparsity);
+  auto sparse_scale = std::sqrt(sparsity);
+
+  // A SRHT line is a row of the hadamard matrix with the shared random signs
+  std::vector<int> hadamard_signs;
+  if (distribution_type == RandomLineDistributionType::SRHT) {
+    hadamard_signs.resize(dimension);
+    for (int i = 0; i < dimension; ++i) {
+      hadamard_signs[i] = GetHadamardSign(i);
     }
-    case RandomLineNormalizationType::L2_NORM: {
-      auto norm = 0.0F;
+  }
 
-#pragma omp parallel for reduction(+:norm) default(none) shared(data, dimension)
-      for (int i = 0; i < dimension; ++i) {
-        norm += data[i] * data[i];
+  // Lines are independent, a task generates a range of lines
+  auto grain_size = static_cast<int>(std::max<int64_t>(PARALLEL_GRAIN_SIZE / dimension, 1));
+  ParallelFor(&WorkStealingPool::GetInstance(), 0, count, grain_size, [&](int begin, int end) {
+    for (int line_index = begin; line_index < end; ++line_index) {
+      auto line = lines + static_cast<int64_t>(line_index) * dimension;
+      if (distribution_type == RandomLineDistributionType::SRHT) {
+        auto row = static_cast<unsigned>(GetHadamardRow(first_index + line_index, dimension));
+        for (int i = 0; i < dimension; ++i) {
+          auto parity = std::popcount(row & static_cast<unsigned>(i)) & 1;
+          line[i] = static_cast<ValueType>(parity == 0 ? hadamard_signs[i] : -hadamard_signs[i]);
+        }
+        NormalizeLine(line, normalization_type, dimension);
+        continue;
       }
 
-      norm = std::sqrt(norm);
+      float values[4];
+      for (int block_index = 0; block_index < block_count; ++block_index) {
+        auto block = philox_(block_index, first_index + line_index);
+        if (distribution_type == RandomLineDistributionType::GAUSSIAN) {
+          Philox4x32::ToGaussian(block[0], block[1], &values[0], &values[1]);
+          Philox4x32::ToGaussian(block[2], block[3], &values[2], &values[3]);
+        } else if (distribution_type == RandomLineDistributionType::CAUCHY) {
+          for (int i = 0; i < 4; ++i) {
+            values[i] = Philox4x32::ToCauchy(block[i]);
+          }
+        } else {
+          for (int i = 0; i < 4; ++i) {
+            values[i] = ToSparse(block[i], sparse_probability, sparse_scale);
+          }
+        }
 
-#pragma omp parallel for default(none) shared(data, dimension, norm)
-      for (int i = 0; i < dimension; ++i) {
-        data[i] /= norm;
+        auto width = std::min(4, dimension - block_index * 4);
+        for (int i = 0; i < width; ++i) {
+          line[block_index * 4 + i] = static_cast<ValueType>(values[i]);
+        }
       }
-      return data;
-    }
-    default: {
-      LOG_DEBUG("Unsupported normalization type");
-      return nullptr;
+      NormalizeLine(line, normalization_type, dimension);
     }
+  });
+
+  return true;
+}
+
+template<typename ValueType>
+auto RandomLineGenerator<ValueType>::GetHadamardDimension(int dimension) -> int {
+  return static_cast<int>(std::bit_ceil(static_cast<unsigned>(std::max(dimension, 1))));
+}
+
+template<typename ValueType>
+auto RandomLineGenerator<ValueType>::GetHadamardRow(uint64_t index, int dimension) const -> int {
+  // Rows are sampled with replacement, the hadamard dimension is a power of two
+  return static_cast<int>(philox_(0, index)[0] & static_cast<uint32_t>(GetHadamardDimension(dimension) - 1));
+}
+
+template<typename ValueType>
+auto RandomLineGenerator<ValueType>::GetHadamardSign(int position) const -> int {
+  // One block holds the signs of 128 positions
+  auto block = philox_(static_cast<uint64_t>(position) / 128, HADAMARD_SIGN_STREAM);
+  auto bit = (block[(position % 128) / 32] >> (position % 32)) & 1U;
+  return bit == 0 ? 1 : -1;
+}
+
+template<typename ValueType>
+auto RandomLineGenerator<ValueType>::Normalization(std::shared_ptr<ValueType[]> data, RandomLineNormalizationType normalization_type, int dimension) -> std::shared_ptr<ValueType[]> {
+  // A single line is too small to be split across threads
+  if (normalization_type == RandomLineNormalizationType::INVALID_NORMALIZATION_TYPE) {
+    LOG_DEBUG("Invalid normalization type");
+    return nullptr;
+  }
+  if (!NormalizeLine(data.get(), normalization_type, dimension)) {
+    LOG_DEBUG("Unsupported normalization type");
+    return nullptr;
   }
+  return data;
 }
 
 template class RandomLineGenerator<int>;
@@ -33,6 +33,10 @@ void DiskScheduler::Schedule(distribution_lsh::DiskRequest r) {
     disk_manager_->ReadPage(r.page_id_, r.data_);
     r.callback_.set_value(true);
   }
+
+  if (r.continuation_) {
+    r.continuation_(true);
+  }
 }
 
 void DiskScheduler::StartWorkerThread() {
@@ -40,6 +40,8 @@ auto B_PLUS_TREE_TYPE::IsEmpty(Context *ctx, bool is_read) -> bool {
     return false;
   }
 
+  // The guard keeps the header page pinned while it is read
+  std::optional<ReadPageGuard> header_page_guard;
   auto header_page = ctx != nullptr && !is_read ? [&]() {
     if (ctx->header_page_.has_value()) {
       return ctx->header_page_.value().template As<BPlusTreeHeaderPage>();
@@ -49,7 +51,7 @@ auto B_PLUS_TREE_TYPE::IsEmpty(Context *ctx, bool is_read) -> bool {
   }() : [&]() {
     return ctx != nullptr && ctx->header_page_.has_value() ?
           ctx->header_page_.value().template As<BPlusTreeHeaderPage>()
-          : bpm_->FetchPageRead(header_page_id_).template As<BPlusTreeHeaderPage>();
+          : (header_page_guard = bpm_->FetchPageRead(header_page_id_))->template As<BPlusTreeHeaderPage>();
   }();
   return header_page->root_page_id_ == INVALID_PAGE_ID || header_page->root_page_id_ == HEADER_PAGE_ID;
 }
@@ -719,6 +721,85 @@ auto B_PLUS_TREE_TYPE::RangeRead(const BPlusTreeKeyType &lkey, const BPlusTreeKe
 }
 
 
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_TYPE::Scan(std::vector<std::pair<BPlusTreeKeyType, BPlusTreeValueType>> *result) -> bool {
+  if (IsEmpty()) {
+    return false;
+  }
+
+  // Descend along the leftmost children, a page is released only once the next one is pinned
+  auto header_page_guard = bpm_->FetchPageRead(header_page_id_);
+  auto page_guard = bpm_->FetchPageRead(header_page_guard.template As<BPlusTreeHeaderPage>()->root_page_id_);
+  header_page_guard.Drop();
+  while (!page_guard.template As<BPlusTreePage>()->IsLeafPage()) {
+    auto child_page_guard = bpm_->FetchPageRead(page_guard.template As<InternalPage>()->ValueAt(0));
+    page_guard = std::move(child_page_guard);
+  }
+
+  while (true) {
+    auto leaf_page = page_guard.template As<LeafPage>();
+    for (int i = 0; i < leaf_page->GetSize(); ++i) {
+      result->emplace_back(leaf_page->array_[i]);
+    }
+    if (leaf_page->GetNextPageId() == INVALID_PAGE_ID) {
+      break;
+    }
+    auto next_page_guard = bpm_->FetchPageRead(leaf_page->GetNextPageId());
+    page_guard = std::move(next_page_guard);
+  }
+  return !result->empty();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+auto B_PLUS_TREE_TYPE::RangeReadAsync(BPlusTreeKeyType lkey,
+                                      BPlusTreeKeyType rkey,
+                                      std::vector<BPlusTreeValueType> *result) -> Task<bool> {
+  if (lkey >= rkey || header_page_id_ == INVALID_PAGE_ID) {
+    co_return false;
+  }
+
+  page_id_t page_id;
+  {
+    auto header_page_guard = co_await bpm_->FetchPageReadAsync(header_page_id_);
+    page_id = header_page_guard.template As<BPlusTreeHeaderPage>()->root_page_id_;
+  }
+  if (page_id == INVALID_PAGE_ID || page_id == HEADER_PAGE_ID) {
+    co_return false;
+  }
+
+  // Descend to the leaf of the left key, then scan the leaves rightwards until a key passes the right key. One page is
+  // pinned at a time: its read latch is owned by the thread the coroutine runs on, so it is released before the next
+  // fetch, which may resume on another thread. A split in between only moves keys to right siblings, which the scan
+  // goes through. A Delete in between may coalesce the next page into its left sibling and free it, so the tree must
+  // not be deleted from while the read runs.
+  while (page_id != INVALID_PAGE_ID) {
+    auto page_guard = co_await bpm_->FetchPageReadAsync(page_id);
+    auto current_page = page_guard.template As<BPlusTreePage>();
+    if (!current_page->IsLeafPage()) {
+      const InternalPage *internal_page = reinterpret_cast<const InternalPage*>(current_page);
+      auto pos = 0;
+      while (pos < internal_page->GetSize() && internal_page->KeyAt(pos + 1) < lkey) { pos++; }
+      // Obtain correct number
+      pos = pos != internal_page->GetSize() && std::abs(lkey - internal_page->KeyAt(pos + 1)) <= 1E-10 ? pos + 1 : pos;
+      page_id = internal_page->ValueAt(pos);
+      continue;
+    }
+
+    auto leaf_page = reinterpret_cast<const LeafPage *>(current_page);
+    for (int i = 0; i < leaf_page->GetSize(); ++i) {
+      const auto &key = leaf_page->array_[i].first;
+      if (rkey < key && std::abs(rkey - key) > 1E-10) {
+        co_return !result->empty();
+      }
+      if (lkey < key || std::abs(lkey - key) <= 1E-10) {
+        result->emplace_back(leaf_page->array_[i].second);
+      }
+    }
+    page_id = leaf_page->GetNextPageId();
+  }
+  co_return !result->empty();
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_TYPE::SubTreeToString(page_id_t page_id, const BPlusTreePage *page, std::stringstream &ss) {
   if (page->IsLeafPage()) {
@@ -0,0 +1,82 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/storage/index/multi_probe.cpp
+//
+//===-----------------------------------------------------
+
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+#include <common/exception.h>
+#include <storage/index/multi_probe.h>
+
+namespace distribution_lsh {
+
+MULTI_PROBE_TEMPLATE
+MULTI_PROBE_TYPE::MultiProbeSequence(std::vector<ValueType> projections,
+                                     ValueType bucket_width,
+                                     float scale,
+                                     RandomLineDistributionType distribution_type)
+    : projections_(std::move(projections)),
+      bucket_width_(bucket_width),
+      scale_(scale > 0 ? scale : static_cast<float>(bucket_width) / 2),
+      distribution_type_(distribution_type) {
+  if (bucket_width_ <= 0) {
+    throw Exception(ExceptionType::INVALID_ARGUMENT, "Bucket width of multi-probe must be positive");
+  }
+
+  home_buckets_.reserve(projections_.size());
+  for (const auto &projection : projections_) {
+    home_buckets_.emplace_back(static_cast<int64_t>(std::floor(projection / bucket_width_)));
+  }
+
+  // The nearest neighbour on each side of every line starts the queue
+  for (int line = 0; line < static_cast<int>(projections_.size()); ++line) {
+    neighbours_.push(MakeInterval(line, 1));
+    neighbours_.push(MakeInterval(line, -1));
+  }
+}
+
+MULTI_PROBE_TEMPLATE
+auto MULTI_PROBE_TYPE::Next(ProbeInterval<ValueType> *interval) -> bool {
+  if (projections_.empty()) {
+    return false;
+  }
+
+  // Home buckets of all the lines first
+  if (probe_count_ < static_cast<int>(projections_.size())) {
+    *interval = MakeInterval(probe_count_++, 0);
+    return true;
+  }
+
+  *interval = neighbours_.top();
+  neighbours_.pop();
+  neighbours_.push(MakeInterval(interval->line_, interval->bucket_ > 0 ? interval->bucket_ + 1 : interval->bucket_ - 1));
+  ++probe_count_;
+  return true;
+}
+
+MULTI_PROBE_TEMPLATE
+auto MULTI_PROBE_TYPE::MakeInterval(int line, int bucket) const -> ProbeInterval<ValueType> {
+  auto lkey = static_cast<ValueType>((home_buckets_[line] + bucket) * bucket_width_);
+  auto rkey = static_cast<ValueType>(lkey + bucket_width_);
+  auto projection = static_cast<float>(projections_[line]);
+  auto probability = Cdf((static_cast<float>(rkey) - projection) / scale_)
+      - Cdf((static_cast<float>(lkey) - projection) / scale_);
+  return {line, bucket, lkey, rkey, probability};
+}
+
+MULTI_PROBE_TEMPLATE
+auto MULTI_PROBE_TYPE::Cdf(float x) const -> float {
+  if (distribution_type_ == RandomLineDistributionType::CAUCHY) {
+    return 0.5F + std::atan(x) / std::numbers::pi_v<float>;
+  }
+  return 0.5F * std::erfc(-x / std::numbers::sqrt2_v<float>);
+}
+
+template class MultiProbeSequence<float>;
+template class MultiProbeSequence<double>;
+
+} // namespace distribution_lsh
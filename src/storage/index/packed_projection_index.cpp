@@ -0,0 +1,143 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/storage/index/packed_projection_index.cpp
+//
+//===-----------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include <common/exception.h>
+#include <storage/index/packed_projection_index.h>
+
+namespace distribution_lsh {
+
+namespace {
+
+struct PackedIndexHeader {
+  uint64_t magic_;
+  uint32_t line_count_;
+  uint32_t record_size_;
+};
+
+struct PackedIndexLine {
+  int64_t random_line_rid_;
+  int64_t offset_;    // offset of the first record, in records
+  int64_t size_;
+};
+
+/** Header is padded to 64 bytes, records start at a multiple of 64 bytes */
+constexpr auto AlignPackedIndexOffset(int64_t offset) -> int64_t { return (offset + 63) / 64 * 64; }
+
+constexpr auto GetLinesOffset() -> int64_t { return AlignPackedIndexOffset(sizeof(PackedIndexHeader)); }
+
+constexpr auto GetRecordsOffset(int64_t line_count) -> int64_t {
+  return AlignPackedIndexOffset(GetLinesOffset() + line_count * static_cast<int64_t>(sizeof(PackedIndexLine)));
+}
+
+} // namespace
+
+PACKED_INDEX_TEMPLATE
+PACKED_INDEX_TYPE::PackedProjectionIndex(const std::string &file_name, int fence_interval)
+    : file_(file_name, MADV_RANDOM), fence_interval_(std::max(fence_interval, 1)) {
+  PackedIndexHeader header{};
+  if (file_.Size() < sizeof(PackedIndexHeader)) {
+    throw Exception("Invalid packed index file " + file_name);
+  }
+  memcpy(&header, file_.Data(), sizeof(PackedIndexHeader));
+  if (header.magic_ != PACKED_INDEX_MAGIC || header.record_size_ != sizeof(ProjectionRecord<ValueType>)
+      || static_cast<int64_t>(file_.Size()) < GetRecordsOffset(header.line_count_)) {
+    throw Exception("Invalid packed index file " + file_name);
+  }
+
+  auto records = reinterpret_cast<const ProjectionRecord<ValueType> *>(file_.Data() + GetRecordsOffset(header.line_count_));
+  auto record_count = (static_cast<int64_t>(file_.Size()) - GetRecordsOffset(header.line_count_))
+      / static_cast<int64_t>(sizeof(ProjectionRecord<ValueType>));
+  for (uint32_t i = 0; i < header.line_count_; ++i) {
+    PackedIndexLine line{};
+    memcpy(&line, file_.Data() + GetLinesOffset() + i * sizeof(PackedIndexLine), sizeof(PackedIndexLine));
+    if (line.offset_ < 0 || line.size_ < 0 || line.offset_ + line.size_ > record_count) {
+      throw Exception("Truncated packed index file " + file_name);
+    }
+
+    // Sample the fences, the only part of a line kept in memory
+    LineIndex line_index{records + line.offset_, line.size_, {}};
+    line_index.fences_.reserve((line.size_ + fence_interval_ - 1) / fence_interval_);
+    for (int64_t j = 0; j < line.size_; j += fence_interval_) {
+      line_index.fences_.emplace_back(line_index.records_[j].value_);
+    }
+    lines_.emplace(RID(line.random_line_rid_), std::move(line_index));
+  }
+}
+
+PACKED_INDEX_TEMPLATE
+void PACKED_INDEX_TYPE::Build(const std::string &file_name, std::span<const Line> lines) {
+  std::ofstream ofs(file_name, std::ios::binary | std::ios::trunc);
+  if (!ofs.is_open()) {
+    throw Exception("Cannot open packed index file " + file_name);
+  }
+
+  PackedIndexHeader header{PACKED_INDEX_MAGIC, static_cast<uint32_t>(lines.size()), sizeof(ProjectionRecord<ValueType>)};
+  std::vector<char> padding(64, 0);
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(PackedIndexHeader));
+  ofs.write(padding.data(), GetLinesOffset() - static_cast<int64_t>(sizeof(PackedIndexHeader)));
+
+  auto offset = static_cast<int64_t>(0);
+  for (const auto &[random_line_rid, records] : lines) {
+    PackedIndexLine line{random_line_rid.Get(), offset, static_cast<int64_t>(records.size())};
+    ofs.write(reinterpret_cast<const char *>(&line), sizeof(PackedIndexLine));
+    offset += line.size_;
+  }
+  ofs.write(padding.data(), GetRecordsOffset(static_cast<int64_t>(lines.size())) - GetLinesOffset()
+      - static_cast<int64_t>(lines.size() * sizeof(PackedIndexLine)));
+
+  std::vector<ProjectionRecord<ValueType>> sorted_records;
+  for (const auto &[random_line_rid, records] : lines) {
+    sorted_records.assign(records.begin(), records.end());
+    std::stable_sort(sorted_records.begin(), sorted_records.end(),
+                     [](const auto &left, const auto &right) { return left.value_ < right.value_; });
+    ofs.write(reinterpret_cast<const char *>(sorted_records.data()),
+              static_cast<std::streamsize>(sorted_records.size() * sizeof(ProjectionRecord<ValueType>)));
+  }
+
+  if (!ofs.good()) {
+    throw Exception("Failed to write packed index file " + file_name);
+  }
+}
+
+PACKED_INDEX_TEMPLATE
+auto PACKED_INDEX_TYPE::GetSize(const RID &random_line_rid) const -> int64_t {
+  auto iterator = lines_.find(random_line_rid);
+  return iterator == lines_.end() ? -1 : iterator->second.size_;
+}
+
+PACKED_INDEX_TEMPLATE
+auto PACKED_INDEX_TYPE::RangeRead(const RID &random_line_rid,
+                                  ValueType lkey,
+                                  ValueType rkey,
+                                  std::vector<RID> *result) const -> bool {
+  auto iterator = lines_.find(random_line_rid);
+  if (lkey > rkey || iterator == lines_.end()) {
+    return false;
+  }
+  const auto &line = iterator->second;
+
+  // The last fence below lkey starts the block holding the first record in range
+  auto fence = std::lower_bound(line.fences_.begin(), line.fences_.end(), lkey);
+  auto start = fence == line.fences_.begin() ? 0 : (fence - line.fences_.begin() - 1) * fence_interval_;
+  auto block_end = std::min<int64_t>(start + fence_interval_, line.size_);
+  auto first = std::lower_bound(line.records_ + start, line.records_ + block_end, lkey,
+                                [](const auto &record, ValueType key) { return record.value_ < key; });
+
+  // Scan sequentially up to rkey
+  for (auto record = first; record != line.records_ + line.size_ && record->value_ <= rkey; ++record) {
+    result->emplace_back(record->GetRID());
+  }
+  return true;
+}
+
+template class PackedProjectionIndex<float>;
+
+} // namespace distribution_lsh
@@ -0,0 +1,133 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// src/storage/index/projection_column.cpp
+//
+//===-----------------------------------------------------
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+
+#include <common/exception.h>
+#include <common/logger.h>
+#include <storage/index/projection_column.h>
+
+namespace distribution_lsh {
+
+namespace {
+
+struct ProjectionColumnHeader {
+  uint64_t magic_;
+  uint32_t record_size_;
+  uint32_t reserved_;
+};
+
+template<typename ValueType>
+auto IsValidProjectionColumnHeader(const ProjectionColumnHeader &header) -> bool {
+  return header.magic_ == PROJECTION_COLUMN_MAGIC && header.record_size_ == sizeof(ProjectionRecord<ValueType>);
+}
+
+} // namespace
+
+PROJECTION_COLUMN_TEMPLATE
+ProjectionColumnWriter<ValueType>::ProjectionColumnWriter(std::string file_name, int buffer_size)
+    : file_name_(std::move(file_name)), buffer_size_(static_cast<size_t>(std::max(buffer_size, 1))) {
+  std::error_code error_code;
+  auto file_size = std::filesystem::file_size(file_name_, error_code);
+  auto is_new = error_code || file_size == 0;
+
+  if (!is_new) {
+    ProjectionColumnHeader header{};
+    std::ifstream ifs(file_name_, std::ios::binary);
+    ifs.read(reinterpret_cast<char *>(&header), sizeof(ProjectionColumnHeader));
+    if (!ifs || !IsValidProjectionColumnHeader<ValueType>(header)) {
+      throw Exception("Invalid projection column file " + file_name_);
+    }
+
+    // Drop a record torn by a crash, so that the appended ones stay aligned
+    auto record_bytes = (file_size - sizeof(ProjectionColumnHeader)) % sizeof(ProjectionRecord<ValueType>);
+    if (record_bytes != 0) {
+      std::filesystem::resize_file(file_name_, file_size - record_bytes);
+    }
+  }
+
+  ofs_.open(file_name_, std::ios::binary | std::ios::app);
+  if (!ofs_.is_open()) {
+    throw Exception("Cannot open projection column file " + file_name_);
+  }
+
+  if (is_new) {
+    ProjectionColumnHeader header{PROJECTION_COLUMN_MAGIC, sizeof(ProjectionRecord<ValueType>), 0};
+    ofs_.write(reinterpret_cast<const char *>(&header), sizeof(ProjectionColumnHeader));
+    ofs_.flush();
+  }
+  buffer_.reserve(buffer_size_);
+}
+
+PROJECTION_COLUMN_TEMPLATE
+ProjectionColumnWriter<ValueType>::~ProjectionColumnWriter() {
+  try {
+    Flush();
+  } catch (Exception &) {
+    LOG_DEBUG("Failed to flush projection column");
+  }
+}
+
+PROJECTION_COLUMN_TEMPLATE
+void ProjectionColumnWriter<ValueType>::Append(ValueType value, const RID &rid) {
+  std::scoped_lock<std::mutex> lock(latch_);
+  buffer_.push_back({value, rid.GetPageId(), rid.GetSlotNum()});
+  if (buffer_.size() >= buffer_size_) {
+    FlushLocked();
+  }
+}
+
+PROJECTION_COLUMN_TEMPLATE
+void ProjectionColumnWriter<ValueType>::Flush() {
+  std::scoped_lock<std::mutex> lock(latch_);
+  FlushLocked();
+}
+
+PROJECTION_COLUMN_TEMPLATE
+void ProjectionColumnWriter<ValueType>::FlushLocked() {
+  if (buffer_.empty()) {
+    return;
+  }
+
+  ofs_.write(reinterpret_cast<const char *>(buffer_.data()),
+             static_cast<std::streamsize>(buffer_.size() * sizeof(ProjectionRecord<ValueType>)));
+  ofs_.flush();
+  buffer_.clear();
+  if (!ofs_.good()) {
+    throw Exception("Failed to write projection column file " + file_name_);
+  }
+}
+
+PROJECTION_COLUMN_TEMPLATE
+ProjectionColumnReader<ValueType>::ProjectionColumnReader(const std::string &file_name) : file_(file_name) {
+  ProjectionColumnHeader header{};
+  if (file_.Size() < sizeof(ProjectionColumnHeader)) {
+    throw Exception("Invalid projection column file " + file_name);
+  }
+  memcpy(&header, file_.Data(), sizeof(ProjectionColumnHeader));
+  if (!IsValidProjectionColumnHeader<ValueType>(header)) {
+    throw Exception("Invalid projection column file " + file_name);
+  }
+
+  size_ = (file_.Size() - sizeof(ProjectionColumnHeader)) / sizeof(ProjectionRecord<ValueType>);
+}
+
+PROJECTION_COLUMN_TEMPLATE
+auto ProjectionColumnReader<ValueType>::GetRecords() const -> std::span<const ProjectionRecord<ValueType>> {
+  if (size_ == 0) {
+    return {};
+  }
+  return {reinterpret_cast<const ProjectionRecord<ValueType> *>(file_.Data() + sizeof(ProjectionColumnHeader)), size_};
+}
+
+template struct ProjectionRecord<float>;
+template class ProjectionColumnWriter<float>;
+template class ProjectionColumnReader<float>;
+
+} // namespace distribution_lsh
@@ -5,10 +5,10 @@
 //
 //===-----------------------------------------------------
 
+#include <algorithm>
 #include <cmath>
 #include <sstream>
 #include <numeric>
-#include <omp.h>
 
 #include <fmt/core.h>
 #include <fmt/format.h>
@@ -53,6 +53,19 @@ RANDOM_LINE_MANAGER_TYPE::RandomLineManager(
     distribution_type_ = header_page->GetDistributionType();
     normalization_type_ = header_page->GetNormalizationType();
     epsilon_ = header_page->GetEpsilon();
+    is_seeded_ = header_page->IsSeeded();
+    seed_ = header_page->GetSeed();
+    auto size = header_page->GetSize();
+    auto format_version = header_page->GetFormatVersion();
+    header_page_guard.Drop();
+    if (!is_seeded_) {
+      BuildDirectoryIndex();
+      if (format_version == 0) {
+        UpgradeLegacyHeaderPage();
+      }
+    } else if (!GenerateSeededRandomLines(0, size)) {
+      throw Exception("Regenerate seed-defined random line group failed.");
+    }
   } else {
     auto header_page_basic_guard = bpm_->NewPageGuarded(&header_page_id_);
     if (header_page_id_ == INVALID_PAGE_ID || header_page_id_ != HEADER_PAGE_ID) {
@@ -81,6 +94,8 @@ auto RANDOM_LINE_MANAGER_TYPE::IsEmpty(RandomLineContext *ctx, bool is_read) ->
     throw Exception(fmt::format(fg(fmt::color::red), "[ERROR] RANDOM LINE MANAGER: header page id is not valid, current header page id is: {}.", header_page_id_));
   }
 
+  // The guard keeps the header page pinned while it is read
+  std::optional<ReadPageGuard> header_page_guard;
   auto header_page = ctx != nullptr && !is_read ? [&]() {
     if (ctx->header_page_.has_value()) {
       return ctx->header_page_.value().template As<RandomLineHeaderPage>();
@@ -90,7 +105,7 @@ auto RANDOM_LINE_MANAGER_TYPE::IsEmpty(RandomLineContext *ctx, bool is_read) ->
   }() : [&]() {
     return ctx != nullptr && ctx->header_page_.has_value() ?
     ctx->header_page_.value().template As<RandomLineHeaderPage>()
-    : bpm_->FetchPageRead(header_page_id_).template As<RandomLineHeaderPage>();
+    : (header_page_guard = bpm_->FetchPageRead(header_page_id_))->template As<RandomLineHeaderPage>();
   }();
 
   return header_page->IsEmpty();
@@ -99,6 +114,17 @@ auto RANDOM_LINE_MANAGER_TYPE::IsEmpty(RandomLineContext *ctx, bool is_read) ->
 RANDOM_LINE_TEMPLATE
 auto RANDOM_LINE_MANAGER_TYPE::GenerateRandomLineGroup(int group_size) -> bool {
   RandomLineContext ctx;
+  if (is_seeded_) {
+    // Extend a seed-defined group by the next lines of its stream
+    ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+    auto header_page = ctx.header_page_.value().AsMut<RandomLineHeaderPage>();
+    if (!GenerateSeededRandomLines(header_page->GetSize(), header_page->GetSize() + group_size)) {
+      return false;
+    }
+    header_page->IncreaseSize(group_size);
+    return true;
+  }
+
   if (IsEmpty(&ctx, false)) {
     auto header_page = ctx.header_page_.value().AsMut<RandomLineHeaderPage>();
     auto directory_page_guard = bpm_->NewPageGuarded(&header_page->directory_page_start_page_id_);
@@ -110,6 +136,7 @@ auto RANDOM_LINE_MANAGER_TYPE::GenerateRandomLineGroup(int group_size) -> bool {
 
     auto directory_page = directory_page_guard.template AsMut<RandomLineDirectoryPage>();
     directory_page->Init(directory_page_max_size_);
+    directory_page_ids_.assign({header_page->GetDirectoryPageStartPageId()});
 
     // Use average random line
     if (epsilon_ > 0) {
@@ -122,41 +149,153 @@ auto RANDOM_LINE_MANAGER_TYPE::GenerateRandomLineGroup(int group_size) -> bool {
     }
   }
 
-  // Generate random line group
+  // Keep the average random line in memory while testing candidates
+  if (epsilon_ > 0 && average_random_line_.empty() && !LoadAverageRandomLine(&ctx)) {
+    LOG_DEBUG("load average random line failed.");
+    return false;
+  }
+
+  // Generate candidates in batches, test them in order against the running average
+  auto factor = static_cast<RandomLineValueType>(GetSize(&ctx));
+  auto average = average_random_line_.data();
+  std::vector<RandomLineValueType> candidates;
+  std::vector<RandomLineValueType> accepted_lines;
+  accepted_lines.reserve(static_cast<size_t>(group_size) * dimension_);
   auto current_size = 0;
   while (current_size < group_size) {
-    std::shared_ptr<RandomLineValueType[]> array = rlg_->GenerateRandomLine(distribution_type_, normalization_type_, dimension_);
-    if (array == nullptr) {
+    auto batch_size = std::min(group_size - current_size, RANDOM_LINE_GENERATION_BATCH_SIZE);
+    candidates.resize(static_cast<size_t>(batch_size) * dimension_);
+    if (!rlg_->GenerateRandomLines(distribution_type_, normalization_type_, dimension_, batch_size, candidates.data())) {
       LOG_DEBUG("generate new array failed.");
       return false;
     }
 
-    if (epsilon_ > 0) {
-      auto header_page = ctx.header_page_.has_value()?
-          ctx.header_page_.value().template As<RandomLineHeaderPage>()
-              : bpm_->FetchPageRead(header_page_id_).template As<RandomLineHeaderPage>();
-      if (static_cast<float>(std::abs(InnerProduct(header_page->average_random_line_page_id_, array))) > epsilon_) {
-        continue;
+    for (int candidate_index = 0; candidate_index < batch_size; ++candidate_index) {
+      auto candidate = candidates.data() + static_cast<int64_t>(candidate_index) * dimension_;
+      if (epsilon_ > 0) {
+        auto inner_product = static_cast<RandomLineValueType>(0);
+#pragma omp simd reduction(+:inner_product)
+        for (int i = 0; i < dimension_; ++i) {
+          inner_product += average[i] * candidate[i];
+        }
+        if (static_cast<float>(std::abs(inner_product)) > epsilon_) {
+          continue;
+        }
+
+        //  Update average random line
+#pragma omp simd
+        for (int i = 0; i < dimension_; ++i) {
+          average[i] = (average[i] * factor + candidate[i]) / (factor + 1);
+        }
+        factor += 1;
       }
+
+      accepted_lines.insert(accepted_lines.end(), candidate, candidate + dimension_);
+      current_size++;
     }
+  }
 
+  // Store the random lines, none of them is stored on a failure
+  if (!Store(accepted_lines.data(), group_size, &ctx)) {
+    // The average in memory is ahead of the flushed one, read it again next time
+    average_random_line_.clear();
+    return false;
+  }
 
-    // Store the random line
-    if (!Store(array, &ctx)) {
-      return false;
-    }
+  if (epsilon_ > 0) {
+    FlushAverageRandomLine(&ctx);
+  }
 
-    if (epsilon_ > 0) {
-      //  Update average random line
-      UpdateAverageRandomLine(array, &ctx);
-    }
+  return true;
+}
 
-    current_size++;
+RANDOM_LINE_TEMPLATE
+auto RANDOM_LINE_MANAGER_TYPE::GenerateSeededRandomLineGroup(int group_size, uint64_t seed) -> bool {
+  RandomLineContext ctx;
+  if (!IsEmpty(&ctx, false)) {
+    LOG_DEBUG("random line group is not empty.");
+    return false;
   }
 
+  seed_ = seed;
+  is_seeded_ = true;
+  if (!GenerateSeededRandomLines(0, group_size)) {
+    is_seeded_ = false;
+    return false;
+  }
+
+  // Only the parameters of the stream are persisted
+  epsilon_ = 0.0F;
+  auto header_page = ctx.header_page_.value().AsMut<RandomLineHeaderPage>();
+  header_page->SetEpsilon(epsilon_);
+  header_page->SetSeed(seed);
+  header_page->SetSize(group_size);
   return true;
 }
 
+RANDOM_LINE_TEMPLATE
+auto RANDOM_LINE_MANAGER_TYPE::GenerateSeededRandomLines(int start, int size) -> bool {
+  RandomLineGenerator<RandomLineValueType> generator(seed_);
+  generator.SetNextIndex(static_cast<uint64_t>(start));
+  seeded_random_lines_.resize(static_cast<size_t>(size) * dimension_);
+  if (size > start && !generator.GenerateRandomLines(distribution_type_,
+                                                     normalization_type_,
+                                                     dimension_,
+                                                     size - start,
+                                                     seeded_random_lines_.data() + static_cast<int64_t>(start) * dimension_)) {
+    seeded_random_lines_.resize(static_cast<size_t>(start) * dimension_);
+    LOG_DEBUG("generate seed-defined random lines failed.");
+    return false;
+  }
+
+  // Keep the structure of the new lines for their projection kernels
+  if (IsSparseDistributionType(distribution_type_)) {
+    seeded_sparse_offsets_.resize(start + 1, 0);
+    seeded_sparse_entries_.resize(seeded_sparse_offsets_[start]);
+    for (int index = start; index < size; ++index) {
+      auto line = seeded_random_lines_.data() + static_cast<int64_t>(index) * dimension_;
+      for (int i = 0; i < dimension_; ++i) {
+        if (line[i] != 0) {
+          seeded_sparse_entries_.push_back({i, line[i]});
+        }
+      }
+      seeded_sparse_offsets_.emplace_back(static_cast<int64_t>(seeded_sparse_entries_.size()));
+    }
+  } else if (distribution_type_ == RandomLineDistributionType::SRHT) {
+    seeded_hadamard_signs_.resize(dimension_);
+    for (int i = 0; i < dimension_; ++i) {
+      seeded_hadamard_signs_[i] = generator.GetHadamardSign(i);
+    }
+    seeded_hadamard_rows_.resize(start);
+    for (int index = start; index < size; ++index) {
+      seeded_hadamard_rows_.emplace_back(generator.GetHadamardRow(static_cast<uint64_t>(index), dimension_));
+    }
+  }
+  return true;
+}
+
+RANDOM_LINE_TEMPLATE
+auto RANDOM_LINE_MANAGER_TYPE::SeededInnerProduct(int index, const RandomLineValueType *outer_array) -> RandomLineValueType {
+  if (index < 0 || static_cast<size_t>(index + 1) * dimension_ > seeded_random_lines_.size()) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, fmt::format(fg(fmt::color::red), "[ERROR] RANDOM LINE MANAGER: index out of range, invalid index {} input.", index));
+  }
+
+  auto result = static_cast<RandomLineValueType>(0);
+  if (IsSparseDistributionType(distribution_type_)) {
+    for (auto i = seeded_sparse_offsets_[index]; i < seeded_sparse_offsets_[index + 1]; ++i) {
+      result += seeded_sparse_entries_[i].value_ * outer_array[seeded_sparse_entries_[i].index_];
+    }
+    return result;
+  }
+
+  auto line = seeded_random_lines_.data() + static_cast<int64_t>(index) * dimension_;
+#pragma omp simd reduction(+:result)
+  for (int i = 0; i < dimension_; ++i) {
+    result += line[i] * outer_array[i];
+  }
+  return result;
+}
+
 RANDOM_LINE_TEMPLATE
 auto RANDOM_LINE_MANAGER_TYPE::StoreAverageRandomLine(std::shared_ptr<RandomLineValueType[]> array, RandomLineContext *ctx) -> bool {
   RandomLineContext random_line_ctx;
@@ -189,7 +328,7 @@ auto RANDOM_LINE_MANAGER_TYPE::StoreAverageRandomLine(std::shared_ptr<RandomLine
        current_size += current_average_random_line_page->GetMaxSize()) {
     if (dimension_ - current_size > current_average_random_line_page->GetMaxSize()) {
       memcpy(reinterpret_cast<char *>(current_average_random_line_page->array_),
-             reinterpret_cast<char *>(&array[current_size]),
+             reinterpret_cast<const char *>(&array[current_size]),
              sizeof(RandomLineValueType) * current_average_random_line_page->GetMaxSize());
       current_average_random_line_page->SetSize(current_average_random_line_page->GetMaxSize());
 
@@ -223,7 +362,7 @@ auto RANDOM_LINE_MANAGER_TYPE::StoreAverageRandomLine(std::shared_ptr<RandomLine
 
       random_line_ctx.write_set_.pop_front();
     } else {
-      memcpy(reinterpret_cast<char *>(current_average_random_line_page->array_), reinterpret_cast<char *>(&array[current_size]),
+      memcpy(reinterpret_cast<char *>(current_average_random_line_page->array_), reinterpret_cast<const char *>(&array[current_size]),
              sizeof(RandomLineValueType) * (dimension_ - current_size));
       current_average_random_line_page->SetSize(dimension_ - current_size);
     }
@@ -235,8 +374,13 @@ auto RANDOM_LINE_MANAGER_TYPE::StoreAverageRandomLine(std::shared_ptr<RandomLine
 
 RANDOM_LINE_TEMPLATE
 auto RANDOM_LINE_MANAGER_TYPE::Store(std::shared_ptr<RandomLineValueType[]> array, RandomLineContext *ctx) -> bool {
+  return Store(array.get(), 1, ctx);
+}
+
+RANDOM_LINE_TEMPLATE
+auto RANDOM_LINE_MANAGER_TYPE::Store(const RandomLineValueType *lines, int count, RandomLineContext *ctx) -> bool {
   RandomLineContext random_line_ctx;
-  // Get header page
+  // Get header page, its latch guards the directory index and the size
   RandomLineHeaderPage* header_page =
       ctx != nullptr && ctx->header_page_.has_value()?
               ctx->header_page_.value().AsMut<RandomLineHeaderPage>()
@@ -246,98 +390,158 @@ auto RANDOM_LINE_MANAGER_TYPE::Store(std::shared_ptr<RandomLineValueType[]> arra
 
   // Locate the latest header_page
   RandomLineContext directory_page_ctx;
-  RandomLineContext data_page_ctx;
 
-  auto directory_page_guard = bpm_->FetchPageWrite(header_page->directory_page_start_page_id_);
-  directory_page_ctx.write_set_.emplace_back(std::move(directory_page_guard));
+  if (directory_page_ids_.empty()) {
+    LOG_DEBUG("directory page of random line group is not allocated.");
+    return false;
+  }
+
+  directory_page_ctx.write_set_.emplace_back(bpm_->FetchPageWrite(directory_page_ids_.back()));
   auto directory_page = directory_page_ctx.write_set_.back().AsMut<RandomLineDirectoryPage>();
-  while (directory_page->GetNextPageId() != INVALID_PAGE_ID) {
-    directory_page_guard = bpm_->FetchPageWrite(directory_page->GetNextPageId());
-    directory_page_ctx.write_set_.emplace_back(std::move(directory_page_guard));
-    directory_page = directory_page_ctx.write_set_.back().AsMut<RandomLineDirectoryPage>();
-    directory_page_ctx.write_set_.pop_front();
+
+  // Pages allocated by this append, deleted if it fails before the lines are published
+  std::vector<page_id_t> new_directory_page_ids;
+  std::vector<page_id_t> random_line_page_ids;
+  auto roll_back = [&]() {
+    directory_page_ctx.write_set_.clear();
+    for (const auto &allocated_page_id : new_directory_page_ids) {
+      bpm_->DeletePage(allocated_page_id);
+    }
+    for (const auto &allocated_page_id : random_line_page_ids) {
+      bpm_->DeletePage(allocated_page_id);
+    }
+    LOG_DEBUG("allocate new page for random line failed.");
+    return false;
+  };
+
+  // Write the pages of all the lines
+  std::vector<page_id_t> random_line_page_start_ids;
+  random_line_page_start_ids.reserve(count);
+  for (int line_index = 0; line_index < count; ++line_index) {
+    auto array = lines + static_cast<int64_t>(line_index) * dimension_;
+    auto first_page_index = random_line_page_ids.size();
+    auto is_stored = IsSparseDistributionType(distribution_type_) ? StoreSparse(array, &random_line_page_ids)
+                                                                   : StoreDense(array, &random_line_page_ids);
+    if (!is_stored) {
+      return roll_back();
+    }
+    random_line_page_start_ids.emplace_back(random_line_page_ids[first_page_index]);
   }
 
-  if (directory_page->GetSize() == directory_page->GetMaxSize()) {
+  // Write the lines overflowing the last directory page into a chain of new directory pages
+  auto free_slot_count = static_cast<size_t>(directory_page->GetMaxSize() - directory_page->GetSize());
+  RandomLineDirectoryPage *previous_directory_page = nullptr;
+  for (auto index = free_slot_count; index < random_line_page_start_ids.size();) {
     auto next_directory_page_id = INVALID_PAGE_ID;
     auto next_directory_page_basic_guard = bpm_->NewPageGuarded(&next_directory_page_id);
     if (next_directory_page_id == INVALID_PAGE_ID) {
-      LOG_DEBUG("allocate new page for random line failed.");
-      return false;
+      return roll_back();
     }
 
+    new_directory_page_ids.emplace_back(next_directory_page_id);
     directory_page_ctx.write_set_.emplace_back(next_directory_page_basic_guard.UpgradeWrite());
     auto next_directory_page = directory_page_ctx.write_set_.back().AsMut<RandomLineDirectoryPage>();
     next_directory_page->Init(directory_page_max_size_);
-    directory_page->SetNextPageId(next_directory_page_id);
-    directory_page = next_directory_page;
+    for (; index < random_line_page_start_ids.size() && next_directory_page->GetSize() < next_directory_page->GetMaxSize();
+         ++index) {
+      auto slot = -1;
+      next_directory_page->Insert(random_line_page_start_ids[index], &slot);
+    }
+
+    // The last directory page stays latched at the front
+    if (previous_directory_page != nullptr) {
+      previous_directory_page->SetNextPageId(next_directory_page_id);
+      directory_page_ctx.write_set_.erase(directory_page_ctx.write_set_.begin() + 1);
+    }
+    previous_directory_page = next_directory_page;
   }
 
-  auto random_line_page_id = INVALID_PAGE_ID;
-  auto random_line_page_basic_guard = bpm_->NewPageGuarded(&random_line_page_id);
-  if (random_line_page_id == INVALID_PAGE_ID) {
-    LOG_DEBUG("allocate new page for random line failed.");
-    return false;
+  // Publish the lines in the last directory page and link the new ones, nothing can fail from here on
+  for (size_t index = 0; index < free_slot_count && index < random_line_page_start_ids.size(); ++index) {
+    auto slot = -1;
+    directory_page->Insert(random_line_page_start_ids[index], &slot);
+  }
+  if (!new_directory_page_ids.empty()) {
+    directory_page->SetNextPageId(new_directory_page_ids.front());
+    directory_page_ids_.insert(directory_page_ids_.end(), new_directory_page_ids.begin(), new_directory_page_ids.end());
   }
+  header_page->IncreaseSize(count);
 
-  auto start_random_line_page_id = random_line_page_id;
-  data_page_ctx.write_set_.emplace_back(random_line_page_basic_guard.UpgradeWrite());
-  RandomLineDataPage<RandomLineValueType>
-      *random_line_page = data_page_ctx.write_set_.back().AsMut<RandomLineDataPage<RandomLineValueType>>();
-  random_line_page->Init(data_page_max_size_);
-  auto current_random_line_page = random_line_page;
-  auto start_random_line_page = random_line_page;
+  return true;
+}
 
-  // Update header page index
-  auto slot = -1;
-  directory_page->Insert(random_line_page_id, &slot);
+RANDOM_LINE_TEMPLATE
+auto RANDOM_LINE_MANAGER_TYPE::StoreDense(const RandomLineValueType *array,
+                                          std::vector<page_id_t> *random_line_page_ids) -> bool {
+  RandomLineContext data_page_ctx;
+  RandomLineDataPage<RandomLineValueType> *previous_random_line_page = nullptr;
 
-  for (int current_size = 0; current_size < dimension_; current_size += current_random_line_page->GetMaxSize()) {
-    if (dimension_ - current_size > current_random_line_page->GetMaxSize()) {
-      memcpy(reinterpret_cast<char *>(current_random_line_page->array_), reinterpret_cast<char *>(&array[current_size]),
-             sizeof(RandomLineValueType) * current_random_line_page->GetMaxSize());
-      current_random_line_page->SetSize(current_random_line_page->GetMaxSize());
+  auto current_size = 0;
+  do {
+    auto random_line_page_id = INVALID_PAGE_ID;
+    auto random_line_page_basic_guard = bpm_->NewPageGuarded(&random_line_page_id);
+    if (random_line_page_id == INVALID_PAGE_ID) {
+      return false;
+    }
 
-      // Allocate new page and update data
-      random_line_page_id = INVALID_PAGE_ID;
-      random_line_page_basic_guard = bpm_->NewPageGuarded(&random_line_page_id);
-      if (random_line_page_id == INVALID_PAGE_ID) {
-        // Roll back
-        directory_page->Delete(start_random_line_page_id);
+    random_line_page_ids->emplace_back(random_line_page_id);
+    data_page_ctx.write_set_.emplace_back(random_line_page_basic_guard.UpgradeWrite());
+    auto random_line_page = data_page_ctx.write_set_.back().template AsMut<RandomLineDataPage<RandomLineValueType>>();
+    random_line_page->Init(data_page_max_size_);
 
-        // Delete page allocate before
-        auto delete_random_line_page = start_random_line_page;
-        auto delete_random_line_page_id = start_random_line_page_id;
-        while (delete_random_line_page->GetNextPageId() != INVALID_PAGE_ID) {
-          data_page_ctx.write_set_.pop_front();
-          bpm_->DeletePage(delete_random_line_page_id);
-          delete_random_line_page_id = delete_random_line_page->GetNextPageId();
-          delete_random_line_page = data_page_ctx.write_set_.front().template AsMut<RandomLineDataPage<RandomLineValueType>>();
-        }
+    auto size = std::min(dimension_ - current_size, random_line_page->GetMaxSize());
+    memcpy(reinterpret_cast<char *>(random_line_page->array_), reinterpret_cast<const char *>(&array[current_size]),
+           sizeof(RandomLineValueType) * size);
+    random_line_page->SetSize(size);
+    current_size += size;
 
-        // Delete last page
-        data_page_ctx.write_set_.pop_front();
-        bpm_->DeletePage(delete_random_line_page_id);
+    if (previous_random_line_page != nullptr) {
+      previous_random_line_page->SetNextPageId(random_line_page_id);
+      data_page_ctx.write_set_.pop_front();
+    }
+    previous_random_line_page = random_line_page;
+  } while (current_size < dimension_);
 
-        LOG_DEBUG("allocate new page for random line failed.");
-        return false;
-      }
+  return true;
+}
+
+RANDOM_LINE_TEMPLATE
+auto RANDOM_LINE_MANAGER_TYPE::StoreSparse(const RandomLineValueType *array,
+                                           std::vector<page_id_t> *random_line_page_ids) -> bool {
+  // A sparse page takes the bytes of a dense page
+  auto max_size = std::max(1, static_cast<int>(data_page_max_size_ * sizeof(RandomLineValueType)
+      / sizeof(RandomLineSparseEntry<RandomLineValueType>)));
+  RandomLineContext data_page_ctx;
+  RandomLineDataPage<RandomLineValueType> *previous_random_line_page = nullptr;
 
-      data_page_ctx.write_set_.emplace_back(random_line_page_basic_guard.UpgradeWrite());
+  auto index = 0;
+  do {
+    auto random_line_page_id = INVALID_PAGE_ID;
+    auto random_line_page_basic_guard = bpm_->NewPageGuarded(&random_line_page_id);
+    if (random_line_page_id == INVALID_PAGE_ID) {
+      return false;
+    }
 
-      random_line_page = data_page_ctx.write_set_.back().AsMut<RandomLineDataPage<RandomLineValueType> >();
-      random_line_page->Init(data_page_max_size_);
+    random_line_page_ids->emplace_back(random_line_page_id);
+    data_page_ctx.write_set_.emplace_back(random_line_page_basic_guard.UpgradeWrite());
+    auto random_line_page = data_page_ctx.write_set_.back().template AsMut<RandomLineDataPage<RandomLineValueType>>();
+    random_line_page->InitSparse(max_size);
 
-      current_random_line_page->SetNextPageId(random_line_page_id);
-      current_random_line_page = random_line_page;
+    auto entries = random_line_page->GetEntries();
+    auto size = 0;
+    for (; index < dimension_ && size < max_size; ++index) {
+      if (array[index] != 0) {
+        entries[size++] = {index, array[index]};
+      }
+    }
+    random_line_page->SetSize(size);
 
+    if (previous_random_line_page != nullptr) {
+      previous_random_line_page->SetNextPageId(random_line_page_id);
       data_page_ctx.write_set_.pop_front();
-    } else {
-      memcpy(reinterpret_cast<char *>(current_random_line_page->array_), reinterpret_cast<char *>(&array[current_size]),
-             sizeof(RandomLineValueType) * (dimension_ - current_size));
-      current_random_line_page->SetSize(dimension_ - current_size);
     }
-  }
+    previous_random_line_page = random_line_page;
+  } while (index < dimension_);
 
   return true;
 }
@@ -353,32 +557,26 @@ auto RANDOM_LINE_MANAGER_TYPE::InnerProduct(
     throw Exception(ExceptionType::OUT_OF_RANGE, fmt::format(fg(fmt::color::red), "[ERROR] RANDOM LINE MANAGER: current file is empty, invalid index {} input.", index));
   }
 
-  RandomLineContext ctx;
+  if (is_seeded_) {
+    auto header_page_guard = bpm_->FetchPageRead(header_page_id_);
+    *directory_page_id = HEADER_PAGE_ID;
+    *slot = index;
+    return SeededInnerProduct(index, outer_array.get());
+  }
 
-  // Locate the target directory page
+  // Locate the target directory page by the directory index
   auto header_page_guard = bpm_->FetchPageRead(header_page_id_);
-  auto header_page = header_page_guard.template As<RandomLineHeaderPage>();
-  ctx.read_set_.emplace_back(bpm_->FetchPageRead(header_page->GetDirectoryPageStartPageId()));
-  auto random_line_page = ctx.read_set_.back().template As<RandomLineDirectoryPage>();
-
-  auto current_size = 0;
-  while (current_size <= index) {
-    if (random_line_page->GetMaxSize() > index - current_size) {
-      *directory_page_id = ctx.read_set_.back().PageId();
-      *slot = index - current_size;
-      break;
-    }
-
-    if (random_line_page->GetNextPageId() == INVALID_PAGE_ID) {
-      throw Exception(ExceptionType::OUT_OF_RANGE, fmt::format(fg(fmt::color::red), "[ERROR] RANDOM LINE MANAGER: index out of range, invalid index {} input.", index));
-    }
-
-    current_size += random_line_page->GetMaxSize();
-    ctx.read_set_.emplace_back(bpm_->FetchPageRead(random_line_page->GetNextPageId()));
-    ctx.read_set_.pop_front();
-    random_line_page = ctx.read_set_.back().template As<RandomLineDirectoryPage>();
+  auto directory_page_position = index / directory_page_max_size_;
+  if (directory_page_position >= static_cast<int>(directory_page_ids_.size())) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, fmt::format(fg(fmt::color::red), "[ERROR] RANDOM LINE MANAGER: index out of range, invalid index {} input.", index));
   }
 
+  *directory_page_id = directory_page_ids_[directory_page_position];
+  *slot = index % directory_page_max_size_;
+  auto random_line_page_guard = bpm_->FetchPageRead(*directory_page_id);
+  auto random_line_page = random_line_page_guard.template As<RandomLineDirectoryPage>();
+  header_page_guard.Drop();
+
   auto target_random_line_start_page_id = random_line_page->IndexAt(*slot);
   if (target_random_line_start_page_id == INVALID_PAGE_ID) {
     throw Exception(ExceptionType::NULL_SLOT, fmt::format(fg(fmt::color::red), "[ERROR] RANDOM LINE MANAGER: input slot {} is not valid", *slot), false);
@@ -392,6 +590,11 @@ auto RANDOM_LINE_MANAGER_TYPE::InnerProduct(
     page_id_t directory_page_id,
     int slot,
     std::shared_ptr<RandomLineValueType[]> outer_array) -> RandomLineValueType {
+  if (is_seeded_ && directory_page_id == HEADER_PAGE_ID) {
+    auto header_page_guard = bpm_->FetchPageRead(header_page_id_);
+    return SeededInnerProduct(slot, outer_array.get());
+  }
+
   if (directory_page_id == INVALID_PAGE_ID || slot == INVALID_SLOT) {
     throw Exception(ExceptionType::INVALID_ARGUMENT, "Input directory page id or slot invalid");
   }
@@ -425,13 +628,11 @@ auto RANDOM_LINE_MANAGER_TYPE::InnerProduct(page_id_t random_line_page_start_id,
     ctx.read_set_.emplace_back(bpm_->FetchPageRead(random_line_page_id));
     auto random_page = ctx.read_set_.back().template As<RandomLineDataPage<RandomLineValueType>>();
 
-    // Calculate inner product
-#pragma omp parallel for reduction(+:result) default(none) shared(random_page, outer_array, current_size)
-    for (int i = 0; i < random_page->GetSize(); ++i) {
-      result += random_page->array_[i] * outer_array[i + current_size];
+    // Calculate inner product, entries of a sparse page carry their own indexes
+    result += random_page->InnerProduct(outer_array.get(), current_size);
+    if (!random_page->IsSparse()) {
+      current_size += random_page->GetSize();
     }
-
-    current_size += random_page->GetSize();
     random_line_page_id = random_page->GetNextPageId();
     ctx.read_set_.pop_front();
   }
@@ -439,6 +640,56 @@ auto RANDOM_LINE_MANAGER_TYPE::InnerProduct(page_id_t random_line_page_start_id,
   return result;
 }
 
+RANDOM_LINE_TEMPLATE
+auto RANDOM_LINE_MANAGER_TYPE::Project(std::shared_ptr<RandomLineValueType[]> outer_array,
+                                       std::vector<RID> *random_line_rids,
+                                       std::vector<RandomLineValueType> *projections) -> bool {
+  if (IsEmpty()) {
+    return false;
+  }
+
+  if (!is_seeded_ || distribution_type_ != RandomLineDistributionType::SRHT) {
+    auto size = GetSize();
+    for (int index = 0; index < size; ++index) {
+      auto directory_page_id = INVALID_PAGE_ID;
+      auto slot = INVALID_SLOT;
+      auto projection = InnerProduct(index, &directory_page_id, &slot, outer_array);
+      random_line_rids->emplace_back(RID(directory_page_id, static_cast<uint32_t>(slot)));
+      projections->emplace_back(projection);
+    }
+    return true;
+  }
+
+  // Every SRHT line is a row of H * D, one transform of the signed array projects it onto all of them
+  auto header_page_guard = bpm_->FetchPageRead(header_page_id_);
+  auto hadamard_dimension = RandomLineGenerator<RandomLineValueType>::GetHadamardDimension(dimension_);
+  std::vector<float> transform(hadamard_dimension, 0.0F);
+  for (int i = 0; i < dimension_; ++i) {
+    transform[i] = static_cast<float>(seeded_hadamard_signs_[i] * outer_array[i]);
+  }
+  for (int length = 1; length < hadamard_dimension; length <<= 1) {
+    for (int block = 0; block < hadamard_dimension; block += length << 1) {
+#pragma omp simd
+      for (int i = block; i < block + length; ++i) {
+        auto left = transform[i];
+        auto right = transform[i + length];
+        transform[i] = left + right;
+        transform[i + length] = left - right;
+      }
+    }
+  }
+
+  // Entries of a line are +-1 before the normalization
+  auto scale = normalization_type_ == RandomLineNormalizationType::L1_NORM ? 1.0F / static_cast<float>(dimension_)
+      : normalization_type_ == RandomLineNormalizationType::L2_NORM ? 1.0F / std::sqrt(static_cast<float>(dimension_))
+      : 1.0F;
+  for (size_t index = 0; index < seeded_hadamard_rows_.size(); ++index) {
+    random_line_rids->emplace_back(RID(HEADER_PAGE_ID, static_cast<uint32_t>(index)));
+    projections->emplace_back(static_cast<RandomLineValueType>(transform[seeded_hadamard_rows_[index]] * scale));
+  }
+  return true;
+}
+
 RANDOM_LINE_TEMPLATE
 auto RANDOM_LINE_MANAGER_TYPE::RandomLineInformation(distribution_lsh::page_id_t random_line_page_id) -> std::string {
   std::stringstream ss;
@@ -447,7 +698,8 @@ auto RANDOM_LINE_MANAGER_TYPE::RandomLineInformation(distribution_lsh::page_id_t
   while (random_line_page_id != INVALID_PAGE_ID) {
     auto random_line_page_guard = bpm_->FetchPageRead(random_line_page_id);
     auto random_line_page = random_line_page_guard.As<RandomLinePage>();
-    if (random_line_page->GetPageType() != RandomLinePageType::DATA_PAGE) {
+    if (random_line_page->GetPageType() != RandomLinePageType::DATA_PAGE
+        && random_line_page->GetPageType() != RandomLinePageType::SPARSE_DATA_PAGE) {
       LOG_DEBUG("%s", fmt::format("invalid page type, expected page type: DATA PAGE, current page type: {}.", RandomLinePageTypeToString(random_line_page->GetPageType())).data());
       return "";
     }
@@ -456,7 +708,12 @@ auto RANDOM_LINE_MANAGER_TYPE::RandomLineInformation(distribution_lsh::page_id_t
 
     ss << fmt::format("current page id: {}, random line content [ ", random_line_page_id);
     for (int i = 0; i < random_line_page->GetSize(); ++i) {
-      ss << fmt::format(fg(fmt::color::brown), "{:.3f}\t", random_line_data_page->array_[i]);
+      if (random_line_data_page->IsSparse()) {
+        auto entry = random_line_data_page->GetEntries()[i];
+        ss << fmt::format(fg(fmt::color::brown), "{}:{:.3f}\t", entry.index_, entry.value_);
+      } else {
+        ss << fmt::format(fg(fmt::color::brown), "{:.3f}\t", random_line_data_page->array_[i]);
+      }
     }
     ss << "]\n";
 
@@ -478,6 +735,11 @@ auto RANDOM_LINE_MANAGER_TYPE::RandomLineGroupInformation() -> std::string {
   ss << fmt::format(fg(fmt::color::yellow) | fmt::emphasis::bold, "random line group information :") << "\n";
   auto header_page_guard = bpm_->FetchPageRead(header_page_id_);
   auto header_page = header_page_guard.As<RandomLineHeaderPage>();
+  if (is_seeded_) {
+    ss << fmt::format(fg(fmt::color::orange) | fmt::emphasis::bold,
+                      "seed-defined random line group, seed: {}, size: {}\n", seed_, header_page->GetSize());
+    return ss.str();
+  }
   auto directory_page_guard = bpm_->FetchPageRead(header_page->GetDirectoryPageStartPageId());
   auto directory_page = directory_page_guard.As<RandomLineDirectoryPage>();
 
@@ -509,93 +771,146 @@ auto RANDOM_LINE_MANAGER_TYPE::RandomLineGroupInformation() -> std::string {
 }
 
 RANDOM_LINE_TEMPLATE
-void RANDOM_LINE_MANAGER_TYPE::UpdateAverageRandomLine(std::shared_ptr<RandomLineValueType[]> array, RandomLineContext *ctx) {
+auto RANDOM_LINE_MANAGER_TYPE::LoadAverageRandomLine(RandomLineContext *ctx) -> bool {
   RandomLineContext random_line_ctx;
 
-  RandomLineHeaderPage* header_page = ctx != nullptr && ctx->header_page_.has_value()?
-                                      ctx->header_page_.value().AsMut<RandomLineHeaderPage>()
-                                                                                         : [&]() {
-        random_line_ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
-        return random_line_ctx.header_page_.value().AsMut<RandomLineHeaderPage>(); }();
+  auto header_page = ctx != nullptr && ctx->header_page_.has_value() ?
+                     ctx->header_page_.value().As<RandomLineHeaderPage>() : [&]() {
+        random_line_ctx.read_set_.emplace_back(bpm_->FetchPageRead(header_page_id_));
+        return random_line_ctx.read_set_.back().As<RandomLineHeaderPage>(); }();
+
+  std::vector<RandomLineValueType> average_random_line;
+  average_random_line.reserve(dimension_);
+  auto average_random_line_page_id = header_page->GetAverageRandomLinePageId();
+  while (average_random_line_page_id != INVALID_PAGE_ID) {
+    auto average_random_line_page_guard = bpm_->FetchPageRead(average_random_line_page_id);
+    if (average_random_line_page_guard.template As<RandomLinePage>()->GetPageType() != RandomLinePageType::AVERAGE_RANDOM_LINE_PAGE) {
+      LOG_DEBUG("invalid page type.");
+      return false;
+    }
 
-  auto random_line_page_guard = bpm_->FetchPageWrite(header_page->GetAverageRandomLinePageId());
-  auto random_line_page = random_line_page_guard.AsMut<RandomLinePage>();
+    auto average_random_line_page = average_random_line_page_guard.template As<AverageRandomLinePage<RandomLineValueType>>();
+    average_random_line.insert(average_random_line.end(),
+                               average_random_line_page->array_,
+                               average_random_line_page->array_ + average_random_line_page->GetSize());
+    average_random_line_page_id = average_random_line_page->GetNextPageId();
+  }
 
-  if (random_line_page->GetPageType() != RandomLinePageType::AVERAGE_RANDOM_LINE_PAGE) {
-    LOG_DEBUG("invalid page type.");
-    return;
+  if (static_cast<int>(average_random_line.size()) != dimension_) {
+    LOG_DEBUG("%s", fmt::format("average random line data is not completeness, size: {}", average_random_line.size()).data());
+    return false;
   }
 
-  auto average_random_line_page = random_line_page_guard.AsMut<AverageRandomLinePage<RandomLineValueType>>();
-  auto factor = GetSize(ctx != nullptr && ctx->header_page_.has_value() ? ctx : &random_line_ctx) - 1;
+  average_random_line_ = std::move(average_random_line);
+  return true;
+}
 
-  // Update average random line
-  for (int current_size = 0; current_size < dimension_; current_size += average_random_line_page->GetSize()) {
-#pragma omp parallel for default(none) shared(average_random_line_page, array, current_size, factor)
-    for (int index = 0; index < average_random_line_page->GetSize(); ++index) {
-      average_random_line_page->array_[index] = (average_random_line_page->array_[index] * factor + array[current_size + index]) / (factor + 1);
-    }
+RANDOM_LINE_TEMPLATE
+void RANDOM_LINE_MANAGER_TYPE::FlushAverageRandomLine(RandomLineContext *ctx) {
+  RandomLineContext random_line_ctx;
 
-    if (average_random_line_page->GetNextPageId() == INVALID_PAGE_ID && dimension_ - current_size > average_random_line_page->GetSize()) {
-      throw Exception(fmt::format(fg(fmt::color::red), "average random line data is not completeness, current page id: {}", random_line_page_guard.PageId()));
-    } else if (average_random_line_page->GetNextPageId() == INVALID_PAGE_ID) {
-      return;
-    }
+  RandomLineHeaderPage* header_page = ctx != nullptr && ctx->header_page_.has_value()?
+                                      ctx->header_page_.value().AsMut<RandomLineHeaderPage>()
+                                                                                         : [&]() {
+        random_line_ctx.header_page_ = bpm_->FetchPageWrite(header_page_id_);
+        return random_line_ctx.header_page_.value().AsMut<RandomLineHeaderPage>(); }();
 
-    random_line_page_guard.Drop();
-    random_line_page_guard = bpm_->FetchPageWrite(average_random_line_page->GetNextPageId());
-    average_random_line_page = random_line_page_guard.AsMut<AverageRandomLinePage<RandomLineValueType>>();
+  auto current_size = 0;
+  auto average_random_line_page_id = header_page->GetAverageRandomLinePageId();
+  while (average_random_line_page_id != INVALID_PAGE_ID && current_size < static_cast<int>(average_random_line_.size())) {
+    auto average_random_line_page_guard = bpm_->FetchPageWrite(average_random_line_page_id);
+    auto average_random_line_page = average_random_line_page_guard.template AsMut<AverageRandomLinePage<RandomLineValueType>>();
+    memcpy(reinterpret_cast<char *>(average_random_line_page->array_),
+           reinterpret_cast<const char *>(average_random_line_.data() + current_size),
+           sizeof(RandomLineValueType) * average_random_line_page->GetSize());
+    current_size += average_random_line_page->GetSize();
+    average_random_line_page_id = average_random_line_page->GetNextPageId();
   }
 }
 
 RANDOM_LINE_TEMPLATE
 auto RANDOM_LINE_MANAGER_TYPE::GetSize(RandomLineContext *ctx, std::shared_ptr<std::vector<RID>> random_line_rids) -> int {
-  if (IsEmpty(ctx)) {
+  if (header_page_id_ == INVALID_PAGE_ID) {
     return 0;
   }
 
+  // Size is maintained in the header page
   RandomLineContext random_line_ctx;
-  auto size = 0;
-
   auto header_page = ctx != nullptr && ctx->header_page_.has_value()? ctx->header_page_.value().As<RandomLineHeaderPage>() : [&](){
     random_line_ctx.read_set_.emplace_back(bpm_->FetchPageRead(header_page_id_));
     return random_line_ctx.read_set_.back().As<RandomLineHeaderPage>();
   }();
+  if (header_page->IsEmpty()) {
+    return 0;
+  }
 
-  auto directory_page_guard = bpm_->FetchPageRead(header_page->GetDirectoryPageStartPageId());
-  auto directory_page = directory_page_guard.template As<RandomLineDirectoryPage>();
-  while (directory_page->GetNextPageId() != INVALID_PAGE_ID) {
-    size += directory_page->GetSize();
-    if (random_line_rids != nullptr) {
-      std::vector<int> ranges(directory_page->GetSize());
-      std::iota(ranges.begin(), ranges.end(), 0);
-      std::for_each(ranges.cbegin(), ranges.cend(), [&random_line_rids, &directory_page_guard, &directory_page](const auto &slot) {
+  if (random_line_rids != nullptr && is_seeded_) {
+    for (int index = 0; index < header_page->GetSize(); ++index) {
+      random_line_rids->emplace_back(RID(HEADER_PAGE_ID, index));
+    }
+  } else if (random_line_rids != nullptr) {
+    for (const auto &directory_page_id : directory_page_ids_) {
+      auto directory_page_guard = bpm_->FetchPageRead(directory_page_id);
+      auto directory_page = directory_page_guard.template As<RandomLineDirectoryPage>();
+      // Deleted lines leave free slots, the live ones may lie beyond the size
+      for (int slot = 0; slot < directory_page->GetEndOfArray(); ++slot) {
         if (directory_page->IndexAt(slot) != INVALID_PAGE_ID) {
-          random_line_rids->emplace_back(RID(directory_page_guard.PageId(), slot));
+          random_line_rids->emplace_back(RID(directory_page_id, slot));
         }
-      });
+      }
     }
-    directory_page_guard.Drop();
-    directory_page_guard = bpm_->FetchPageRead(directory_page->GetNextPageId());
-    directory_page = directory_page_guard.template As<RandomLineDirectoryPage>();
   }
 
-  size += directory_page->GetSize();
-  if (random_line_rids != nullptr) {
-    std::vector<int> ranges(directory_page->GetSize());
-    std::iota(ranges.begin(), ranges.end(), 0);
-    std::for_each(ranges.cbegin(), ranges.cend(), [&random_line_rids, &directory_page_guard, &directory_page](const auto &slot) {
-      if (directory_page->IndexAt(slot) != INVALID_PAGE_ID) {
-        random_line_rids->emplace_back(RID(directory_page_guard.PageId(), slot));
-      }
-    });
+  return header_page->GetSize();
+}
+
+RANDOM_LINE_TEMPLATE
+void RANDOM_LINE_MANAGER_TYPE::BuildDirectoryIndex() {
+  directory_page_ids_.clear();
+
+  auto header_page_guard = bpm_->FetchPageRead(header_page_id_);
+  auto header_page = header_page_guard.template As<RandomLineHeaderPage>();
+  auto directory_page_id = header_page->GetDirectoryPageStartPageId();
+  while (directory_page_id != INVALID_PAGE_ID) {
+    auto directory_page_guard = bpm_->FetchPageRead(directory_page_id);
+    auto directory_page = directory_page_guard.template As<RandomLineDirectoryPage>();
+    // Files written with another directory page size keep their own, global indexes are located by it
+    if (directory_page_ids_.empty()) {
+      directory_page_max_size_ = directory_page->GetMaxSize();
+    }
+    directory_page_ids_.emplace_back(directory_page_id);
+    directory_page_id = directory_page->GetNextPageId();
   }
+}
 
-  return size;
+RANDOM_LINE_TEMPLATE
+void RANDOM_LINE_MANAGER_TYPE::UpgradeLegacyHeaderPage() {
+  auto header_page_guard = bpm_->FetchPageWrite(header_page_id_);
+  auto header_page = header_page_guard.template AsMut<RandomLineHeaderPage>();
+
+  // The fields behind the directory page start id are zeros in a legacy file, a group of it is never seed-defined
+  int size = 0;
+  for (const auto &directory_page_id : directory_page_ids_) {
+    auto directory_page_guard = bpm_->FetchPageRead(directory_page_id);
+    size += directory_page_guard.template As<RandomLineDirectoryPage>()->GetSize();
+  }
+  header_page->SetSize(size);
+  header_page->SetFormatVersion(RANDOM_LINE_HEADER_PAGE_VERSION);
+  LOG_INFO("%s", fmt::format("upgrade legacy header page of random line file {}, size: {}", file_id_, size).data());
 }
 
 RANDOM_LINE_TEMPLATE
 auto RANDOM_LINE_MANAGER_TYPE::Delete(page_id_t directory_page_id, int slot) -> bool {
+  if (is_seeded_) {
+    LOG_DEBUG("lines of a seed-defined random line group cannot be deleted.");
+    return false;
+  }
+
+  // Header page is latched first, it guards the directory index and the size
+  RandomLineContext directory_ctx;
+  directory_ctx.header_page_ = std::make_optional(bpm_->FetchPageWrite(header_page_id_));
+  auto header_page = directory_ctx.header_page_->AsMut<RandomLineHeaderPage>();
+
   auto random_line_page_guard = bpm_->FetchPageWrite(directory_page_id);
   auto random_line_page = random_line_page_guard.AsMut<RandomLinePage>();
   if (random_line_page->GetPageType() != RandomLinePageType::DIRECTORY_PAGE) {
@@ -610,8 +925,12 @@ auto RANDOM_LINE_MANAGER_TYPE::Delete(page_id_t directory_page_id, int slot) ->
     return false;
   }
 
-  // Delete entry in directory page
-  directory_page->Delete(slot);
+  // Delete entry in directory page, the size follows only a deleted entry
+  if (!directory_page->Delete(slot)) {
+    LOG_DEBUG("%s", fmt::format("delete slot {} of directory page {} failed.", slot, directory_page_id).data());
+    return false;
+  }
+  header_page->IncreaseSize(-1);
 
   // Delete actual data page
   RandomLineContext data_ctx;
@@ -633,9 +952,10 @@ auto RANDOM_LINE_MANAGER_TYPE::Delete(page_id_t directory_page_id, int slot) ->
 
   // If directory page is empty, delete it
   if (directory_page->GetSize() == 0) {
-    RandomLineContext directory_ctx;
-    directory_ctx.header_page_ = std::make_optional(bpm_->FetchPageWrite(header_page_id_));
-    auto header_page = directory_ctx.header_page_->AsMut<RandomLineHeaderPage>();
+    auto directory_page_id_iterator = std::find(directory_page_ids_.begin(), directory_page_ids_.end(), directory_page_id);
+    if (directory_page_id_iterator != directory_page_ids_.end()) {
+      directory_page_ids_.erase(directory_page_id_iterator);
+    }
 
     // Delete directory page is the first directory page
     if (header_page->GetDirectoryPageStartPageId() == directory_page_id) {
@@ -686,6 +1006,12 @@ auto RANDOM_LINE_MANAGER_TYPE::GetDistributionType() -> RandomLineDistributionTy
 RANDOM_LINE_TEMPLATE
 auto RANDOM_LINE_MANAGER_TYPE::GetNormalizationType() -> RandomLineNormalizationType { return normalization_type_; }
 
+RANDOM_LINE_TEMPLATE
+auto RANDOM_LINE_MANAGER_TYPE::IsSeeded() -> bool { return is_seeded_; }
+
+RANDOM_LINE_TEMPLATE
+auto RANDOM_LINE_MANAGER_TYPE::GetSeed() -> uint64_t { return seed_; }
+
 RANDOM_LINE_TEMPLATE
 auto RANDOM_LINE_MANAGER_TYPE::ToString() -> std::string {
   auto info = fmt::format(
@@ -696,7 +1022,8 @@ auto RANDOM_LINE_MANAGER_TYPE::ToString() -> std::string {
       "├─────directory page max size: {}.\n"
       "├─────data page max size: {}.\n"
       "├─────distribution type: {}.\n"
-      "└─────normalization type: {}.\n"
+      "├─────normalization type: {}.\n"
+      "└─────seed: {}.\n"
       ,
       fmt::format(fg(fmt::color::orange_red) | fmt::emphasis::underline, std::to_string(file_id_)),
       fmt::format(fg(fmt::color::orange_red) | fmt::emphasis::bold, manager_name_),
@@ -705,7 +1032,8 @@ auto RANDOM_LINE_MANAGER_TYPE::ToString() -> std::string {
       fmt::format(fg(fmt::color::orange_red) | fmt::emphasis::bold, "{}", directory_page_max_size_),
       fmt::format(fg(fmt::color::orange_red) | fmt::emphasis::bold, "{}", data_page_max_size_),
       fmt::format(fg(fmt::color::orange_red) | fmt::emphasis::bold, RandomLineDistributionTypeToString(distribution_type_)),
-      fmt::format(fg(fmt::color::orange_red) | fmt::emphasis::bold, RandomLineNormalizationTypeToString(normalization_type_))
+      fmt::format(fg(fmt::color::orange_red) | fmt::emphasis::bold, RandomLineNormalizationTypeToString(normalization_type_)),
+      fmt::format(fg(fmt::color::orange_red) | fmt::emphasis::bold, is_seeded_ ? std::to_string(seed_) : "none")
       );
 
   return info;
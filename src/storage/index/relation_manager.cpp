@@ -47,6 +47,8 @@ auto RELATION_MANAGER_TYPE::IsEmpty(RelationContext *ctx, bool is_read) -> bool
     return true;
   }
 
+  // The guard keeps the header page pinned while it is read
+  std::optional<ReadPageGuard> header_page_guard;
   auto header_page = ctx != nullptr && !is_read ? [&]() {
     if (ctx->header_page_.has_value()) {
       return ctx->header_page_.value().template As<RelationHeaderPage>();
@@ -56,7 +58,7 @@ auto RELATION_MANAGER_TYPE::IsEmpty(RelationContext *ctx, bool is_read) -> bool
   }() : [&]() {
     return ctx != nullptr && ctx->header_page_.has_value() ?
            ctx->header_page_.value().template As<RelationHeaderPage>()
-           : bpm_->FetchPageRead(header_page_id_).template As<RelationHeaderPage>();
+           : (header_page_guard = bpm_->FetchPageRead(header_page_id_))->template As<RelationHeaderPage>();
   }();
   return header_page->IsEmpty();
 }
@@ -16,8 +16,11 @@ void DistributionDataSetCIFAR10HeaderPage::Init(
   SetFileIdentification(file_id);
   SetDataSetType(DataSetType::CIFAR10);
   SetNormalizationType(normalization_type);
+  SetVectorEncoding(VectorEncoding::FLOAT32);
   SetDimension(32 * 32 * 3);        // CIFAR10 dataset has 32 * 32 * 3 = 3072 features
   SetDirectoryId(directory_start_page_id);
+  SetSize(0);
+  SetFormatVersion(DISTRIBUTION_DATASET_HEADER_PAGE_VERSION);
 }
 
 } // namespace distribution_lsh
\ No newline at end of file
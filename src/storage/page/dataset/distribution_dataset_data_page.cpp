@@ -5,6 +5,9 @@
 //
 //===-----------------------------------------------------
 
+#include <cstring>
+
+#include <common/exception.h>
 #include <storage/page/dataset/distribution_dataset_data_page.h>
 
 namespace distribution_lsh {
@@ -44,6 +47,94 @@ auto DISTRIBUTION_DATASET_PAGE_TYPE::ToString() -> std::string {
                      GetMaxSize());
 }
 
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_PAGE_TYPE::GetEncodedCapacity(VectorEncoding encoding) -> int {
+  auto payload_size = DISTRIBUTION_LSH_PAGE_SIZE - static_cast<int>(sizeof(DistributionDataSetDataPage));
+  if (encoding == VectorEncoding::FLOAT32) {
+    return payload_size / static_cast<int>(sizeof(ValueType));
+  }
+  if (encoding == VectorEncoding::UINT8) {
+    payload_size -= 2 * static_cast<int>(sizeof(float));
+  }
+  return payload_size / GetVectorEncodingWidth(encoding);
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+void DISTRIBUTION_DATASET_PAGE_TYPE::Encode(const ValueType *values,
+                                           int length,
+                                           VectorEncoding encoding,
+                                           float scale,
+                                           float offset) {
+  auto payload = reinterpret_cast<char *>(array_);
+  switch (encoding) {
+    case VectorEncoding::FLOAT32: {
+      memcpy(payload, values, sizeof(ValueType) * length);
+      break;
+    }
+    case VectorEncoding::FLOAT16: {
+      auto codes = reinterpret_cast<uint16_t *>(payload);
+      for (int i = 0; i < length; ++i) {
+        codes[i] = FloatToHalf(static_cast<float>(values[i]));
+      }
+      break;
+    }
+    case VectorEncoding::BFLOAT16: {
+      auto codes = reinterpret_cast<uint16_t *>(payload);
+      for (int i = 0; i < length; ++i) {
+        codes[i] = FloatToBFloat16(static_cast<float>(values[i]));
+      }
+      break;
+    }
+    case VectorEncoding::UINT8: {
+      memcpy(payload, &scale, sizeof(float));
+      memcpy(payload + sizeof(float), &offset, sizeof(float));
+      auto codes = reinterpret_cast<uint8_t *>(payload + 2 * sizeof(float));
+      for (int i = 0; i < length; ++i) {
+        codes[i] = QuantizeToUint8(static_cast<float>(values[i]), scale, offset);
+      }
+      break;
+    }
+    default: throw Exception("Unsupported vector encoding");
+  }
+  SetSize(length);
+}
+
+DISTRIBUTION_DATASET_TEMPLATE
+auto DISTRIBUTION_DATASET_PAGE_TYPE::Decode(VectorEncoding encoding, ValueType *buffer) const -> const ValueType * {
+  auto payload = reinterpret_cast<const char *>(array_);
+  auto length = GetSize();
+  switch (encoding) {
+    case VectorEncoding::FLOAT32: return array_;
+    case VectorEncoding::FLOAT16: {
+      auto codes = reinterpret_cast<const uint16_t *>(payload);
+      for (int i = 0; i < length; ++i) {
+        buffer[i] = static_cast<ValueType>(HalfToFloat(codes[i]));
+      }
+      return buffer;
+    }
+    case VectorEncoding::BFLOAT16: {
+      auto codes = reinterpret_cast<const uint16_t *>(payload);
+#pragma omp simd
+      for (int i = 0; i < length; ++i) {
+        buffer[i] = static_cast<ValueType>(BFloat16ToFloat(codes[i]));
+      }
+      return buffer;
+    }
+    case VectorEncoding::UINT8: {
+      float scale;
+      float offset;
+      memcpy(&scale, payload, sizeof(float));
+      memcpy(&offset, payload + sizeof(float), sizeof(float));
+      auto codes = reinterpret_cast<const uint8_t *>(payload + 2 * sizeof(float));
+#pragma omp simd
+      for (int i = 0; i < length; ++i) {
+        buffer[i] = static_cast<ValueType>(offset + static_cast<float>(codes[i]) * scale);
+      }
+      return buffer;
+    }
+    default: throw Exception("Unsupported vector encoding");
+  }
+}
 
 template class DistributionDataSetDataPage<float>;
 } // namespace distribution_lsh
\ No newline at end of file
@@ -16,14 +16,19 @@ void DistributionDataSetGenerationHeaderPage::Init(
     float param1,
     float param2,
     int dimension,
-    page_id_t directory_start_page_id) {
+    page_id_t directory_start_page_id,
+    uint64_t seed) {
   SetFileIdentification(file_id);
   SetDataSetType(DataSetType::GENERATION);
   SetDistributionType(distribution_type);
   SetNormalizationType(normalization_type);
+  SetVectorEncoding(VectorEncoding::FLOAT32);
   SetParameter(param1, param2);
   SetDimension(dimension);
   SetDirectoryId(directory_start_page_id);
+  SetSize(0);
+  SetSeed(seed);
+  SetFormatVersion(DISTRIBUTION_DATASET_HEADER_PAGE_VERSION);
 }
 
 auto DistributionDataSetGenerationHeaderPage::GetDistributionType() const -> DistributionType { return distribution_type_; }
@@ -38,6 +43,9 @@ auto DistributionDataSetGenerationHeaderPage::GetParameter() const -> std::share
   return parameter;
 }
 
+auto DistributionDataSetGenerationHeaderPage::GetSeed() const -> uint64_t { return seed_; }
+void DistributionDataSetGenerationHeaderPage::SetSeed(uint64_t seed) { seed_ = seed; }
+
 void DistributionDataSetGenerationHeaderPage::SetParameter(float param1, float param2) {
   switch (distribution_type_) {
     case DistributionType::INVALID_DISTRIBUTION_TYPE:
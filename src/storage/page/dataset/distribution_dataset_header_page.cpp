@@ -15,9 +15,19 @@ void DistributionDataSetHeaderPage::SetDataSetType(DataSetType data_set_type) {
 auto DistributionDataSetHeaderPage::GetNormalizationType() const -> NormalizationType { return normalization_type_; }
 void DistributionDataSetHeaderPage::SetNormalizationType(NormalizationType normalization_type) { normalization_type_ = normalization_type; }
 
+auto DistributionDataSetHeaderPage::GetVectorEncoding() const -> VectorEncoding { return vector_encoding_; }
+void DistributionDataSetHeaderPage::SetVectorEncoding(VectorEncoding vector_encoding) { vector_encoding_ = vector_encoding; }
+
 auto DistributionDataSetHeaderPage::GetDimension() const -> int { return dimension_; }
 void DistributionDataSetHeaderPage::SetDimension(int dimension) { dimension_ = dimension; }
 
 auto DistributionDataSetHeaderPage::IsEmpty() const -> bool { return directory_start_page_id_ == INVALID_PAGE_ID || directory_start_page_id_ == HEADER_PAGE_ID; }
 void DistributionDataSetHeaderPage::SetDirectoryId(page_id_t directory_start_page_id) { directory_start_page_id_ = directory_start_page_id; }
+
+auto DistributionDataSetHeaderPage::GetSize() const -> int { return size_; }
+void DistributionDataSetHeaderPage::SetSize(int size) { size_ = size; }
+void DistributionDataSetHeaderPage::IncreaseSize(int amount) { size_ += amount; }
+
+auto DistributionDataSetHeaderPage::GetFormatVersion() const -> uint8_t { return format_version_; }
+void DistributionDataSetHeaderPage::SetFormatVersion(uint8_t format_version) { format_version_ = format_version; }
 } // namespace distribution_lsh
\ No newline at end of file
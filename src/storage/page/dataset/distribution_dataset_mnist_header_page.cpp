@@ -16,8 +16,11 @@ void DistributionDataSetMNISTHeaderPage::Init(
   SetFileIdentification(file_id);
   SetDataSetType(DataSetType::MNIST);
   SetNormalizationType(normalization_type);
+  SetVectorEncoding(VectorEncoding::FLOAT32);
   SetDimension(784);        // MNIST dataset has 784 features
   SetDirectoryId(directory_start_page_id);
+  SetSize(0);
+  SetFormatVersion(DISTRIBUTION_DATASET_HEADER_PAGE_VERSION);
 }
 
 } // namespace distribution_lsh
\ No newline at end of file
@@ -15,9 +15,14 @@ void DistributionDataSetPage::SetPageType(DistributionDataSetPageType page_type)
 auto DistributionDataSetPage::GetSize() const -> int { return size_; }
 void DistributionDataSetPage::SetSize(int size) { size_ = size; }
 
-auto DistributionDataSetPage::GetMaxSize() const -> int { return max_size_; }
+auto DistributionDataSetPage::GetMaxSize() const -> int { return max_size_ & ~OCCUPANCY_BITMAP_FLAG; }
 void DistributionDataSetPage::SetMaxSize(int max_size) { max_size_ = max_size; }
 
+auto DistributionDataSetPage::HasOccupancyBitmap() const -> bool { return (max_size_ & OCCUPANCY_BITMAP_FLAG) != 0; }
+void DistributionDataSetPage::SetOccupancyBitmap(bool has_occupancy_bitmap) {
+  max_size_ = has_occupancy_bitmap ? (max_size_ | OCCUPANCY_BITMAP_FLAG) : (max_size_ & ~OCCUPANCY_BITMAP_FLAG);
+}
+
 auto DistributionDataSetPage::GetNextPageId() const -> page_id_t { return next_page_id_; }
 void DistributionDataSetPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
@@ -11,8 +11,9 @@
 namespace distribution_lsh {
 
 BasicPageGuard::BasicPageGuard(BasicPageGuard &&that) noexcept
-    : bpm_(that.bpm_), page_(std::move(that.page_)), is_dirty_(that.is_dirty_) {
+    : bpm_(that.bpm_), page_(that.page_), is_dirty_(that.is_dirty_) {
   that.bpm_ = nullptr;
+  that.page_ = nullptr;
   that.is_dirty_ = false;
 }
 
@@ -26,6 +27,12 @@ void BasicPageGuard::Drop() {
 }
 
 auto BasicPageGuard::operator=(BasicPageGuard &&that) noexcept -> BasicPageGuard & {
+  if (this == &that) {
+    return *this;
+  }
+
+  // Unpin the page held before, or it would stay pinned forever
+  Drop();
   this->bpm_ = that.bpm_;
   this->page_ = that.page_;
   this->is_dirty_ = that.is_dirty_;
@@ -43,25 +50,40 @@ BasicPageGuard::~BasicPageGuard(){
 };  // NOLINT
 
 auto BasicPageGuard::UpgradeRead() -> ReadPageGuard {
-  return {this->bpm_, std::move(this->page_)};
+  ReadPageGuard read_guard(this->bpm_, this->page_);
+  read_guard.guard_.is_dirty_ = this->is_dirty_;
+  this->bpm_ = nullptr;
+  this->page_ = nullptr;
+  this->is_dirty_ = false;
+  return read_guard;
 }
 
 auto BasicPageGuard::UpgradeWrite() -> WritePageGuard {
-  return {this->bpm_, std::move(this->page_)};
+  WritePageGuard write_guard(this->bpm_, this->page_);
+  write_guard.guard_.is_dirty_ = this->is_dirty_;
+  this->bpm_ = nullptr;
+  this->page_ = nullptr;
+  this->is_dirty_ = false;
+  return write_guard;
 }
 
 ReadPageGuard::ReadPageGuard(ReadPageGuard &&that) noexcept : guard_(std::move(that.guard_)) {}
 
 auto ReadPageGuard::operator=(ReadPageGuard &&that) noexcept -> ReadPageGuard & {
+  if (this != &that) {
+    Drop();
+  }
   this->guard_ = std::move(that.guard_);
   return *this;
 }
 
 void ReadPageGuard::Drop() {
   if (this->guard_.page_ != nullptr && this->guard_.PageId() != INVALID_PAGE_ID) {
-    guard_.bpm_->UnpinPage(guard_.page_->GetPageId(), guard_.is_dirty_);
+    // Release the latch before the frame can be evicted
     this->guard_.page_->RUnlatch();
+    guard_.bpm_->UnpinPage(guard_.page_->GetPageId(), guard_.is_dirty_);
     guard_.page_ = nullptr;
+    guard_.is_dirty_ = false;
   }
 }
 
@@ -72,15 +94,20 @@ ReadPageGuard::~ReadPageGuard() {
 WritePageGuard::WritePageGuard(WritePageGuard &&that) noexcept : guard_(std::move(that.guard_)) {}
 
 auto WritePageGuard::operator=(WritePageGuard &&that) noexcept -> WritePageGuard & {
+  if (this != &that) {
+    Drop();
+  }
   this->guard_ = std::move(that.guard_);
   return *this;
 }
 
 void WritePageGuard::Drop() {
   if (this->guard_.page_ != nullptr && this->guard_.PageId() != INVALID_PAGE_ID) {
-    guard_.bpm_->UnpinPage(guard_.page_->GetPageId(), guard_.is_dirty_);
+    // Release the latch before the frame can be evicted
     this->guard_.page_->WUnlatch();
+    guard_.bpm_->UnpinPage(guard_.page_->GetPageId(), guard_.is_dirty_);
     guard_.page_ = nullptr;
+    guard_.is_dirty_ = false;
   }
 }
 
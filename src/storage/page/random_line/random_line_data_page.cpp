@@ -17,6 +17,34 @@ void RANDOM_LINE_DATA_PAGE_TYPE::Init(int max_size) {
   SetNextPageId(INVALID_PAGE_ID);
 }
 
+RANDOM_LINE_TEMPLATE
+void RANDOM_LINE_DATA_PAGE_TYPE::InitSparse(int max_size) {
+  SetMaxSize(max_size);
+  SetSize(0);
+  SetPageType(RandomLinePageType::SPARSE_DATA_PAGE);
+  SetNextPageId(INVALID_PAGE_ID);
+}
+
+RANDOM_LINE_TEMPLATE
+auto RANDOM_LINE_DATA_PAGE_TYPE::InnerProduct(const RandomLineValueType *outer_array, int offset) const -> RandomLineValueType {
+  auto result = static_cast<RandomLineValueType>(0);
+  auto size = GetSize();
+  if (IsSparse()) {
+    // Gather the non-zero entries only
+    auto entries = GetEntries();
+    for (int i = 0; i < size; ++i) {
+      result += entries[i].value_ * outer_array[entries[i].index_];
+    }
+    return result;
+  }
+
+#pragma omp simd reduction(+:result)
+  for (int i = 0; i < size; ++i) {
+    result += array_[i] * outer_array[i + offset];
+  }
+  return result;
+}
+
 RANDOM_LINE_TEMPLATE
 auto RANDOM_LINE_DATA_PAGE_TYPE::ToString() -> std::string {
   return fmt::format("average random line page(next page id={})",
@@ -5,6 +5,8 @@
 //
 //===-----------------------------------------------------
 
+#include <algorithm>
+
 #include <storage/page/random_line/random_line_directory_page.h>
 
 namespace distribution_lsh {
@@ -15,8 +17,23 @@ void RandomLineDirectoryPage::Init(int max_size) {
   SetMaxSize(max_size);
   SetNextPageId(INVALID_PAGE_ID);
   SetNullSlotStart(0);
-  array_[null_slot_start_] = NULL_SLOT_END;
   SetEndOfArray(0);
+
+  // Pages too small for the bitmap fall back to the null slot list
+  if (OccupancyBitmap::FitsInPage(this, array_ + max_size, max_size)) {
+    SetOccupancyBitmap(true);
+    OccupancyBitmap::Reset(GetOccupancyWords(), max_size);
+  } else {
+    array_[null_slot_start_] = NULL_SLOT_END;
+  }
+}
+
+auto RandomLineDirectoryPage::GetOccupancyWords() const -> const occupancy_word_t * {
+  return reinterpret_cast<const occupancy_word_t *>(array_ + GetMaxSize());
+}
+
+auto RandomLineDirectoryPage::GetOccupancyWords() -> occupancy_word_t * {
+  return reinterpret_cast<occupancy_word_t *>(array_ + GetMaxSize());
 }
 
 auto RandomLineDirectoryPage::GetNullSlotStart() const -> int { return null_slot_start_; }
@@ -33,6 +50,18 @@ auto RandomLineDirectoryPage::Insert(distribution_lsh::page_id_t data_page_id, i
   // Search the null slot start
   int null_slot = GetNullSlotStart();
 
+  if (HasOccupancyBitmap()) {
+    auto occupancy_words = GetOccupancyWords();
+    array_[null_slot] = data_page_id;
+    OccupancyBitmap::Set(occupancy_words, null_slot);
+    end_of_array_ = std::max(end_of_array_, null_slot + 1);
+    null_slot_start_ = OccupancyBitmap::FindFirstClear(occupancy_words, null_slot + 1, GetMaxSize());
+
+    *index = null_slot;
+    IncreaseSize(1);
+    return true;
+  }
+
   // Judge if it has arrived at the end of array
   if (null_slot_start_ == GetEndOfArray()) {
     null_slot_start_ ++;
@@ -51,10 +80,21 @@ auto RandomLineDirectoryPage::Insert(distribution_lsh::page_id_t data_page_id, i
 
 auto RandomLineDirectoryPage::Delete(int index) -> bool {
   // Judge if the index is valid
-  if (index >= GetEndOfArray()) {
+  if (index < 0 || index >= GetEndOfArray()) {
     return false;
   }
 
+  if (HasOccupancyBitmap()) {
+    auto occupancy_words = GetOccupancyWords();
+    if (!OccupancyBitmap::Test(occupancy_words, index)) {
+      return false;
+    }
+    OccupancyBitmap::Clear(occupancy_words, index);
+    null_slot_start_ = std::min(null_slot_start_, index);
+    IncreaseSize(-1);
+    return true;
+  }
+
   auto null_slot = GetNullSlotStart();
   auto location = -1;
 
@@ -75,10 +115,14 @@ auto RandomLineDirectoryPage::Delete(int index) -> bool {
 }
 
 auto RandomLineDirectoryPage::IndexAt(int index) const -> page_id_t {
-  if (index >= GetEndOfArray()) {
+  if (index < 0 || index >= GetEndOfArray()) {
     return INVALID_PAGE_ID;
   }
 
+  if (HasOccupancyBitmap()) {
+    return OccupancyBitmap::Test(GetOccupancyWords(), index) ? array_[index] : INVALID_PAGE_ID;
+  }
+
   auto null_slot = GetNullSlotStart();
 
   while (array_[null_slot] != NULL_SLOT_END && index > null_slot) {
@@ -22,9 +22,16 @@ void RandomLineHeaderPage::Init(distribution_lsh::file_id_t file_id,
   SetEpsilon(epsilon);
   SetAverageRandomLinePageId(average_random_line_page_id);
   SetDirectoryPageStartPageId(data_page_start_page_id);
+  SetSize(0);
+  SetFormatVersion(RANDOM_LINE_HEADER_PAGE_VERSION);
+  is_seeded_ = false;
+  seed_ = 0;
 }
 
 auto RandomLineHeaderPage::IsEmpty() const -> bool {
+  if (is_seeded_) {
+    return size_ == 0;
+  }
   return directory_page_start_page_id_ == INVALID_PAGE_ID || directory_page_start_page_id_ == HEADER_PAGE_ID;
 }
 
@@ -45,4 +52,18 @@ void RandomLineHeaderPage::SetAverageRandomLinePageId(page_id_t average_random_l
 
 auto RandomLineHeaderPage::GetDirectoryPageStartPageId() const -> page_id_t { return directory_page_start_page_id_; }
 void RandomLineHeaderPage::SetDirectoryPageStartPageId(page_id_t directory_page_start_page_id) { directory_page_start_page_id_ = directory_page_start_page_id; }
+
+auto RandomLineHeaderPage::GetSize() const -> int { return size_; }
+void RandomLineHeaderPage::SetSize(int size) { size_ = size; }
+void RandomLineHeaderPage::IncreaseSize(int amount) { size_ += amount; }
+
+auto RandomLineHeaderPage::GetFormatVersion() const -> uint8_t { return format_version_; }
+void RandomLineHeaderPage::SetFormatVersion(uint8_t format_version) { format_version_ = format_version; }
+
+auto RandomLineHeaderPage::IsSeeded() const -> bool { return is_seeded_; }
+auto RandomLineHeaderPage::GetSeed() const -> uint64_t { return seed_; }
+void RandomLineHeaderPage::SetSeed(uint64_t seed) {
+  is_seeded_ = true;
+  seed_ = seed;
+}
 }// namespace distribution_lsh
\ No newline at end of file
@@ -18,10 +18,16 @@ auto RandomLinePage::GetSize() const -> int { return size_; }
 
 void RandomLinePage::SetSize(int size) { size_ = size; }
 
-auto RandomLinePage::GetMaxSize() const -> int { return max_size_; }
+auto RandomLinePage::GetMaxSize() const -> int { return max_size_ & ~OCCUPANCY_BITMAP_FLAG; }
 
 void RandomLinePage::SetMaxSize(int max_size) { max_size_ = max_size; }
 
+auto RandomLinePage::HasOccupancyBitmap() const -> bool { return (max_size_ & OCCUPANCY_BITMAP_FLAG) != 0; }
+
+void RandomLinePage::SetOccupancyBitmap(bool has_occupancy_bitmap) {
+  max_size_ = has_occupancy_bitmap ? (max_size_ | OCCUPANCY_BITMAP_FLAG) : (max_size_ & ~OCCUPANCY_BITMAP_FLAG);
+}
+
 auto RandomLinePage::GetNextPageId() const -> page_id_t { return next_page_id_; }
 
 void RandomLinePage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
@@ -5,6 +5,8 @@
 //
 //===-----------------------------------------------------
 
+#include <algorithm>
+
 #include <storage/page/relation/relation_data_page.h>
 
 namespace distribution_lsh {
@@ -15,8 +17,25 @@ void RELATION_TYPE::Init(int max_size) {
   SetSize(0);
   SetNextPageId(INVALID_PAGE_ID);
   SetNullSlotStart(0);
-  array_[null_slot_start_].next_null_slot_ = NULL_SLOT_END;
   SetEndOfArray(0);
+
+  // Pages too small for the bitmap fall back to the null slot list
+  if (OccupancyBitmap::FitsInPage(this, array_ + max_size, max_size)) {
+    SetOccupancyBitmap(true);
+    OccupancyBitmap::Reset(GetOccupancyWords(), max_size);
+  } else {
+    array_[null_slot_start_].next_null_slot_ = NULL_SLOT_END;
+  }
+}
+
+RELATION_TEMPLATE
+auto RELATION_TYPE::GetOccupancyWords() const -> const occupancy_word_t * {
+  return reinterpret_cast<const occupancy_word_t *>(array_ + GetMaxSize());
+}
+
+RELATION_TEMPLATE
+auto RELATION_TYPE::GetOccupancyWords() -> occupancy_word_t * {
+  return reinterpret_cast<occupancy_word_t *>(array_ + GetMaxSize());
 }
 
 RELATION_TEMPLATE
@@ -26,11 +45,19 @@ RELATION_TEMPLATE
 void  RELATION_TYPE::SetSize(int size) { size_ = size; }
 
 RELATION_TEMPLATE
-auto RELATION_TYPE::GetMaxSize() const -> int { return max_size_; }
+auto RELATION_TYPE::GetMaxSize() const -> int { return max_size_ & ~OCCUPANCY_BITMAP_FLAG; }
 
 RELATION_TEMPLATE
 void RELATION_TYPE::SetMaxSize(int max_size) { max_size_ = max_size; }
 
+RELATION_TEMPLATE
+auto RELATION_TYPE::HasOccupancyBitmap() const -> bool { return (max_size_ & OCCUPANCY_BITMAP_FLAG) != 0; }
+
+RELATION_TEMPLATE
+void RELATION_TYPE::SetOccupancyBitmap(bool has_occupancy_bitmap) {
+  max_size_ = has_occupancy_bitmap ? (max_size_ | OCCUPANCY_BITMAP_FLAG) : (max_size_ & ~OCCUPANCY_BITMAP_FLAG);
+}
+
 RELATION_TEMPLATE
 auto RELATION_TYPE::GetNextPageId() const -> page_id_t { return next_page_id_; }
 
@@ -64,6 +91,18 @@ auto RELATION_TYPE::Insert(ValueType value, int *index) -> bool {
   // Search the null slot start
   int null_slot = GetNullSlotStart();
 
+  if (HasOccupancyBitmap()) {
+    auto occupancy_words = GetOccupancyWords();
+    array_[null_slot] = value;
+    OccupancyBitmap::Set(occupancy_words, null_slot);
+    end_of_array_ = std::max(end_of_array_, null_slot + 1);
+    null_slot_start_ = OccupancyBitmap::FindFirstClear(occupancy_words, null_slot + 1, GetMaxSize());
+
+    *index = null_slot;
+    IncreaseSize(1);
+    return true;
+  }
+
   // Judge if it has arrived at the end of array
   if (null_slot_start_ == GetEndOfArray()) {
     null_slot_start_ ++;
@@ -82,10 +121,21 @@ auto RELATION_TYPE::Insert(ValueType value, int *index) -> bool {
 RELATION_TEMPLATE
 auto RELATION_TYPE::Delete(int index) -> bool {
   // Judge if the index is valid
-  if (index >= GetEndOfArray()) {
+  if (index < 0 || index >= GetEndOfArray()) {
     return false;
   }
 
+  if (HasOccupancyBitmap()) {
+    auto occupancy_words = GetOccupancyWords();
+    if (!OccupancyBitmap::Test(occupancy_words, index)) {
+      return false;
+    }
+    OccupancyBitmap::Clear(occupancy_words, index);
+    null_slot_start_ = std::min(null_slot_start_, index);
+    IncreaseSize(-1);
+    return true;
+  }
+
   auto null_slot = GetNullSlotStart();
   auto location = -1;
 
@@ -107,10 +157,14 @@ auto RELATION_TYPE::Delete(int index) -> bool {
 
 RELATION_TEMPLATE
 auto RELATION_TYPE::Get(int index) const -> ValueType {
-  if (index >= GetEndOfArray()) {
+  if (index < 0 || index >= GetEndOfArray()) {
     return {.next_null_slot_ = NULL_SLOT_END};
   }
 
+  if (HasOccupancyBitmap()) {
+    return OccupancyBitmap::Test(GetOccupancyWords(), index) ? array_[index] : ValueType{.next_null_slot_ = INVALID_SLOT_VALUE};
+  }
+
   auto null_slot = GetNullSlotStart();
 
   while (array_[null_slot].next_null_slot_ != NULL_SLOT_END && index > null_slot) {
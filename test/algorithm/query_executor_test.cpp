@@ -0,0 +1,177 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// test/algorithm/query_executor_test.cpp
+//
+//===-----------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <algorithm/query_executor.h>
+#include <common/work_stealing_pool.h>
+#include <gtest/gtest.h>
+
+namespace distribution_lsh {
+
+class QueryExecutorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::mt19937 generator(42);
+    std::normal_distribution<float> distribution(0.0F, 1.0F);
+    data_.resize(static_cast<size_t>(size_) * dimension_);
+    lines_.resize(static_cast<size_t>(line_count_) * dimension_);
+    std::generate(data_.begin(), data_.end(), [&]() { return distribution(generator) * 10.0F; });
+    std::generate(lines_.begin(), lines_.end(), [&]() { return distribution(generator); });
+
+    // Projections of every line sorted by value, as a B+ tree holds them
+    projections_.resize(line_count_);
+    for (int line = 0; line < line_count_; ++line) {
+      for (int i = 0; i < size_; ++i) {
+        projections_[line].emplace_back(Project(line, &data_[static_cast<size_t>(i) * dimension_]), RID(0, i));
+      }
+      std::sort(projections_[line].begin(), projections_[line].end(),
+                [](const auto &left, const auto &right) { return left.first < right.first; });
+    }
+  }
+
+  auto Project(int line, const float *vector) -> float {
+    auto result = 0.0F;
+    for (int i = 0; i < dimension_; ++i) {
+      result += lines_[line * dimension_ + i] * vector[i];
+    }
+    return result;
+  }
+
+  auto Distance(int index, const float *query) -> float {
+    auto result = 0.0F;
+    for (int i = 0; i < dimension_; ++i) {
+      auto difference = data_[static_cast<size_t>(index) * dimension_ + i] - query[i];
+      result += difference * difference;
+    }
+    return std::sqrt(result);
+  }
+
+  auto MakeExecutor(int k, int candidate_budget, int64_t scan_budget, WorkStealingPool *pool = nullptr)
+      -> QueryExecutor<float> {
+    return {[this](int line, float lkey, float rkey, std::vector<RID> *result) {
+              range_read_count_++;
+              for (const auto &[value, rid] : projections_[line]) {
+                if (value >= lkey && value <= rkey) {
+                  result->emplace_back(rid);
+                }
+              }
+              return true;
+            },
+            [this](const RID &rid, float *distance) {
+              verification_count_++;
+              *distance = Distance(static_cast<int>(rid.GetSlotNum()), query_.data());
+              return true;
+            },
+            k, 5, 2.0F, 4.0F, candidate_budget, scan_budget, pool};
+  }
+
+  int dimension_{16};
+  int size_{2000};
+  int line_count_{20};
+  std::atomic<int> range_read_count_{0};
+  std::atomic<int> verification_count_{0};
+  std::vector<float> data_;
+  std::vector<float> lines_;
+  std::vector<float> query_;
+  std::vector<std::vector<std::pair<float, RID>>> projections_;
+};
+
+TEST_F(QueryExecutorTest, EarlyTerminationTest) {
+  // Query next to a data
+  query_.assign(data_.begin() + 7 * dimension_, data_.begin() + 8 * dimension_);
+  query_[0] += 0.5F;
+  std::vector<float> query_projections;
+  for (int line = 0; line < line_count_; ++line) {
+    query_projections.emplace_back(Project(line, query_.data()));
+  }
+
+  auto executor = MakeExecutor(5, size_, size_ * line_count_);
+  auto neighbors = executor.Execute(query_projections);
+  ASSERT_EQ(neighbors.size(), 5);
+  EXPECT_EQ(executor.GetTermination(), QueryTermination::ACCURATE);
+  EXPECT_EQ(neighbors.front().rid_, RID(0, 7));
+  EXPECT_LE(neighbors.back().distance_, 2.0F * executor.GetRadius());
+  EXPECT_LT(executor.GetCandidateCount(), size_);
+  for (size_t i = 1; i < neighbors.size(); ++i) {
+    EXPECT_LE(neighbors[i - 1].distance_, neighbors[i].distance_);
+  }
+
+  // Neighbors are c-approximate for the exact k-th distance
+  std::vector<float> distances;
+  for (int i = 0; i < size_; ++i) {
+    distances.emplace_back(Distance(i, query_.data()));
+  }
+  std::sort(distances.begin(), distances.end());
+  EXPECT_LE(neighbors.back().distance_, 2.0F * distances[4] + 1E-4);
+
+  // Windows of a line are read incrementally, at most twice per line in a round
+  EXPECT_LE(range_read_count_.load(), line_count_ * (2 * executor.GetRoundCount() - 1));
+}
+
+TEST_F(QueryExecutorTest, BudgetTest) {
+  query_.assign(dimension_, 100.0F);
+  std::vector<float> query_projections;
+  for (int line = 0; line < line_count_; ++line) {
+    query_projections.emplace_back(Project(line, query_.data()));
+  }
+
+  // Far from all the data, the budgets stop the query
+  auto candidate_executor = MakeExecutor(5, 10, size_ * line_count_);
+  auto neighbors = candidate_executor.Execute(query_projections);
+  EXPECT_EQ(candidate_executor.GetTermination(), QueryTermination::CANDIDATE_BUDGET);
+  EXPECT_EQ(candidate_executor.GetCandidateCount(), 10);
+  EXPECT_EQ(neighbors.size(), 5);
+
+  auto scan_executor = MakeExecutor(5, size_, 100);
+  scan_executor.Execute(query_projections);
+  EXPECT_EQ(scan_executor.GetTermination(), QueryTermination::SCAN_BUDGET);
+  EXPECT_GE(scan_executor.GetScanCount(), 100);
+
+  auto radius_executor = MakeExecutor(5, size_, size_ * line_count_);
+  neighbors = radius_executor.Execute(query_projections, 1.0F, 2.0F);
+  EXPECT_EQ(radius_executor.GetTermination(), QueryTermination::MAX_RADIUS);
+  EXPECT_EQ(radius_executor.GetRoundCount(), 2);
+  EXPECT_TRUE(neighbors.empty());
+}
+
+TEST_F(QueryExecutorTest, ParallelTest) {
+  WorkStealingPool pool(4);
+  for (int query_index : {3, 11, 500}) {
+    query_.assign(data_.begin() + query_index * dimension_, data_.begin() + (query_index + 1) * dimension_);
+    query_[1] -= 0.3F;
+    std::vector<float> query_projections;
+    for (int line = 0; line < line_count_; ++line) {
+      query_projections.emplace_back(Project(line, query_.data()));
+    }
+
+    // The probes of the query fan out on the pool, the query stops where a serial one does
+    for (auto candidate_budget : {size_, 30}) {
+      auto serial_executor = MakeExecutor(10, candidate_budget, size_ * line_count_);
+      auto parallel_executor = MakeExecutor(10, candidate_budget, size_ * line_count_, &pool);
+      auto serial_neighbors = serial_executor.Execute(query_projections);
+      verification_count_ = 0;
+      auto parallel_neighbors = parallel_executor.Execute(query_projections);
+      EXPECT_LE(verification_count_.load(), candidate_budget);
+      ASSERT_EQ(serial_neighbors.size(), parallel_neighbors.size());
+      for (size_t i = 0; i < serial_neighbors.size(); ++i) {
+        EXPECT_EQ(serial_neighbors[i].rid_, parallel_neighbors[i].rid_);
+        EXPECT_EQ(serial_neighbors[i].distance_, parallel_neighbors[i].distance_);
+      }
+      EXPECT_EQ(serial_executor.GetTermination(), parallel_executor.GetTermination());
+      EXPECT_EQ(serial_executor.GetRoundCount(), parallel_executor.GetRoundCount());
+      EXPECT_EQ(serial_executor.GetCandidateCount(), parallel_executor.GetCandidateCount());
+      EXPECT_EQ(serial_executor.GetScanCount(), parallel_executor.GetScanCount());
+    }
+  }
+}
+
+} // namespace distribution_lsh
@@ -6,17 +6,71 @@
 //===-----------------------------------------------------
 
 #include <buffer/buffer_pool_manager.h>
+#include <common/task.h>
+#include <storage/disk/disk_manager_memory.h>
 #include <storage/page/header_page.h>
 
+#include <atomic>
 #include <cstdio>
+#include <future>  // NOLINT
 #include <sys/stat.h>
 #include <limits>
 #include <random>
 #include <string>
+#include <thread>  // NOLINT
+#include <vector>
 
 #include <gtest/gtest.h>
 
 namespace distribution_lsh {
+
+/** In-memory disk whose next read or write, once armed, waits until it is released */
+class BlockingDiskManager : public DiskManagerUnlimitedMemory {
+ public:
+  void Arm() {
+    // The disk thread may still be leaving the last block
+    while (is_blocking_) {
+      std::this_thread::yield();
+    }
+    blocked_ = std::promise<void>();
+    released_ = std::promise<void>();
+    blocked_future_ = blocked_.get_future();
+    released_future_ = released_.get_future();
+    is_armed_ = true;
+  }
+
+  void WaitBlocked() { blocked_future_.wait(); }
+
+  void Release() { released_.set_value(); }
+
+  void WritePage(page_id_t page_id, const char *page_data) override {
+    Block();
+    DiskManagerUnlimitedMemory::WritePage(page_id, page_data);
+  }
+
+  void ReadPage(page_id_t page_id, char *page_data) override {
+    Block();
+    DiskManagerUnlimitedMemory::ReadPage(page_id, page_data);
+  }
+
+ private:
+  void Block() {
+    if (is_armed_.exchange(false)) {
+      is_blocking_ = true;
+      blocked_.set_value();
+      released_future_.wait();
+      is_blocking_ = false;
+    }
+  }
+
+  std::atomic<bool> is_armed_{false};
+  std::atomic<bool> is_blocking_{false};
+  std::promise<void> blocked_;
+  std::promise<void> released_;
+  std::future<void> blocked_future_;
+  std::future<void> released_future_;
+};
+
 // NOLINTNEXTLINE
 // Check whether pages containing terminal characters can be recovered
 TEST(BufferPoolManagerTest, BinaryDataTest) {
@@ -207,4 +261,300 @@ TEST(BufferPoolManagerTest, DeleteTest) {
   remove("test.db");
   delete bpm;
 }
+// NOLINTNEXTLINE
+// Check that files attached to one buffer pool share its frames
+TEST(BufferPoolManagerTest, SharedPoolTest) {
+  const size_t buffer_pool_size = 10;
+  const size_t k = 5;
+
+  auto buffer_pool = std::make_shared<BufferPool>(buffer_pool_size, k);
+  auto *bpm1 = new BufferPoolManager(buffer_pool, std::make_shared<DiskManager>("shared1.db"));
+  auto *bpm2 = new BufferPoolManager(buffer_pool, std::make_shared<DiskManager>("shared2.db"));
+
+  // Scenario: Both files start at page 0, pages of the same id in two files are different pages.
+  page_id_t page_id_temp;
+  auto page0 = bpm1->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+  snprintf(page0->GetData(), DISTRIBUTION_LSH_PAGE_SIZE, "Hello");
+  page0 = bpm2->NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+  snprintf(page0->GetData(), DISTRIBUTION_LSH_PAGE_SIZE, "World");
+  EXPECT_EQ(buffer_pool_size - 2, buffer_pool->GetFreeFrameCount());
+
+  // Scenario: The pool is one budget, pinned pages of one file leave no frame for the other.
+  for (size_t i = 2; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm2->NewPage(&page_id_temp));
+  }
+  EXPECT_EQ(nullptr, bpm1->NewPage(&page_id_temp));
+
+  // Scenario: Frames unpinned by one file are evicted for the other, dirty pages are written to their own file.
+  for (page_id_t i = 0; i < static_cast<page_id_t>(buffer_pool_size) - 1; ++i) {
+    EXPECT_TRUE(bpm2->UnpinPage(i, true));
+  }
+  EXPECT_TRUE(bpm1->UnpinPage(0, true));
+  for (size_t i = 1; i < buffer_pool_size; ++i) {
+    EXPECT_NE(nullptr, bpm1->NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm1->UnpinPage(page_id_temp, true));
+  }
+  page0 = bpm2->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "World"));
+  EXPECT_TRUE(bpm2->UnpinPage(0, false));
+  page0 = bpm1->FetchPage(0);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, strcmp(page0->GetData(), "Hello"));
+  EXPECT_TRUE(bpm1->UnpinPage(0, false));
+
+  // Scenario: Destroying a manager gives its frames back to the pool.
+  delete bpm1;
+  EXPECT_LT(0U, buffer_pool->GetFreeFrameCount());
+  delete bpm2;
+  EXPECT_EQ(buffer_pool_size, buffer_pool->GetFreeFrameCount());
+
+  remove("shared1.db");
+  remove("shared2.db");
+}
+
+TEST(BufferPoolManagerTest, SharedPoolIOTest) {
+  const size_t buffer_pool_size = 4;
+  auto buffer_pool = std::make_shared<BufferPool>(buffer_pool_size);
+  auto disk_manager1 = std::make_shared<BlockingDiskManager>();
+  BufferPoolManager bpm1(buffer_pool, disk_manager1);
+  BufferPoolManager bpm2(buffer_pool, std::make_shared<DiskManagerUnlimitedMemory>());
+
+  page_id_t page_id_temp;
+  auto page = bpm1.NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), DISTRIBUTION_LSH_PAGE_SIZE, "Hello");
+  EXPECT_TRUE(bpm1.UnpinPage(page_id_temp, true));
+
+  // Scenario: A dirty page of one file is evicted for the other, the other goes on while the page is being written.
+  disk_manager1->Arm();
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm2.NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm2.UnpinPage(page_id_temp, true));
+  }
+  disk_manager1->WaitBlocked();
+  page = bpm2.FetchPage(page_id_temp);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm2.UnpinPage(page_id_temp, false));
+  disk_manager1->Release();
+
+  // Scenario: A read of one file does not hold the pool, and it sees the write queued before it.
+  disk_manager1->Arm();
+  std::thread reader([&]() {
+    auto page = bpm1.FetchPage(0);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(0, strcmp(page->GetData(), "Hello"));
+    EXPECT_TRUE(bpm1.UnpinPage(0, false));
+  });
+  disk_manager1->WaitBlocked();
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm2.NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm2.UnpinPage(page_id_temp, true));
+  }
+  disk_manager1->Release();
+  reader.join();
+}
+
+TEST(BufferPoolManagerTest, SharedPoolEvictionTest) {
+  const size_t buffer_pool_size = 2;
+  auto buffer_pool = std::make_shared<BufferPool>(buffer_pool_size);
+  BufferPoolManager bpm1(buffer_pool, std::make_shared<DiskManager>("shared3.db"));
+  BufferPoolManager bpm2(buffer_pool, std::make_shared<DiskManagerUnlimitedMemory>());
+
+  // Scenario: A page fetched past the end of the file and then allocated lives in the newer frame, evicting the
+  // older frame keeps it.
+  auto page = bpm1.FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_TRUE(bpm1.UnpinPage(0, false));
+  page_id_t page_id_temp;
+  auto page0 = bpm1.NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page0);
+  EXPECT_EQ(0, page_id_temp);
+  snprintf(page0->GetData(), DISTRIBUTION_LSH_PAGE_SIZE, "Hello");
+  ASSERT_NE(nullptr, bpm2.NewPage(&page_id_temp));
+  EXPECT_TRUE(bpm2.UnpinPage(page_id_temp, true));
+  EXPECT_EQ(page0, bpm1.FetchPage(0));
+
+  // Scenario: A clean unpin does not clear the dirty flag of another pin, the evicted page is written back.
+  EXPECT_TRUE(bpm1.UnpinPage(0, true));
+  EXPECT_TRUE(bpm1.UnpinPage(0, false));
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm2.NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm2.UnpinPage(page_id_temp, true));
+  }
+  page = bpm1.FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, strcmp(page->GetData(), "Hello"));
+  EXPECT_TRUE(bpm1.UnpinPage(0, false));
+
+  remove("shared3.db");
+}
+
+TEST(BufferPoolManagerTest, SharedPoolFlushTest) {
+  const size_t buffer_pool_size = 2;
+  auto buffer_pool = std::make_shared<BufferPool>(buffer_pool_size);
+  auto disk_manager1 = std::make_shared<BlockingDiskManager>();
+  BufferPoolManager bpm1(buffer_pool, disk_manager1);
+  BufferPoolManager bpm2(buffer_pool, std::make_shared<DiskManagerUnlimitedMemory>());
+
+  page_id_t page_id_temp;
+  auto page = bpm1.NewPage(&page_id_temp);
+  ASSERT_NE(nullptr, page);
+  snprintf(page->GetData(), DISTRIBUTION_LSH_PAGE_SIZE, "Hello");
+  EXPECT_TRUE(bpm1.UnpinPage(page_id_temp, true));
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    ASSERT_NE(nullptr, bpm2.NewPage(&page_id_temp));
+    EXPECT_TRUE(bpm2.UnpinPage(page_id_temp, true));
+  }
+  ASSERT_NE(nullptr, bpm1.FetchPage(0));
+  EXPECT_TRUE(bpm1.UnpinPage(0, false));
+
+  // Scenario: The clean frame of a flush is taken by the other file while the flush is being written, the page on disk
+  // is the flushed one.
+  disk_manager1->Arm();
+  std::thread flusher([&]() { bpm1.FlushAllPages(); });
+  disk_manager1->WaitBlocked();
+  for (size_t i = 0; i < buffer_pool_size; ++i) {
+    page = bpm2.NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), DISTRIBUTION_LSH_PAGE_SIZE, "World");
+    EXPECT_TRUE(bpm2.UnpinPage(page_id_temp, true));
+  }
+  disk_manager1->Release();
+  flusher.join();
+
+  page = bpm1.FetchPage(0);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, strcmp(page->GetData(), "Hello"));
+  EXPECT_TRUE(bpm1.UnpinPage(0, false));
+}
+
+TEST(BufferPoolManagerTest, ReservePagesTest) {
+  const size_t buffer_pool_size = 2;
+  BufferPoolManager bpm(buffer_pool_size, std::make_shared<DiskManagerUnlimitedMemory>());
+  page_id_t page_id_temp;
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id_temp));
+  EXPECT_TRUE(bpm.UnpinPage(page_id_temp, false));
+
+  // Scenario: A run of page ids is contiguous, pages allocated meanwhile come after it.
+  auto first_page_id = bpm.ReservePages(3);
+  EXPECT_EQ(1, first_page_id);
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id_temp));
+  EXPECT_EQ(4, page_id_temp);
+  EXPECT_TRUE(bpm.UnpinPage(page_id_temp, false));
+
+  // Scenario: Reserved pages are created on their ids, creating one fails while all frames are pinned.
+  std::vector<BasicPageGuard> guards;
+  for (page_id_t page_id = first_page_id; page_id < first_page_id + 2; ++page_id) {
+    page_id_temp = page_id;
+    guards.emplace_back(bpm.NewReservedPageGuarded(&page_id_temp));
+    ASSERT_EQ(page_id, page_id_temp);
+    EXPECT_EQ(page_id, guards.back().PageId());
+    snprintf(guards.back().AsMut<char>(), DISTRIBUTION_LSH_PAGE_SIZE, "Page %d", page_id);
+  }
+  page_id_temp = first_page_id + 2;
+  bpm.NewReservedPageGuarded(&page_id_temp);
+  EXPECT_EQ(INVALID_PAGE_ID, page_id_temp);
+  guards.clear();
+
+  // Scenario: An unused reserved id is given back and allocated again, the created pages survive eviction.
+  bpm.ReleasePages(first_page_id + 2, 1);
+  ASSERT_NE(nullptr, bpm.NewPage(&page_id_temp));
+  EXPECT_EQ(first_page_id + 2, page_id_temp);
+  EXPECT_TRUE(bpm.UnpinPage(page_id_temp, false));
+  for (page_id_t page_id = first_page_id; page_id < first_page_id + 2; ++page_id) {
+    auto guard = bpm.FetchPageRead(page_id);
+    EXPECT_EQ("Page " + std::to_string(page_id), guard.As<char>());
+  }
+}
+
+TEST(BufferPoolManagerTest, AsyncFetchTest) {
+  const size_t buffer_pool_size = 10;
+  const int page_count = 30;
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < page_count; ++i) {
+    auto page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), DISTRIBUTION_LSH_PAGE_SIZE, "Page %d", i);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+
+  auto read = [&bpm](page_id_t page_id) -> Task<std::string> {
+    auto guard = co_await bpm->FetchPageReadAsync(page_id);
+    co_return std::string(guard.GetData());
+  };
+
+  // Scenario: The misses of a batch are in flight together, fetches of a page being read wait for the same read.
+  for (int start = 0; start < page_count; start += 6) {
+    std::vector<Task<std::string>> tasks;
+    std::vector<int> page_ids;
+    for (int i = start; i < start + 6; ++i) {
+      page_ids.emplace_back(i);
+      page_ids.emplace_back(i);
+    }
+    for (auto page_id : page_ids) {
+      tasks.emplace_back(read(page_id));
+    }
+    auto contents = SyncWait(WhenAll(std::move(tasks)));
+    ASSERT_EQ(page_ids.size(), contents.size());
+    for (size_t i = 0; i < contents.size(); ++i) {
+      EXPECT_EQ("Page " + std::to_string(page_ids[i]), contents[i]);
+    }
+  }
+
+  // Scenario: A page read by an asynchronous fetch is seen by the synchronous one, and pins are released.
+  EXPECT_EQ("Page 29", SyncWait(read(29)));
+  auto page = bpm->FetchPage(29);
+  ASSERT_NE(nullptr, page);
+  EXPECT_EQ(0, strcmp(page->GetData(), "Page 29"));
+  EXPECT_EQ(1, page->GetPinCount());
+  EXPECT_TRUE(bpm->UnpinPage(29, false));
+}
+
+TEST(BufferPoolManagerTest, AsyncFetchBlockedWorkersTest) {
+  const size_t buffer_pool_size = 10;
+  const int page_count = 20;
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_unique<BufferPoolManager>(buffer_pool_size, disk_manager);
+
+  page_id_t page_id_temp;
+  for (int i = 0; i < page_count; ++i) {
+    auto page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), DISTRIBUTION_LSH_PAGE_SIZE, "Page %d", i);
+    EXPECT_TRUE(bpm->UnpinPage(page_id_temp, true));
+  }
+  disk_manager->EnableLatencySimulator(true);
+
+  auto read = [&bpm](page_id_t page_id) -> Task<std::string> {
+    auto guard = co_await bpm->FetchPageReadAsync(page_id);
+    co_return std::string(guard.GetData());
+  };
+  auto read_on_worker = [&bpm](page_id_t page_id) -> Task<std::string> {
+    co_await ResumeOnPool();
+    auto page = bpm->FetchPage(page_id);
+    std::string data(page->GetData());
+    bpm->UnpinPage(page_id, false);
+    co_return data;
+  };
+
+  // Scenario: The first task starts reading the page, every worker of the shared pool then blocks in a synchronous
+  // fetch of the same page, the read must finish without a free worker.
+  std::vector<Task<std::string>> tasks;
+  tasks.emplace_back(read(0));
+  for (size_t i = 0; i < WorkStealingPool::GetInstance().GetThreadCount(); ++i) {
+    tasks.emplace_back(read_on_worker(0));
+  }
+  for (const auto &content : SyncWait(WhenAll(std::move(tasks)))) {
+    EXPECT_EQ("Page 0", content);
+  }
+}
+
 } // namespace distribution_lsh
\ No newline at end of file
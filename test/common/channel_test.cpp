@@ -0,0 +1,66 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// test/common/channel_test.cpp
+//
+//===-----------------------------------------------------
+
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <common/channel.h>
+#include <gtest/gtest.h>
+
+namespace distribution_lsh {
+
+TEST(ChannelTest, MultiProducerMultiConsumerTest) {
+  // A small ring, so that producers block on a full channel as well as consumers on an empty one
+  Channel<std::unique_ptr<int>> channel(8);
+  const int producer_count = 4;
+  const int consumer_count = 3;
+  const int element_count = 10000;
+
+  std::vector<std::thread> threads;
+  for (int producer = 0; producer < producer_count; ++producer) {
+    threads.emplace_back([&, producer]() {
+      for (int i = 0; i < element_count; ++i) {
+        channel.Put(std::make_unique<int>(producer * element_count + i));
+      }
+    });
+  }
+
+  std::vector<std::vector<int>> received(consumer_count);
+  for (int consumer = 0; consumer < consumer_count; ++consumer) {
+    threads.emplace_back([&, consumer]() {
+      // A null element ends the stream of a consumer
+      for (auto element = channel.Get(); element != nullptr; element = channel.Get()) {
+        received[consumer].emplace_back(*element);
+      }
+    });
+  }
+  for (int producer = 0; producer < producer_count; ++producer) {
+    threads[producer].join();
+  }
+  for (int consumer = 0; consumer < consumer_count; ++consumer) {
+    channel.Put(nullptr);
+  }
+  for (int consumer = 0; consumer < consumer_count; ++consumer) {
+    threads[producer_count + consumer].join();
+  }
+
+  // Every element is received once, the elements of a producer in the order they were put
+  std::vector<int> counts(producer_count * element_count, 0);
+  for (const auto &elements : received) {
+    std::vector<int> last(producer_count, -1);
+    for (auto element : elements) {
+      counts[element]++;
+      EXPECT_LT(last[element / element_count], element);
+      last[element / element_count] = element;
+    }
+  }
+  EXPECT_EQ(std::count(counts.begin(), counts.end(), 1), producer_count * element_count);
+}
+
+} // namespace distribution_lsh
@@ -0,0 +1,129 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// test/common/work_stealing_pool_test.cpp
+//
+//===-----------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <common/exception.h>
+#include <common/work_stealing_pool.h>
+#include <gtest/gtest.h>
+
+namespace distribution_lsh {
+
+TEST(WorkStealingPoolTest, TaskGroupTest) {
+  WorkStealingPool pool(3);
+  std::atomic<int> sum{0};
+
+  // Groups waited for inside tasks of the same pool
+  TaskGroup task_group(&pool);
+  for (int i = 0; i < 8; ++i) {
+    task_group.Run([&pool, &sum, i]() {
+      TaskGroup inner_group(&pool);
+      for (int j = 0; j < 100; ++j) {
+        inner_group.Run([&sum, i, j]() { sum += i * 100 + j; });
+      }
+      inner_group.Wait();
+    });
+  }
+  task_group.Wait();
+  EXPECT_EQ(sum.load(), 800 * 799 / 2);
+
+  task_group.Run([]() { throw Exception("task failed"); });
+  EXPECT_THROW(task_group.Wait(), Exception);
+}
+
+TEST(WorkStealingPoolTest, TaskGroupWaitTest) {
+  WorkStealingPool pool(1);
+  std::atomic<bool> is_released{false};
+  std::atomic<bool> is_other_task_run{false};
+  std::thread::id other_task_thread_id;
+
+  // The only worker is busy, the waiting thread runs the tasks of its group but leaves the task queued after them
+  pool.Submit([&]() {
+    while (!is_released.load()) {
+      std::this_thread::yield();
+    }
+  });
+  TaskGroup task_group(&pool);
+  std::atomic<int> sum{0};
+  for (int i = 0; i < 10; ++i) {
+    task_group.Run([&sum, i]() { sum += i; });
+  }
+  pool.Submit([&]() {
+    other_task_thread_id = std::this_thread::get_id();
+    is_other_task_run = true;
+  });
+  task_group.Wait();
+  EXPECT_EQ(sum.load(), 45);
+  EXPECT_FALSE(is_other_task_run.load());
+
+  // A task started by a worker is waited for without being run again
+  std::atomic<bool> is_started{false};
+  TaskGroup blocked_group(&pool);
+  is_released = true;
+  while (!is_other_task_run.load()) {
+    std::this_thread::yield();
+  }
+  EXPECT_NE(other_task_thread_id, std::this_thread::get_id());
+  blocked_group.Run([&]() {
+    is_started = true;
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    sum += 100;
+  });
+  while (!is_started.load()) {
+    std::this_thread::yield();
+  }
+  blocked_group.Wait();
+  EXPECT_EQ(sum.load(), 145);
+}
+
+TEST(WorkStealingPoolTest, ParallelForTest) {
+  WorkStealingPool pool(3);
+
+  // Every index is covered once by ranges of grain size at least
+  std::vector<int> counts(1000, 0);
+  std::atomic<int> range_count{0};
+  ParallelFor(&pool, 0, 1000, 50, [&](int begin, int end) {
+    EXPECT_GE(end - begin, 50);
+    for (int i = begin; i < end; ++i) {
+      counts[i]++;
+    }
+    range_count++;
+  });
+  EXPECT_EQ(std::count(counts.begin(), counts.end(), 1), 1000);
+  EXPECT_EQ(range_count.load(), 12);
+
+  // Small ranges run on the calling thread
+  ParallelFor(&pool, int64_t{0}, int64_t{10}, int64_t{100}, [&](int64_t begin, int64_t end) {
+    EXPECT_EQ(end - begin, 10);
+  });
+
+  // Nested loops run on the same pool, a worker waiting for the inner loop runs its ranges
+  std::atomic<int64_t> sum{0};
+  ParallelFor(&pool, int64_t{0}, int64_t{10}, int64_t{1}, [&](int64_t begin, int64_t end) {
+    for (auto i = begin; i < end; ++i) {
+      ParallelFor(&pool, 0, 100, 1, [&](int inner_begin, int inner_end) {
+        for (int j = inner_begin; j < inner_end; ++j) {
+          sum += i * 100 + j;
+        }
+      });
+    }
+  });
+  EXPECT_EQ(sum.load(), 1000 * 999 / 2);
+
+  EXPECT_THROW(ParallelFor(&pool, 0, 100, 1, [](int begin, int) {
+                 if (begin == 0) {
+                   throw Exception("range failed");
+                 }
+               }),
+               Exception);
+}
+
+} // namespace distribution_lsh
@@ -0,0 +1,84 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// test/dataset/distribution_dataset_column_store_test.cpp
+//
+//===-----------------------------------------------------
+
+#include <cmath>
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+#include <common/util/file.h>
+#include <dataset/distribution/distribution_dataset_column_store.h>
+#include <storage/disk/disk_manager_memory.h>
+#include <gtest/gtest.h>
+
+namespace distribution_lsh {
+
+TEST(DistributionDataSetColumnStoreTest, BuildAndProjectTest) {
+  auto dimension = 15;
+  std::shared_ptr<float[2]> params(new float[2]{0.0, 1.0});
+  auto manager = std::make_shared<DistributionDataSetManager<float>>(
+      "manager", DataSetType::GENERATION, DistributionType::GAUSSIAN, NormalizationType::MIN_MAX,
+      std::make_shared<BufferPoolManager>(10, std::make_shared<DiskManagerUnlimitedMemory>()),
+      std::make_shared<BufferPoolManager>(10, std::make_shared<DiskManagerUnlimitedMemory>()),
+      std::make_unique<DistributionDatasetProcessor<float>>(), INVALID_PAGE_ID, INVALID_PAGE_ID, dimension, params,
+      "fake directory", 0x8000'0000UL | GetHashValue("training set"), 0x8000'0000UL | GetHashValue("testing set"),
+      10, 10);
+  manager->GenerateDistributionDataset(150, 1.0);
+
+  // Deleted data is left out of the column store
+  auto directory_page_id = INVALID_PAGE_ID;
+  auto slot = NULL_SLOT_END;
+  manager->GetDistributionData(true, 42, &directory_page_id, &slot);
+  ASSERT_TRUE(manager->Delete(true, directory_page_id, slot));
+  auto rids = manager->GetRIDs(true);
+  ASSERT_EQ(rids.size(), 149);
+
+  auto file_name = (std::filesystem::temp_directory_path() / "distribution_lsh_column_store_test.dc").string();
+  DistributionDataSetColumnStore<float>::Build(manager.get(), true, file_name, 64);
+  DistributionDataSetColumnStore<float> column_store(file_name);
+  ASSERT_EQ(column_store.GetSize(), 149);
+  ASSERT_EQ(column_store.GetDimension(), dimension);
+  ASSERT_EQ(column_store.GetBlockCount(), 3);
+
+  // Blocks keep the values dimension by dimension
+  std::vector<float> data(rids.size() * dimension);
+  ASSERT_EQ(manager->GetDistributionDataBatch(true, rids, data.data()), 149);
+  for (int64_t block_index = 0; block_index < column_store.GetBlockCount(); ++block_index) {
+    auto rows = 0;
+    auto block = column_store.GetBlock(block_index, &rows);
+    ASSERT_EQ(rows, block_index == 2 ? 21 : 64);
+    for (int row = 0; row < rows; ++row) {
+      auto index = block_index * 64 + row;
+      ASSERT_EQ(column_store.GetRID(index), rids[index]);
+      for (int i = 0; i < dimension; ++i) {
+        ASSERT_EQ(block[i * 64 + row], data[index * dimension + i]);
+      }
+    }
+  }
+
+  // Projections match the inner products of the rows
+  auto line_count = 5;
+  std::vector<float> lines(static_cast<size_t>(line_count) * dimension);
+  for (size_t i = 0; i < lines.size(); ++i) {
+    lines[i] = std::sin(static_cast<float>(i));
+  }
+  std::vector<float> projections(rids.size() * line_count);
+  column_store.Project(lines.data(), line_count, projections.data());
+  for (size_t index = 0; index < rids.size(); ++index) {
+    for (int line = 0; line < line_count; ++line) {
+      auto expected = 0.0F;
+      for (int i = 0; i < dimension; ++i) {
+        expected += data[index * dimension + i] * lines[line * dimension + i];
+      }
+      ASSERT_NEAR(projections[index * line_count + line], expected, 1E-5);
+    }
+  }
+
+  std::filesystem::remove(file_name);
+}
+
+} // namespace distribution_lsh
@@ -67,4 +67,74 @@ TEST(DistributionDataSetDirectoryPageTest, DeleteTest) {
   ASSERT_EQ(directory_page->IndexAt(7), -1);
 }
 
+TEST(DistributionDataSetDirectoryPageTest, OccupancyBitmapTest) {
+  char raw_data[DISTRIBUTION_LSH_PAGE_SIZE];
+  auto directory_page = reinterpret_cast<DistributionDataSetDirectoryPage*>(raw_data);
+  directory_page->Init();
+  ASSERT_TRUE(directory_page->HasOccupancyBitmap());
+  ASSERT_EQ(directory_page->GetMaxSize(), DISTRIBUTION_DATASET_DIRECTORY_PAGE_SIZE);
+
+  // The default size is the largest one whose slots and bitmap fit in the page
+  auto bytes = [](int slots) {
+    return sizeof(DistributionDataSetDirectoryPage) + slots * sizeof(page_id_t)
+        + OccupancyBitmap::WordCount(slots) * sizeof(occupancy_word_t);
+  };
+  ASSERT_LE(bytes(DISTRIBUTION_DATASET_DIRECTORY_PAGE_SIZE), DISTRIBUTION_LSH_PAGE_SIZE);
+  ASSERT_GT(bytes(DISTRIBUTION_DATASET_DIRECTORY_PAGE_SIZE + 1), DISTRIBUTION_LSH_PAGE_SIZE);
+
+  // Fill the whole page
+  for (int i = 0; i < directory_page->GetMaxSize(); ++i) {
+    auto index = 0;
+    ASSERT_TRUE(directory_page->Insert(i, &index));
+    ASSERT_EQ(index, i);
+  }
+  ASSERT_EQ(directory_page->GetNullSlotStart(), directory_page->GetMaxSize());
+
+  // Delete slots across bitmap words, deleting twice fails
+  std::vector<int> deleted_slots{31, 32, 64, 500, directory_page->GetMaxSize() - 1};
+  for (auto slot : deleted_slots) {
+    ASSERT_TRUE(directory_page->Delete(slot));
+    ASSERT_FALSE(directory_page->Delete(slot));
+    ASSERT_EQ(directory_page->IndexAt(slot), INVALID_PAGE_ID);
+  }
+  ASSERT_EQ(directory_page->IndexAt(30), 30);
+  ASSERT_EQ(directory_page->IndexAt(33), 33);
+  ASSERT_EQ(directory_page->GetNullSlotStart(), 31);
+
+  // Free slots are reused from the lowest one
+  for (auto slot : deleted_slots) {
+    auto index = 0;
+    ASSERT_TRUE(directory_page->Insert(slot + 1000, &index));
+    ASSERT_EQ(index, slot);
+    ASSERT_EQ(directory_page->IndexAt(slot), slot + 1000);
+  }
+  ASSERT_EQ(directory_page->GetSize(), directory_page->GetMaxSize());
+  ASSERT_EQ(directory_page->GetNullSlotStart(), directory_page->GetMaxSize());
+}
+
+TEST(DistributionDataSetDirectoryPageTest, NullSlotListTest) {
+  char raw_data[DISTRIBUTION_LSH_PAGE_SIZE];
+  auto directory_page = reinterpret_cast<DistributionDataSetDirectoryPage*>(raw_data);
+
+  // Pages written before the occupancy bitmap fill the whole page with slots
+  directory_page->Init((DISTRIBUTION_LSH_PAGE_SIZE - DISTRIBUTION_DATASET_DIRECTORY_PAGE_HEADER_SIZE) / sizeof(page_id_t));
+  ASSERT_FALSE(directory_page->HasOccupancyBitmap());
+
+  for (int i = 0; i < 10; ++i) {
+    auto index = 0;
+    directory_page->Insert(i, &index);
+  }
+  directory_page->Delete(7);
+  directory_page->Delete(5);
+  ASSERT_EQ(directory_page->GetNullSlotStart(), 5);
+  ASSERT_EQ(directory_page->IndexAt(5), -1);
+  ASSERT_EQ(directory_page->IndexAt(6), 6);
+  ASSERT_EQ(directory_page->IndexAt(7), -1);
+
+  auto index = 0;
+  directory_page->Insert(10, &index);
+  ASSERT_EQ(index, 5);
+  ASSERT_EQ(directory_page->GetNullSlotStart(), 7);
+}
+
 } // namespace distribution_lsh
\ No newline at end of file
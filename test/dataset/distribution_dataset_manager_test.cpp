@@ -5,7 +5,9 @@
 //
 //===-----------------------------------------------------
 
+#include <cmath>
 #include <memory>
+#include <utility>
 #include <vector>
 #include <common/util/file.h>
 #include <storage/disk/disk_manager_memory.h>
@@ -55,11 +57,15 @@ class DistributionDataSetManagerTest : public ::testing::Test {
 
     directory_page_max_size_ = directory_page_max_size;
     dimension_ = dimension;
+    training_set_bpm_ = training_set_bpm;
+    testing_set_bpm_ = testing_set_bpm;
   }
 
   void TearDown() override {}
 
   std::shared_ptr<DistributionDataSetManager<float>> manager_;
+  std::shared_ptr<BufferPoolManager> training_set_bpm_;
+  std::shared_ptr<BufferPoolManager> testing_set_bpm_;
   int directory_page_max_size_;
   int dimension_;
 };
@@ -159,4 +165,353 @@ TEST_F(DistributionDataSetManagerTest, GetTest1) {
     ASSERT_TRUE(std::abs(sum - 1.0F) < 1E-5);
   }
 }
-} // namespace distribution_lsh
\ No newline at end of file
+
+TEST_F(DistributionDataSetManagerTest, DistanceTest1) {
+  // Test generation
+  manager_->GenerateDistributionDataset(100, 0.7);
+
+  std::vector<float> query(dimension_, 0.0F);
+  for (int index = 0; index < 70; index++) {
+    auto directory_page_id = INVALID_PAGE_ID;
+    auto slot = NULL_SLOT_END;
+    auto data = manager_->GetDistributionData(true, index, &directory_page_id, &slot);
+    ASSERT_NE(directory_page_id, INVALID_PAGE_ID);
+
+    // Visit the data without copy and compare with the copied one
+    auto visited_size = 0;
+    ASSERT_TRUE(manager_->VisitDistributionData(true, directory_page_id, slot,
+                                                [&](const float *chunk, int offset, int length) {
+      for (int j = 0; j < length; ++j) {
+        ASSERT_EQ(chunk[j], data[offset + j]);
+      }
+      visited_size += length;
+    }));
+    ASSERT_EQ(visited_size, dimension_);
+
+    // Min-max normalized data sum to one, so its l1 distance to origin is one
+    auto distance = 0.0F;
+    ASSERT_TRUE(manager_->Distance(true, directory_page_id, slot, query.data(), 1.0F, &distance));
+    ASSERT_TRUE(std::abs(distance - 1.0F) < 1E-5);
+
+    auto expected = 0.0F;
+    for (int j = 0; j < dimension_; ++j) {
+      expected += data[j] * data[j];
+    }
+    ASSERT_TRUE(manager_->Distance(true, directory_page_id, slot, query.data(), 2.0F, &distance));
+    ASSERT_TRUE(std::abs(distance - std::sqrt(expected)) < 1E-5);
+  }
+}
+
+TEST_F(DistributionDataSetManagerTest, GetBatchTest1) {
+  // Test generation
+  manager_->GenerateDistributionDataset(100, 0.7);
+
+  // Collect the locations in reverse order, so that the batch has to regroup them
+  std::vector<RID> rids;
+  for (int index = 69; index >= 0; index--) {
+    auto directory_page_id = INVALID_PAGE_ID;
+    auto slot = NULL_SLOT_END;
+    manager_->GetDistributionData(true, index, &directory_page_id, &slot);
+    ASSERT_NE(directory_page_id, INVALID_PAGE_ID);
+    rids.emplace_back(directory_page_id, slot);
+  }
+
+  // Delete one of them
+  ASSERT_TRUE(manager_->Delete(true, rids[5].GetPageId(), static_cast<int>(rids[5].GetSlotNum())));
+
+  std::vector<float> batch(rids.size() * dimension_);
+  std::vector<bool> is_found;
+  ASSERT_EQ(manager_->GetDistributionDataBatch(true, rids, batch.data(), &is_found), 69);
+  for (size_t i = 0; i < rids.size(); ++i) {
+    if (i == 5) {
+      ASSERT_FALSE(is_found[i]);
+      continue;
+    }
+
+    ASSERT_TRUE(is_found[i]);
+    auto data = manager_->GetDistributionData(true, rids[i].GetPageId(), static_cast<int>(rids[i].GetSlotNum()));
+    for (int j = 0; j < dimension_; ++j) {
+      ASSERT_EQ(batch[i * dimension_ + j], data[j]);
+    }
+  }
+}
+
+TEST_F(DistributionDataSetManagerTest, GetAsyncTest1) {
+  manager_->GenerateDistributionDataset(100, 0.7);
+
+  std::vector<RID> rids;
+  for (int index = 0; index < 70; index++) {
+    auto directory_page_id = INVALID_PAGE_ID;
+    auto slot = NULL_SLOT_END;
+    manager_->GetDistributionData(true, index, &directory_page_id, &slot);
+    ASSERT_NE(directory_page_id, INVALID_PAGE_ID);
+    rids.emplace_back(directory_page_id, slot);
+  }
+  ASSERT_TRUE(manager_->Delete(true, rids[5].GetPageId(), static_cast<int>(rids[5].GetSlotNum())));
+
+  // A few reads in flight together, a task pins one page at a time
+  for (size_t start = 0; start < rids.size(); start += 7) {
+    std::vector<Task<std::shared_ptr<float[]>>> tasks;
+    for (auto i = start; i < start + 7; ++i) {
+      tasks.emplace_back(manager_->GetDistributionDataAsync(true, rids[i].GetPageId(),
+                                                            static_cast<int>(rids[i].GetSlotNum())));
+    }
+    auto results = SyncWait(WhenAll(std::move(tasks)));
+    for (auto i = start; i < start + 7; ++i) {
+      if (i == 5) {
+        ASSERT_EQ(results[i - start], nullptr);
+        continue;
+      }
+      ASSERT_NE(results[i - start], nullptr);
+      auto data = manager_->GetDistributionData(true, rids[i].GetPageId(), static_cast<int>(rids[i].GetSlotNum()));
+      for (int j = 0; j < dimension_; ++j) {
+        ASSERT_EQ(results[i - start][j], data[j]);
+      }
+    }
+  }
+}
+
+TEST_F(DistributionDataSetManagerTest, StoreBatchTest1) {
+  // Leave the tail directory page half full
+  manager_->GenerateDistributionDataset(15, 1.0);
+  ASSERT_EQ(manager_->GetSize(true), 15);
+
+  // The batch fills the tail directory page and appends new ones
+  auto size = 37;
+  std::vector<float> distribution(static_cast<size_t>(size) * dimension_);
+  for (size_t i = 0; i < distribution.size(); ++i) {
+    distribution[i] = static_cast<float>(i);
+  }
+  auto rids = manager_->StoreBatch(true, distribution.data(), size);
+  ASSERT_EQ(static_cast<int>(rids.size()), size);
+  ASSERT_EQ(manager_->GetSize(true), 15 + size);
+
+  for (int i = 0; i < size; ++i) {
+    auto data = manager_->GetDistributionData(true, rids[i].GetPageId(), static_cast<int>(rids[i].GetSlotNum()));
+    ASSERT_NE(data, nullptr);
+    for (int j = 0; j < dimension_; ++j) {
+      ASSERT_EQ(data[j], distribution[static_cast<size_t>(i) * dimension_ + j]);
+    }
+
+    // Global index follows the insertion order
+    auto directory_page_id = INVALID_PAGE_ID;
+    auto slot = NULL_SLOT_END;
+    manager_->GetDistributionData(true, 15 + i, &directory_page_id, &slot);
+    ASSERT_EQ(directory_page_id, rids[i].GetPageId());
+    ASSERT_EQ(slot, static_cast<int>(rids[i].GetSlotNum()));
+  }
+}
+
+TEST_F(DistributionDataSetManagerTest, ReopenTest1) {
+  // Test generation
+  manager_->GenerateDistributionDataset(100, 0.7);
+
+  // Delete a whole directory page, so that the later global index shift
+  for (int slot = 0; slot < directory_page_max_size_; ++slot) {
+    auto directory_page_id = INVALID_PAGE_ID;
+    auto index = NULL_SLOT_END;
+    manager_->GetDistributionData(true, directory_page_max_size_, &directory_page_id, &index);
+    ASSERT_TRUE(manager_->Delete(true, directory_page_id, slot));
+  }
+  ASSERT_EQ(manager_->GetSize(true), 60);
+
+  // Reopen the data set, the directory index is rebuilt from the directory chain
+  auto reopened_manager = std::make_shared<DistributionDataSetManager<float>>(
+      "reopened manager", DataSetType::INVALID_DATA_SET_TYPE, DistributionType::INVALID_DISTRIBUTION_TYPE,
+      NormalizationType::INVALID_NORMALIZATION_TYPE, training_set_bpm_, testing_set_bpm_, nullptr, HEADER_PAGE_ID,
+      HEADER_PAGE_ID, INVALID_DIMENSION, nullptr, "fake directory", INVALID_FILE_ID, INVALID_FILE_ID,
+      directory_page_max_size_, 10);
+  ASSERT_EQ(reopened_manager->GetSize(true), 60);
+  ASSERT_EQ(reopened_manager->GetSize(false), 30);
+
+  for (int index = 0; index < 60; index++) {
+    auto directory_page_id = INVALID_PAGE_ID;
+    auto slot = NULL_SLOT_END;
+    auto data = manager_->GetDistributionData(true, index, &directory_page_id, &slot);
+    auto reopened_directory_page_id = INVALID_PAGE_ID;
+    auto reopened_slot = NULL_SLOT_END;
+    auto reopened_data =
+        reopened_manager->GetDistributionData(true, index, &reopened_directory_page_id, &reopened_slot);
+    ASSERT_EQ(directory_page_id, reopened_directory_page_id);
+    ASSERT_EQ(slot, reopened_slot);
+    for (int j = 0; j < dimension_; ++j) {
+      ASSERT_EQ(data[j], reopened_data[j]);
+    }
+  }
+}
+TEST_F(DistributionDataSetManagerTest, LegacyHeaderTest1) {
+  manager_->GenerateDistributionDataset(100, 0.7);
+  ASSERT_TRUE(manager_->Delete(true, 1, 3));
+  auto make_reopened_manager = [&]() {
+    return std::make_shared<DistributionDataSetManager<float>>(
+        "reopened manager", DataSetType::INVALID_DATA_SET_TYPE, DistributionType::INVALID_DISTRIBUTION_TYPE,
+        NormalizationType::INVALID_NORMALIZATION_TYPE, training_set_bpm_, testing_set_bpm_, nullptr, HEADER_PAGE_ID,
+        HEADER_PAGE_ID, INVALID_DIMENSION, nullptr, "fake directory", INVALID_FILE_ID, INVALID_FILE_ID,
+        directory_page_max_size_, 10);
+  };
+  auto make_legacy = [](BufferPoolManager *bpm, DataSetType data_set_type) {
+    auto header_page_guard = bpm->FetchPageWrite(HEADER_PAGE_ID);
+    auto header_page = header_page_guard.AsMut<DistributionDataSetHeaderPage>();
+    header_page->SetDataSetType(data_set_type);
+    header_page->SetSize(0);
+    header_page->SetFormatVersion(0);
+  };
+
+  // The generation parameters of a file written before the header page kept the size moved, it is refused
+  {
+    auto header_page_guard = training_set_bpm_->FetchPageRead(HEADER_PAGE_ID);
+    ASSERT_EQ(header_page_guard.As<DistributionDataSetHeaderPage>()->GetFormatVersion(),
+              DISTRIBUTION_DATASET_HEADER_PAGE_VERSION);
+  }
+  make_legacy(training_set_bpm_.get(), DataSetType::GENERATION);
+  ASSERT_THROW(make_reopened_manager(), Exception);
+
+  // The size of the other data set types is recounted from the directory pages on the first open
+  make_legacy(training_set_bpm_.get(), DataSetType::MNIST);
+  make_legacy(testing_set_bpm_.get(), DataSetType::MNIST);
+  auto reopened_manager = make_reopened_manager();
+  ASSERT_EQ(reopened_manager->GetSize(true), 69);
+  ASSERT_EQ(reopened_manager->GetSize(false), 30);
+  auto header_page_guard = training_set_bpm_->FetchPageRead(HEADER_PAGE_ID);
+  ASSERT_EQ(header_page_guard.As<DistributionDataSetHeaderPage>()->GetFormatVersion(),
+            DISTRIBUTION_DATASET_HEADER_PAGE_VERSION);
+}
+
+TEST_F(DistributionDataSetManagerTest, IngestTest1) {
+  // Several chunks are streamed into pages in order
+  auto size = 3 * DISTRIBUTION_DATASET_CHUNK_SIZE + 7;
+  manager_->SetSeed(42);
+  manager_->GenerateDistributionDataset(size, 1.0);
+  ASSERT_EQ(manager_->GetSize(true), size);
+  ASSERT_EQ(manager_->GetSize(false), 0);
+
+  DistributionDatasetProcessor<float> ddp;
+  float params[2] = {0.0, 1.0};
+  std::vector<float> expected_data(static_cast<size_t>(size) * dimension_);
+  ddp.GenerationDistributionDataset(expected_data.data(), dimension_, 0, size, DistributionType::GAUSSIAN,
+                                    NormalizationType::MIN_MAX, params, 42);
+
+  for (int index = 0; index < size; ++index) {
+    auto directory_page_id = INVALID_PAGE_ID;
+    auto slot = -1;
+    auto data = manager_->GetDistributionData(true, index, &directory_page_id, &slot);
+    ASSERT_NE(data, nullptr);
+    for (int i = 0; i < dimension_; ++i) {
+      ASSERT_EQ(data[i], expected_data[static_cast<size_t>(index) * dimension_ + i]);
+    }
+  }
+}
+
+TEST_F(DistributionDataSetManagerTest, SeedTest1) {
+  // The seed drawn on creation is kept in the header pages and the reopened manager reads it back
+  manager_->GenerateDistributionDataset(20, 1.0);
+  auto make_reopened_manager = [&]() {
+    return std::make_shared<DistributionDataSetManager<float>>(
+        "reopened manager", DataSetType::INVALID_DATA_SET_TYPE, DistributionType::INVALID_DISTRIBUTION_TYPE,
+        NormalizationType::INVALID_NORMALIZATION_TYPE, training_set_bpm_, testing_set_bpm_, nullptr, HEADER_PAGE_ID,
+        HEADER_PAGE_ID, INVALID_DIMENSION, nullptr, "fake directory", INVALID_FILE_ID, INVALID_FILE_ID,
+        directory_page_max_size_, 10);
+  };
+  auto reopened_manager = make_reopened_manager();
+  ASSERT_EQ(reopened_manager->GetSeed(), manager_->GetSeed());
+
+  // The stored data is the stream of the kept seed
+  DistributionDatasetProcessor<float> ddp;
+  float params[2] = {0.0, 1.0};
+  std::vector<float> expected_data(static_cast<size_t>(20) * dimension_);
+  ddp.GenerationDistributionDataset(expected_data.data(), dimension_, 0, 20, DistributionType::GAUSSIAN,
+                                    NormalizationType::MIN_MAX, params, reopened_manager->GetSeed());
+  for (int index = 0; index < 20; ++index) {
+    auto directory_page_id = INVALID_PAGE_ID;
+    auto slot = NULL_SLOT_END;
+    auto data = reopened_manager->GetDistributionData(true, index, &directory_page_id, &slot);
+    ASSERT_NE(data, nullptr);
+    for (int i = 0; i < dimension_; ++i) {
+      ASSERT_EQ(data[i], expected_data[static_cast<size_t>(index) * dimension_ + i]);
+    }
+  }
+
+  // A seed set later is kept as well
+  reopened_manager->SetSeed(42);
+  reopened_manager.reset();
+  ASSERT_EQ(make_reopened_manager()->GetSeed(), 42);
+
+  // A generation file written before the header page kept the seed is refused
+  {
+    auto header_page_guard = testing_set_bpm_->FetchPageWrite(HEADER_PAGE_ID);
+    header_page_guard.AsMut<DistributionDataSetHeaderPage>()->SetFormatVersion(1);
+  }
+  ASSERT_THROW(make_reopened_manager(), Exception);
+}
+
+TEST_F(DistributionDataSetManagerTest, EncodingTest1) {
+  // Encoded pages hold 2 ~ 4 times the values of float pages
+  auto float_capacity = DistributionDataSetDataPage<float>::GetEncodedCapacity(VectorEncoding::FLOAT32);
+  ASSERT_GE(DistributionDataSetDataPage<float>::GetEncodedCapacity(VectorEncoding::FLOAT16), 2 * float_capacity);
+  ASSERT_GE(DistributionDataSetDataPage<float>::GetEncodedCapacity(VectorEncoding::BFLOAT16), 2 * float_capacity);
+  ASSERT_GE(DistributionDataSetDataPage<float>::GetEncodedCapacity(VectorEncoding::UINT8), 4 * float_capacity - 8);
+
+  auto size = 20;
+  std::vector<float> distribution(static_cast<size_t>(size) * dimension_);
+  DistributionDatasetProcessor<float> ddp;
+  float params[2] = {0.0, 1.0};
+  ddp.GenerationDistributionDataset(distribution.data(), dimension_, 0, size, DistributionType::GAUSSIAN,
+                                    NormalizationType::MIN_MAX, params, 42);
+
+  std::vector<std::pair<VectorEncoding, float>> encodings{
+      {VectorEncoding::FLOAT16, 1E-3}, {VectorEncoding::BFLOAT16, 4E-3}, {VectorEncoding::UINT8, 2E-3}};
+  for (auto [encoding, tolerance] : encodings) {
+    auto training_set_bpm = std::make_shared<BufferPoolManager>(10, std::make_shared<DiskManagerUnlimitedMemory>());
+    auto testing_set_bpm = std::make_shared<BufferPoolManager>(10, std::make_shared<DiskManagerUnlimitedMemory>());
+    std::shared_ptr<float[2]> manager_params(new float[2]{0.0, 1.0});
+    auto manager = std::make_shared<DistributionDataSetManager<float>>(
+        "encoded manager", DataSetType::GENERATION, DistributionType::GAUSSIAN, NormalizationType::MIN_MAX,
+        training_set_bpm, testing_set_bpm, std::make_unique<DistributionDatasetProcessor<float>>(), INVALID_PAGE_ID,
+        INVALID_PAGE_ID, dimension_, manager_params, "fake directory", 0x8000'0000UL | GetHashValue("training set"),
+        0x8000'0000UL | GetHashValue("testing set"), directory_page_max_size_, 10);
+
+    // Values of a vector span two data pages
+    ASSERT_TRUE(manager->SetVectorEncoding(encoding, 10));
+    manager->SetSeed(42);
+    manager->GenerateDistributionDataset(size, 1.0);
+    ASSERT_FALSE(manager->SetVectorEncoding(VectorEncoding::FLOAT32));
+
+    std::vector<RID> rids;
+    std::vector<float> query(dimension_, 0.0F);
+    for (int i = 0; i < size; ++i) {
+      auto directory_page_id = INVALID_PAGE_ID;
+      auto slot = NULL_SLOT_END;
+      auto data = manager->GetDistributionData(true, i, &directory_page_id, &slot);
+      ASSERT_NE(data, nullptr);
+      rids.emplace_back(directory_page_id, slot);
+      auto expected = 0.0F;
+      for (int j = 0; j < dimension_; ++j) {
+        auto value = distribution[static_cast<size_t>(i) * dimension_ + j];
+        ASSERT_NEAR(data[j], value, tolerance);
+        expected += data[j] * data[j];
+      }
+
+      // Distance runs on the decoded pages
+      auto distance = 0.0F;
+      ASSERT_TRUE(manager->Distance(true, rids[i].GetPageId(), static_cast<int>(rids[i].GetSlotNum()),
+                                    query.data(), 2.0F, &distance));
+      ASSERT_NEAR(distance, std::sqrt(expected), 1E-5);
+    }
+
+    // The encoding is kept in the header pages
+    auto reopened_manager = std::make_shared<DistributionDataSetManager<float>>(
+        "reopened manager", DataSetType::INVALID_DATA_SET_TYPE, DistributionType::INVALID_DISTRIBUTION_TYPE,
+        NormalizationType::INVALID_NORMALIZATION_TYPE, training_set_bpm, testing_set_bpm, nullptr, HEADER_PAGE_ID,
+        HEADER_PAGE_ID, INVALID_DIMENSION, nullptr, "fake directory", INVALID_FILE_ID, INVALID_FILE_ID,
+        directory_page_max_size_, 10);
+    ASSERT_EQ(reopened_manager->GetVectorEncoding(), encoding);
+    auto data = manager->GetDistributionData(true, rids[3].GetPageId(), static_cast<int>(rids[3].GetSlotNum()));
+    auto reopened_data =
+        reopened_manager->GetDistributionData(true, rids[3].GetPageId(), static_cast<int>(rids[3].GetSlotNum()));
+    for (int j = 0; j < dimension_; ++j) {
+      ASSERT_EQ(data[j], reopened_data[j]);
+    }
+  }
+}
+
+} // namespace distribution_lsh
@@ -5,9 +5,12 @@
 //
 //===-----------------------------------------------------
 
+#include <cmath>
 #include <memory>
+#include <vector>
 #include <gtest/gtest.h>
 #include <dataset/distribution/distribution_dataset_processor.h>
+#include <common/work_stealing_pool.h>
 
 namespace distribution_lsh {
 
@@ -30,6 +33,26 @@ TEST(DistributionDatasetProcessorTest, GenerationDataSetUNIFORM_SOFTMAX) {
   }
 }
 
+TEST(DistributionDatasetProcessorTest, GenerationDataSetLARGE_SOFTMAX) {
+  // exp of the raw values overflows without subtracting the max of the row
+  DistributionDatasetProcessor<float> ddp;
+  auto dimension = 1000;
+  auto size = 100;
+  float param[2] = {1000, 1010};
+  std::unique_ptr<float[]> distribution_dataset =
+      ddp.GenerationDistributionDataset(dimension, size, DistributionType::UNIFORM, NormalizationType::SOFTMAX, param);
+
+  for (int i = 0; i < size; ++i) {
+    float sum = 0;
+    for (int j = 0; j < dimension; ++j) {
+      sum += distribution_dataset[i * dimension + j];
+      ASSERT_TRUE(std::isfinite(distribution_dataset[i * dimension + j]));
+      ASSERT_TRUE(distribution_dataset[i * dimension + j] >= 0);
+    }
+    ASSERT_TRUE(std::abs(sum - 1) < 1E-4);
+  }
+}
+
 TEST(DistributionDatasetProcessorTest, GenerationDataSetGAUSSIAN_SOFTMAX) {
   DistributionDatasetProcessor<float> ddp;
   auto dimension = 5000;
@@ -125,6 +148,44 @@ TEST(DistributionDatasetProcessorTest, GenerationDataSeCAUCHY_MINIMAX) {
   }
 }
 
+TEST(DistributionDatasetProcessorTest, GenerationDataSetReproducible) {
+  DistributionDatasetProcessor<float> ddp;
+  auto dimension = 50;
+  auto size = 2000;
+  float param[2] = {0, 1};
+  std::vector<float> whole(size * dimension);
+  std::vector<float> chunked(size * dimension);
+  std::vector<float> reseeded(size * dimension);
+
+  // Generate the whole data set at once on the shared pool
+  ddp.GenerationDistributionDataset(whole.data(), dimension, 0, size, DistributionType::GAUSSIAN,
+                                    NormalizationType::MIN_MAX, param, 2024);
+
+  // Generate the same data set by chunks on pools of other numbers of threads
+  WorkStealingPool single_pool(1);
+  WorkStealingPool quad_pool(4);
+  ddp.GenerationDistributionDataset(chunked.data(), dimension, 0, 737, DistributionType::GAUSSIAN,
+                                    NormalizationType::MIN_MAX, param, 2024, &single_pool);
+  ddp.GenerationDistributionDataset(chunked.data() + 737 * dimension, dimension, 737, size - 737,
+                                    DistributionType::GAUSSIAN, NormalizationType::MIN_MAX, param, 2024, &quad_pool);
+  ASSERT_EQ(whole, chunked);
+
+  // Another seed generates another data set
+  ddp.GenerationDistributionDataset(reseeded.data(), dimension, 0, size, DistributionType::GAUSSIAN,
+                                    NormalizationType::MIN_MAX, param, 2025);
+  ASSERT_NE(whole, reseeded);
+
+  // Test distribution's property
+  for (int i = 0; i < size; ++i) {
+    float sum = 0;
+    for (int j = 0; j < dimension; ++j) {
+      sum += whole[i * dimension + j];
+      ASSERT_TRUE(whole[i * dimension + j] >= 0);
+    }
+    ASSERT_TRUE(std::abs(sum - 1) < 1E-5);
+  }
+}
+
 TEST(DistributionDatasetProcessorTest, MNISTDataSet_MINIMAX) {
   DistributionDatasetProcessor<float> ddp;
   auto dimension = 784;
@@ -0,0 +1,129 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/10.
+// test/dataset/raw_dataset_reader_test.cpp
+//
+//===-----------------------------------------------------
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <common/config.h>
+#include <dataset/distribution/raw_dataset_reader.h>
+#include <gtest/gtest.h>
+
+namespace distribution_lsh {
+
+class RawDataSetReaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    directory_name_ = (std::filesystem::temp_directory_path() / "distribution_lsh_raw_dataset_test").string();
+    std::filesystem::remove_all(directory_name_);
+    std::filesystem::create_directories(directory_name_);
+  }
+
+  void TearDown() override { std::filesystem::remove_all(directory_name_); }
+
+  static auto Pixel(int row, int i) -> int { return (row * 7 + i) % 256; }
+
+  void WriteFile(const std::string &file_name, const std::string &content) {
+    std::ofstream ofs(directory_name_ + "/" + file_name, std::ios::binary);
+    ofs.write(content.data(), static_cast<std::streamsize>(content.size()));
+  }
+
+  std::string directory_name_;
+};
+
+TEST_F(RawDataSetReaderTest, MNISTCsvTest) {
+  // Title line, a label then the pixels, a float cell and windows line ends
+  std::string content = "label";
+  for (int i = 0; i < MNIST_DIMENSION; ++i) {
+    content += ",pixel" + std::to_string(i);
+  }
+  content += "\n";
+  for (int row = 0; row < 5; ++row) {
+    content += std::to_string(row % 10);
+    for (int i = 0; i < MNIST_DIMENSION; ++i) {
+      content += "," + (row == 2 && i == 3 ? std::string("2.5") : std::to_string(Pixel(row, i)));
+    }
+    content += row == 1 ? "\r\n" : "\n";
+  }
+  WriteFile("mnist_train.csv", content);
+
+  auto reader = OpenRawDataSetReader<float>(DataSetType::MNIST, directory_name_, true);
+  ASSERT_EQ(reader->GetDimension(), MNIST_DIMENSION);
+
+  // Read chunk by chunk
+  std::vector<float> distribution_dataset(3 * MNIST_DIMENSION);
+  ASSERT_EQ(reader->Read(distribution_dataset.data(), 3), 3);
+  for (int row = 0; row < 3; ++row) {
+    for (int i = 0; i < MNIST_DIMENSION; ++i) {
+      auto expected = row == 2 && i == 3 ? 2.5F : static_cast<float>(Pixel(row, i));
+      ASSERT_EQ(distribution_dataset[row * MNIST_DIMENSION + i], expected);
+    }
+  }
+
+  ASSERT_EQ(reader->Read(distribution_dataset.data(), 3), 2);
+  for (int i = 0; i < MNIST_DIMENSION; ++i) {
+    ASSERT_EQ(distribution_dataset[MNIST_DIMENSION + i], static_cast<float>(Pixel(4, i)));
+  }
+  ASSERT_EQ(reader->Read(distribution_dataset.data(), 3), 0);
+}
+
+TEST_F(RawDataSetReaderTest, MNISTIdxTest) {
+  // Big-endian header: magic, number of images, rows, columns
+  std::string content{0, 0, 8, 3, 0, 0, 0, 4, 0, 0, 0, 28, 0, 0, 0, 28};
+  for (int row = 0; row < 4; ++row) {
+    for (int i = 0; i < MNIST_DIMENSION; ++i) {
+      content.push_back(static_cast<char>(Pixel(row, i)));
+    }
+  }
+  WriteFile("t10k-images-idx3-ubyte", content);
+
+  // IDX files are preferred
+  WriteFile("mnist_test.csv", "");
+  auto reader = OpenRawDataSetReader<float>(DataSetType::MNIST, directory_name_, false);
+
+  std::vector<float> distribution_dataset(3 * MNIST_DIMENSION);
+  ASSERT_EQ(reader->Read(distribution_dataset.data(), 3), 3);
+  ASSERT_EQ(distribution_dataset[2 * MNIST_DIMENSION + 100], static_cast<float>(Pixel(2, 100)));
+  ASSERT_EQ(reader->Read(distribution_dataset.data(), 3), 1);
+  for (int i = 0; i < MNIST_DIMENSION; ++i) {
+    ASSERT_EQ(distribution_dataset[i], static_cast<float>(Pixel(3, i)));
+  }
+}
+
+TEST_F(RawDataSetReaderTest, CIFAR10BinaryTest) {
+  // Training set spans five batches of two records each
+  for (int batch = 1; batch <= 5; ++batch) {
+    std::string content;
+    for (int row = (batch - 1) * 2; row < batch * 2; ++row) {
+      content.push_back(static_cast<char>(row % 10));
+      for (int i = 0; i < CIFAR10_DIMENSION; ++i) {
+        content.push_back(static_cast<char>(Pixel(row, i)));
+      }
+    }
+    WriteFile("data_batch_" + std::to_string(batch) + ".bin", content);
+  }
+
+  auto reader = OpenRawDataSetReader<float>(DataSetType::CIFAR10, directory_name_, true);
+  ASSERT_EQ(reader->GetDimension(), CIFAR10_DIMENSION);
+
+  // Chunks cross the batch files
+  std::vector<float> distribution_dataset(3 * CIFAR10_DIMENSION);
+  auto current_row = 0;
+  for (auto rows = reader->Read(distribution_dataset.data(), 3); rows > 0;
+       rows = reader->Read(distribution_dataset.data(), 3)) {
+    for (int row = 0; row < rows; ++row) {
+      for (int i = 0; i < CIFAR10_DIMENSION; ++i) {
+        ASSERT_EQ(distribution_dataset[row * CIFAR10_DIMENSION + i], static_cast<float>(Pixel(current_row + row, i)));
+      }
+    }
+    current_row += rows;
+  }
+  ASSERT_EQ(current_row, 10);
+}
+
+} // namespace distribution_lsh
@@ -5,6 +5,7 @@
 //
 //===-----------------------------------------------------
 
+#include <algorithm>
 #include <memory>
 #include <filesystem>
 
@@ -18,43 +19,287 @@ namespace distribution_lsh {
 class RandomLineMonitorTest : public ::testing::Test {
   protected:
     void SetUp() override {
-      std::string b_plus_tree_directory_name("./distribution_lsh/b_plus_tree/test/");
-      std::string random_line_directory_name("./distribution_lsh/random_line/test/");
-      std::string relation_directory_name("./distribution_lsh/relation/test/");
-      rlm_ = std::make_shared<RandomLineMonitor<float>>(b_plus_tree_directory_name, random_line_directory_name, relation_directory_name);
+      rlm_ = std::make_shared<RandomLineMonitor<float>>(b_plus_tree_directory_name_, random_line_directory_name_, relation_directory_name_);
     }
 
     void TearDown() override {}
 
+    auto RandomProjection(page_id_t page_id) -> std::shared_ptr<std::vector<std::vector<std::pair<file_id_t, RID>>>> {
+      auto params = std::make_shared<float []>(2);
+      params[0] = 0.0F;
+      params[1] = 1.0F;
+      auto ddp = std::make_shared<DistributionDatasetProcessor<float>>();
+      std::shared_ptr<float []> data = ddp->GenerationDistributionDataset(
+          100,
+          100,
+          DistributionType::UNIFORM,
+          NormalizationType::MIN_MAX,
+          params.get());
+      std::shared_ptr<std::vector<RID>> rids = std::make_shared<std::vector<RID>>(100);
+      for (int i = 0; i < 100; ++i) {
+        rids->data()[i] = RID(page_id, i);
+      }
+      return rlm_->RandomProjection(
+          100,
+          data,
+          rids,
+          RandomLineDistributionType::GAUSSIAN,
+          RandomLineNormalizationType::NONE,
+          100,
+          20,
+          GetHashValue("training_set_file_id"));
+    }
+
+    /** Move the monitor onto empty directories of its own, so that the counts of a test hold on every run */
+    void UseFreshDirectories(const std::string &name) {
+      b_plus_tree_directory_name_ = "./distribution_lsh/b_plus_tree/" + name + "/";
+      random_line_directory_name_ = "./distribution_lsh/random_line/" + name + "/";
+      relation_directory_name_ = "./distribution_lsh/relation/" + name + "/";
+      rlm_.reset();
+      for (const auto &directory_name : {b_plus_tree_directory_name_, random_line_directory_name_, relation_directory_name_}) {
+        std::filesystem::remove_all(directory_name);
+      }
+      SetUp();
+    }
+
+    std::string b_plus_tree_directory_name_{"./distribution_lsh/b_plus_tree/test/"};
+    std::string random_line_directory_name_{"./distribution_lsh/random_line/test/"};
+    std::string relation_directory_name_{"./distribution_lsh/relation/test/"};
     std::shared_ptr<RandomLineMonitor<float>> rlm_;
 };
 
 TEST_F(RandomLineMonitorTest, RandomProjectionTest1) {
+  auto results = RandomProjection(0);
+  rlm_->List();
+
+  // Projections of this call are the tail of the projection column of each random line
+  for (int line = 0; line < 20; ++line) {
+    auto [random_line_file_id, random_line_rid] = results->data()[0][line];
+    auto projection_column = rlm_->GetProjectionColumn(random_line_file_id, random_line_rid);
+    ASSERT_NE(projection_column, nullptr);
+    ASSERT_GE(projection_column->GetSize(), 100);
+    auto records = projection_column->GetRecords().last(100);
+    for (int i = 0; i < 100; ++i) {
+      ASSERT_EQ(records[i].GetRID(), RID(0, i));
+    }
+  }
+
+  // The group is packed into one index holding every record of its columns
+  auto [random_line_file_id, random_line_rid] = results->data()[0][0];
+  auto packed_index = rlm_->BuildPackedIndex(random_line_file_id);
+  ASSERT_NE(packed_index, nullptr);
+  ASSERT_GE(packed_index->GetLineCount(), 20);
+  std::vector<RID> constituency;
+  ASSERT_TRUE(packed_index->RangeRead(random_line_rid, -1E30F, 1E30F, &constituency));
+  ASSERT_EQ(static_cast<int64_t>(constituency.size()), packed_index->GetSize(random_line_rid));
+}
+
+TEST_F(RandomLineMonitorTest, PackedIndexInvalidationTest) {
+  UseFreshDirectories("packed_index_test");
+
+  auto results = RandomProjection(1);
+  auto [random_line_file_id, random_line_rid] = results->data()[0][0];
+  auto packed_index = rlm_->BuildPackedIndex(random_line_file_id);
+  ASSERT_NE(packed_index, nullptr);
+  auto size = packed_index->GetSize(random_line_rid);
+  packed_index.reset();
+
+  // A reloaded monitor serves the line from the packed index
+  rlm_.reset();
+  SetUp();
+  ASSERT_NE(rlm_->GetPackedIndex(random_line_file_id), nullptr);
+  std::vector<RID> constituency;
+  ASSERT_TRUE(rlm_->RangeRead(random_line_file_id, random_line_rid, -1E30F, 1E30F, &constituency));
+  ASSERT_EQ(static_cast<int64_t>(constituency.size()), size);
+
+  // Inserting into the group drops the index, the reads see the new data through the B+ tree of the line
+  RandomProjection(2);
+  ASSERT_EQ(rlm_->GetPackedIndex(random_line_file_id), nullptr);
+  ASSERT_FALSE(std::filesystem::exists(
+      b_plus_tree_directory_name_ + "/" + std::to_string(random_line_file_id) + PACKED_INDEX_FILE_SUFFIX));
+  constituency.clear();
+  ASSERT_TRUE(rlm_->RangeRead(random_line_file_id, random_line_rid, -1E30F, 1E30F, &constituency));
+  ASSERT_EQ(static_cast<int64_t>(constituency.size()), size + 100);
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_NE(std::find(constituency.begin(), constituency.end(), RID(2, i)), constituency.end());
+  }
+}
+
+TEST_F(RandomLineMonitorTest, PackedIndexColumnRecoveryTest) {
+  UseFreshDirectories("packed_index_recovery_test");
+
+  auto results = RandomProjection(1);
+  auto random_line_file_id = results->data()[0][0].first;
+
+  // The lines packed from the intact columns. A tree keeps one data per projection value, so a line may miss a data.
+  auto ReadLines = [&](const std::shared_ptr<PackedProjectionIndex<float>> &packed_index) {
+    std::vector<std::vector<RID>> lines(20);
+    for (int line = 0; line < 20; ++line) {
+      EXPECT_TRUE(packed_index->RangeRead(results->data()[0][line].second, -1E30F, 1E30F, &lines[line]));
+      std::sort(lines[line].begin(), lines[line].end());
+    }
+    return lines;
+  };
+  auto packed_index = rlm_->BuildPackedIndex(random_line_file_id);
+  ASSERT_NE(packed_index, nullptr);
+  auto expected_lines = ReadLines(packed_index);
+  packed_index.reset();
+
+  // A tree built before the projection columns has no column, a column lags its tree after a crash
+  rlm_.reset();
+  std::vector<std::filesystem::path> column_file_names;
+  for (const auto &entry : std::filesystem::directory_iterator(b_plus_tree_directory_name_)) {
+    if (entry.path().extension() == PROJECTION_COLUMN_FILE_SUFFIX) {
+      column_file_names.emplace_back(entry.path());
+    }
+  }
+  ASSERT_EQ(column_file_names.size(), 20);
+  std::filesystem::remove(column_file_names[0]);
+  std::filesystem::resize_file(column_file_names[1],
+                               std::filesystem::file_size(column_file_names[1]) - 10 * sizeof(ProjectionRecord<float>));
+  SetUp();
+
+  // Such lines are packed from their B+ trees, the index holds every data of the trees
+  packed_index = rlm_->BuildPackedIndex(random_line_file_id);
+  ASSERT_NE(packed_index, nullptr);
+  auto lines = ReadLines(packed_index);
+  for (int line = 0; line < 20; ++line) {
+    ASSERT_EQ(packed_index->GetSize(results->data()[0][line].second), expected_lines[line].size());
+    ASSERT_EQ(lines[line], expected_lines[line]);
+  }
+}
+
+TEST_F(RandomLineMonitorTest, SeededRandomProjectionTest) {
+  UseFreshDirectories("seeded_test");
+
   auto params = std::make_shared<float []>(2);
   params[0] = 0.0F;
   params[1] = 1.0F;
   auto ddp = std::make_shared<DistributionDatasetProcessor<float>>();
-  std::shared_ptr<float []> data = ddp->GenerationDistributionDataset(
-      100,
-      100,
-      DistributionType::UNIFORM,
-      NormalizationType::MIN_MAX,
-      params.get());
-  std::shared_ptr<std::vector<RID>> rids = std::make_shared<std::vector<RID>>(100);
+  std::shared_ptr<float []> data =
+      ddp->GenerationDistributionDataset(100, 100, DistributionType::UNIFORM, NormalizationType::MIN_MAX, params.get());
+  auto project = [&](page_id_t page_id) {
+    auto rids = std::make_shared<std::vector<RID>>(100);
+    for (int i = 0; i < 100; ++i) {
+      rids->data()[i] = RID(page_id, i);
+    }
+    return rlm_->RandomProjection(100,
+                                  data,
+                                  rids,
+                                  RandomLineDistributionType::GAUSSIAN,
+                                  RandomLineNormalizationType::NONE,
+                                  100,
+                                  20,
+                                  GetHashValue("training_set_file_id"),
+                                  7);
+  };
+
+  // The lines of a seed-defined group are kept in the header page
+  auto results = project(1);
+  auto random_line_file_id = results->data()[0][0].first;
+  for (int index = 0; index < 20; ++index) {
+    EXPECT_EQ(results->data()[0][index], std::make_pair(random_line_file_id, RID(HEADER_PAGE_ID, index)));
+  }
+
+  // A reloaded monitor reads the columns before any insert opens their writers
+  rlm_.reset();
+  SetUp();
+  auto column = rlm_->GetProjectionColumn(random_line_file_id, RID(HEADER_PAGE_ID, 0));
+  ASSERT_NE(column, nullptr);
+  ASSERT_EQ(column->GetSize(), 100);
+  column.reset();
+
+  // The same lines are regenerated from the persisted seed
+  results = project(2);
+  ASSERT_EQ(results->data()[0][0].first, random_line_file_id);
+  ASSERT_EQ(std::distance(std::filesystem::directory_iterator{random_line_directory_name_},
+                          std::filesystem::directory_iterator{}), 1);
+  for (int index = 0; index < 20; ++index) {
+    auto column = rlm_->GetProjectionColumn(random_line_file_id, RID(HEADER_PAGE_ID, index));
+    ASSERT_NE(column, nullptr);
+    auto records = column->GetRecords();
+    ASSERT_EQ(records.size(), 200);
+    for (int i = 0; i < 100; ++i) {
+      EXPECT_EQ(records[i].GetRID(), RID(1, i));
+      EXPECT_EQ(records[100 + i].GetRID(), RID(2, i));
+      EXPECT_EQ(records[i].value_, records[100 + i].value_);
+    }
+  }
+}
+
+
+#ifdef BY_PASS_ACCESS_RANDOM_LINE_MANAGER
+TEST_F(RandomLineMonitorTest, MultiProbeConstituencyTest) {
+  UseFreshDirectories("multi_probe_test");
+
+  auto params = std::make_shared<float []>(2);
+  params[0] = 0.0F;
+  params[1] = 1.0F;
+  auto ddp = std::make_shared<DistributionDatasetProcessor<float>>();
+  std::shared_ptr<float []> data =
+      ddp->GenerationDistributionDataset(100, 100, DistributionType::UNIFORM, NormalizationType::MIN_MAX, params.get());
+  auto rids = std::make_shared<std::vector<RID>>(100);
   for (int i = 0; i < 100; ++i) {
     rids->data()[i] = RID(0, i);
   }
-  rlm_->RandomProjection(
-      100,
-      data,
-      rids,
-      RandomLineDistributionType::GAUSSIAN,
-      RandomLineNormalizationType::NONE,
-      100,
-      20,
-      GetHashValue("training_set_file_id")
-  );
-  rlm_->List();
+  auto results = rlm_->RandomProjection(100,
+                                        data,
+                                        rids,
+                                        RandomLineDistributionType::GAUSSIAN,
+                                        RandomLineNormalizationType::NONE,
+                                        100,
+                                        20,
+                                        GetHashValue("training_set_file_id"));
+  auto random_line_file_id = results->data()[0][0].first;
+  std::vector<RID> random_line_rids;
+  for (int line = 0; line < 4; ++line) {
+    random_line_rids.emplace_back(results->data()[0][line].second);
+  }
+
+  // The first data is the query
+  auto query = std::make_shared<float []>(100);
+  std::copy(data.get(), data.get() + 100, query.get());
+  auto line_constituency = [&](const std::vector<std::pair<RID, RID>> &constituency, const RID &random_line_rid) {
+    std::vector<RID> data_rids;
+    for (const auto &[line_rid, data_rid] : constituency) {
+      if (line_rid == random_line_rid) {
+        data_rids.emplace_back(data_rid);
+      }
+    }
+    std::sort(data_rids.begin(), data_rids.end());
+    return data_rids;
+  };
+  auto contains = [](const std::vector<RID> &data_rids, const RID &data_rid) {
+    return std::find(data_rids.begin(), data_rids.end(), data_rid) != data_rids.end();
+  };
+
+  // Without probes only the home bucket [b, b + 2r) of every line is read, which holds the query itself
+  // and lies within the window of twice the radius around the query projection
+  auto home = rlm_->GetMultiProbeConstituencyPoints(random_line_file_id, random_line_rids, query, 1, 0);
+  for (const auto &random_line_rid : random_line_rids) {
+    auto data_rids = line_constituency(*home, random_line_rid);
+    ASSERT_TRUE(contains(data_rids, RID(0, 0)));
+    ASSERT_EQ(std::adjacent_find(data_rids.begin(), data_rids.end()), data_rids.end());
+    auto window = rlm_->GetConstituencyPoints(random_line_file_id, random_line_rid, query, 2);
+    for (const auto &data_rid : data_rids) {
+      ASSERT_TRUE(contains(*window, data_rid));
+    }
+  }
+
+  // Probing both neighbours of every line covers the single line window [p - r, p + r], still without duplicates
+  auto probed = rlm_->GetMultiProbeConstituencyPoints(random_line_file_id, random_line_rids, query, 1,
+                                                      2 * static_cast<int>(random_line_rids.size()));
+  ASSERT_GE(probed->size(), home->size());
+  for (const auto &random_line_rid : random_line_rids) {
+    auto data_rids = line_constituency(*probed, random_line_rid);
+    ASSERT_EQ(std::adjacent_find(data_rids.begin(), data_rids.end()), data_rids.end());
+    auto window = rlm_->GetConstituencyPoints(random_line_file_id, random_line_rid, query, 1);
+    ASSERT_FALSE(window->empty());
+    for (const auto &data_rid : *window) {
+      ASSERT_TRUE(contains(data_rids, data_rid));
+    }
+  }
 }
+#endif
 
 } // namespace distribution_lsh
\ No newline at end of file
@@ -5,6 +5,9 @@
 //
 //===-----------------------------------------------------
 
+#include <cmath>
+#include <vector>
+
 #include <random/random_line_generator.h>
 #include <fmt/format.h>
 #include <gtest/gtest.h>
@@ -55,4 +58,80 @@ TEST(RandomLineGeneratorTest, RandomLineGenerationL2NORM) {
   EXPECT_TRUE(std::abs(sum - 1.0F) < 1e-6);
 }
 
+TEST(RandomLineGeneratorTest, SeededBatchGeneration) {
+  int dimension = 37;
+  int count = 20;
+  RandomLineGenerator<float> batch_generator(42);
+  RandomLineGenerator<float> single_generator(42);
+  std::vector<float> lines(static_cast<size_t>(count) * dimension);
+
+  // A batch holds the same lines as drawing them one by one from the same seed
+  ASSERT_TRUE(batch_generator.GenerateRandomLines(distribution_lsh::RandomLineDistributionType::GAUSSIAN,
+                                                  distribution_lsh::RandomLineNormalizationType::L2_NORM,
+                                                  dimension, count, lines.data()));
+  EXPECT_EQ(static_cast<uint64_t>(count), batch_generator.GetNextIndex());
+  for (int line = 0; line < count; ++line) {
+    auto data = single_generator.GenerateRandomLine(distribution_lsh::RandomLineDistributionType::GAUSSIAN,
+                                                    distribution_lsh::RandomLineNormalizationType::L2_NORM,
+                                                    dimension);
+    auto sum = 0.0F;
+    for (int i = 0; i < dimension; ++i) {
+      EXPECT_EQ(lines[line * dimension + i], data[i]);
+      sum += data[i] * data[i];
+    }
+    EXPECT_TRUE(std::abs(sum - 1.0F) < 1e-5);
+  }
+
+  // The next batch continues the stream
+  std::vector<float> next_lines(static_cast<size_t>(count) * dimension);
+  ASSERT_TRUE(batch_generator.GenerateRandomLines(distribution_lsh::RandomLineDistributionType::GAUSSIAN,
+                                                  distribution_lsh::RandomLineNormalizationType::L2_NORM,
+                                                  dimension, count, next_lines.data()));
+  EXPECT_NE(lines, next_lines);
+}
+
+TEST(RandomLineGeneratorTest, StructuredGeneration) {
+  int dimension = 256;
+  int count = 64;
+  RandomLineGenerator<float> random_line_generator(11);
+  std::vector<float> lines(static_cast<size_t>(count) * dimension);
+
+  // Sparse entries are +-sqrt(s) or zero, about 1 / s of them are non-zero
+  auto check_sparse = [&](RandomLineDistributionType distribution_type, float sparsity) {
+    ASSERT_TRUE(random_line_generator.GenerateRandomLines(distribution_type, RandomLineNormalizationType::NONE,
+                                                          dimension, count, lines.data()));
+    auto non_zero = 0;
+    for (auto value : lines) {
+      if (value != 0.0F) {
+        EXPECT_FLOAT_EQ(std::abs(value), std::sqrt(sparsity));
+        ++non_zero;
+      }
+    }
+    auto expected = static_cast<float>(lines.size()) / sparsity;
+    EXPECT_NEAR(static_cast<float>(non_zero), expected, expected * 0.2F);
+  };
+  check_sparse(RandomLineDistributionType::SPARSE, 3.0F);
+  check_sparse(RandomLineDistributionType::VERY_SPARSE, std::sqrt(static_cast<float>(dimension)));
+
+  // A SRHT line is a signed hadamard row, lines of different rows are orthogonal
+  ASSERT_TRUE(random_line_generator.GenerateRandomLines(RandomLineDistributionType::SRHT,
+                                                        RandomLineNormalizationType::L2_NORM,
+                                                        dimension, count, lines.data()));
+  auto first_index = random_line_generator.GetNextIndex() - count;
+  for (int line = 0; line < count; ++line) {
+    for (int i = 0; i < dimension; ++i) {
+      EXPECT_FLOAT_EQ(std::abs(lines[line * dimension + i]), 1.0F / 16.0F);
+    }
+    for (int other = 0; other < line; ++other) {
+      auto inner_product = 0.0F;
+      for (int i = 0; i < dimension; ++i) {
+        inner_product += lines[line * dimension + i] * lines[other * dimension + i];
+      }
+      auto same_row = random_line_generator.GetHadamardRow(first_index + line, dimension)
+          == random_line_generator.GetHadamardRow(first_index + other, dimension);
+      EXPECT_NEAR(inner_product, same_row ? 1.0F : 0.0F, 1E-5);
+    }
+  }
+}
+
 } // namespace distribution_lsh
@@ -8,8 +8,13 @@
 #include <algorithm>
 #include <cstdio>
 #include <cmath>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
 
 #include <buffer/buffer_pool_manager.h>
+#include <common/task.h>
 #include <gtest/gtest.h>
 #include <storage/disk/disk_manager_memory.h>
 #include <storage/index/b_plus_tree.h>
@@ -52,5 +57,75 @@ TEST(BPlusTreeTests, RangeTest1) {
 
 }
 
+TEST(BPlusTreeTests, RangeAsyncTest) {
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  // More pages than frames, so that the coroutine misses on most of the pages
+  auto bpm = std::make_shared<BufferPoolManager>(50, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<float, RID> tree("foo_pk", header_page->GetPageId(), bpm, 3, 3);
+
+  std::vector<int> keys(300);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  for (auto key : keys) {
+    tree.Insert(static_cast<float>(key), RID(0, key));
+  }
+
+  // The coroutine keeps one page pinned at a time, however wide the range is
+  std::vector<std::pair<int, int>> ranges({{-5, 3}, {10, 11}, {42, 250}, {0, 299}, {296, 400}, {500, 600}});
+  for (const auto &[lkey, rkey] : ranges) {
+    std::vector<RID> rids;
+    std::vector<RID> expected_rids;
+    for (int key = std::max(lkey, 0); key <= std::min(rkey, 299); ++key) {
+      expected_rids.emplace_back(0, key);
+    }
+    EXPECT_EQ(!expected_rids.empty(),
+              SyncWait(tree.RangeReadAsync(static_cast<float>(lkey), static_cast<float>(rkey), &rids)));
+    EXPECT_EQ(expected_rids, rids);
+  }
+
+  // Inserts may run alongside, their splits move keys rightwards along the scan
+  std::thread inserter([&tree]() {
+    for (int key = 300; key < 600; ++key) {
+      tree.Insert(static_cast<float>(key), RID(0, key));
+    }
+  });
+  std::vector<RID> expected_rids;
+  for (int key = 0; key < 300; ++key) {
+    expected_rids.emplace_back(0, key);
+  }
+  for (int round = 0; round < 20; ++round) {
+    std::vector<RID> rids;
+    EXPECT_TRUE(SyncWait(tree.RangeReadAsync(0.0F, 299.0F, &rids)));
+    EXPECT_EQ(expected_rids, rids);
+  }
+  inserter.join();
+}
+
+TEST(BPlusTreeTests, ScanTest) {
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_shared<BufferPoolManager>(50, disk_manager);
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(&page_id);
+  BPlusTree<float, RID> tree("foo_pk", header_page->GetPageId(), bpm, 3, 3);
+  std::vector<std::pair<float, RID>> entries;
+  EXPECT_FALSE(tree.Scan(&entries));
+
+  std::vector<int> keys(100);
+  std::iota(keys.begin(), keys.end(), 0);
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  for (auto key : keys) {
+    tree.Insert(static_cast<float>(key), RID(0, key));
+  }
+
+  // Every entry in key order, across all the leaves
+  EXPECT_TRUE(tree.Scan(&entries));
+  ASSERT_EQ(entries.size(), keys.size());
+  for (int key = 0; key < static_cast<int>(keys.size()); ++key) {
+    EXPECT_EQ(entries[key].first, static_cast<float>(key));
+    EXPECT_EQ(entries[key].second, RID(0, key));
+  }
+}
 
-}  // namespace distribution_lsh
\ No newline at end of file
+}  // namespace distribution_lsh
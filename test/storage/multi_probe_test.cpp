@@ -0,0 +1,71 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// test/storage/multi_probe_test.cpp
+//
+//===-----------------------------------------------------
+
+#include <cmath>
+#include <map>
+#include <set>
+#include <vector>
+
+#include <storage/index/multi_probe.h>
+#include <gtest/gtest.h>
+
+namespace distribution_lsh {
+
+TEST(MultiProbeTest, ProbeOrderTest) {
+  // Query projections near the right edge, the middle and the left edge of their buckets
+  MultiProbeSequence<float> probe_sequence({1.9F, -3.0F, 4.05F}, 2.0F);
+  ProbeInterval<float> interval{};
+
+  // Home buckets of all the lines first
+  std::vector<std::pair<float, float>> home_buckets({{0.0F, 2.0F}, {-4.0F, -2.0F}, {4.0F, 6.0F}});
+  for (int line = 0; line < 3; ++line) {
+    ASSERT_TRUE(probe_sequence.Next(&interval));
+    EXPECT_EQ(interval.line_, line);
+    EXPECT_EQ(interval.bucket_, 0);
+    EXPECT_FLOAT_EQ(interval.lkey_, home_buckets[line].first);
+    EXPECT_FLOAT_EQ(interval.rkey_, home_buckets[line].second);
+  }
+
+  // The bucket next to the closest edge is the most likely neighbour
+  ASSERT_TRUE(probe_sequence.Next(&interval));
+  EXPECT_EQ(interval.line_, 2);
+  EXPECT_EQ(interval.bucket_, -1);
+  ASSERT_TRUE(probe_sequence.Next(&interval));
+  EXPECT_EQ(interval.line_, 0);
+  EXPECT_EQ(interval.bucket_, 1);
+
+  // Neighbours come in decreasing probability, buckets of a line are taken outwards on each side
+  auto probability = interval.probability_;
+  std::map<int, std::set<int>> buckets({{0, {1}}, {2, {-1}}});
+  for (int probe = 0; probe < 60; ++probe) {
+    ASSERT_TRUE(probe_sequence.Next(&interval));
+    EXPECT_LE(interval.probability_, probability);
+    EXPECT_FLOAT_EQ(interval.rkey_ - interval.lkey_, 2.0F);
+    probability = interval.probability_;
+    EXPECT_TRUE(buckets[interval.line_].insert(interval.bucket_).second);
+    auto inner_bucket = interval.bucket_ > 0 ? interval.bucket_ - 1 : interval.bucket_ + 1;
+    EXPECT_TRUE(inner_bucket == 0 || buckets[interval.line_].count(inner_bucket) > 0);
+  }
+  EXPECT_EQ(probe_sequence.GetProbeCount(), 65);
+
+  // Cauchy lines have heavier tails, the second neighbour is more likely than with Gaussian lines
+  MultiProbeSequence<float> gaussian_sequence({1.0F}, 2.0F, 1.0F, RandomLineDistributionType::GAUSSIAN);
+  MultiProbeSequence<float> cauchy_sequence({1.0F}, 2.0F, 1.0F, RandomLineDistributionType::CAUCHY);
+  ProbeInterval<float> gaussian_interval{};
+  ProbeInterval<float> cauchy_interval{};
+  for (int probe = 0; probe < 4; ++probe) {
+    ASSERT_TRUE(gaussian_sequence.Next(&gaussian_interval));
+    ASSERT_TRUE(cauchy_sequence.Next(&cauchy_interval));
+  }
+  EXPECT_EQ(std::abs(cauchy_interval.bucket_), 2);
+  EXPECT_LT(gaussian_interval.probability_, cauchy_interval.probability_);
+
+  MultiProbeSequence<float> empty_sequence({}, 2.0F);
+  EXPECT_FALSE(empty_sequence.Next(&interval));
+}
+
+} // namespace distribution_lsh
@@ -0,0 +1,70 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// test/storage/packed_projection_index_test.cpp
+//
+//===-----------------------------------------------------
+
+#include <algorithm>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <storage/index/packed_projection_index.h>
+#include <gtest/gtest.h>
+
+namespace distribution_lsh {
+
+TEST(PackedProjectionIndexTest, RangeReadTest) {
+  auto file_name = (std::filesystem::temp_directory_path() / "distribution_lsh_packed_index_test.pi").string();
+
+  // Two lines with duplicated values, and an empty one
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> distribution(-50, 50);
+  std::vector<std::vector<ProjectionRecord<float>>> records(3);
+  for (int line = 0; line < 2; ++line) {
+    for (int i = 0; i < 1000 * (line + 1); ++i) {
+      records[line].push_back({static_cast<float>(distribution(generator)) * 0.5F, line, static_cast<uint32_t>(i)});
+    }
+  }
+  std::vector<PackedProjectionIndex<float>::Line> lines;
+  for (int line = 0; line < 3; ++line) {
+    lines.emplace_back(RID(7, line), records[line]);
+  }
+  PackedProjectionIndex<float>::Build(file_name, lines);
+
+  for (auto fence_interval : {1, 4, PACKED_INDEX_FENCE_INTERVAL}) {
+    PackedProjectionIndex<float> packed_index(file_name, fence_interval);
+    ASSERT_EQ(packed_index.GetLineCount(), 3);
+    ASSERT_EQ(packed_index.GetSize(RID(7, 1)), 2000);
+    ASSERT_EQ(packed_index.GetSize(RID(7, 2)), 0);
+    ASSERT_EQ(packed_index.GetSize(RID(8, 0)), -1);
+
+    for (int line = 0; line < 2; ++line) {
+      for (auto [lkey, rkey] : {std::pair{-3.0F, 4.5F}, {-100.0F, -26.0F}, {25.0F, 25.0F}, {-30.0F, 30.0F}}) {
+        std::vector<RID> result;
+        ASSERT_TRUE(packed_index.RangeRead(RID(7, line), lkey, rkey, &result));
+
+        std::vector<RID> expected;
+        for (const auto &record : records[line]) {
+          if (record.value_ >= lkey && record.value_ <= rkey) {
+            expected.emplace_back(record.GetRID());
+          }
+        }
+        std::sort(result.begin(), result.end());
+        std::sort(expected.begin(), expected.end());
+        ASSERT_EQ(result, expected);
+      }
+    }
+
+    std::vector<RID> result;
+    ASSERT_TRUE(packed_index.RangeRead(RID(7, 2), -1.0F, 1.0F, &result));
+    ASSERT_TRUE(result.empty());
+    ASSERT_FALSE(packed_index.RangeRead(RID(8, 0), -1.0F, 1.0F, &result));
+  }
+
+  std::filesystem::remove(file_name);
+}
+
+} // namespace distribution_lsh
@@ -48,4 +48,52 @@ TEST(PageGuardTest, SampleTest) {
   disk_manager->ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST(PageGuardTest, MoveTest) {
+  const size_t buffer_pool_size = 5;
+  const size_t k = 2;
+
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_shared<BufferPoolManager>(buffer_pool_size, disk_manager, k);
+
+  page_id_t page_id0;
+  page_id_t page_id1;
+  auto page0 = bpm->NewPage(&page_id0);
+  auto page1 = bpm->NewPage(&page_id1);
+  EXPECT_TRUE(bpm->UnpinPage(page_id0, false));
+  EXPECT_TRUE(bpm->UnpinPage(page_id1, false));
+
+  // Scenario: Assigning a guard drops the page it held.
+  {
+    auto guard0 = bpm->FetchPageBasic(page_id0);
+    auto guard1 = bpm->FetchPageBasic(page_id1);
+    guard0 = std::move(guard1);
+    EXPECT_EQ(0, page0->GetPinCount());
+    EXPECT_EQ(1, page1->GetPinCount());
+    EXPECT_EQ(page_id1, guard0.PageId());
+  }
+  EXPECT_EQ(0, page1->GetPinCount());
+
+  // Scenario: Assigning a read guard releases the latch it held, so the page can be written.
+  {
+    auto read_guard = bpm->FetchPageRead(page_id0);
+    read_guard = bpm->FetchPageRead(page_id1);
+    auto write_guard = bpm->FetchPageWrite(page_id0);
+    EXPECT_EQ(1, page0->GetPinCount());
+    EXPECT_EQ(1, page1->GetPinCount());
+  }
+
+  // Scenario: Upgrading a guard keeps the page dirty.
+  {
+    auto basic_guard = bpm->FetchPageBasic(page_id0);
+    basic_guard.GetDataMut()[0] = 'a';
+    auto write_guard = basic_guard.UpgradeWrite();
+    EXPECT_EQ(1, page0->GetPinCount());
+  }
+  EXPECT_EQ(0, page0->GetPinCount());
+  EXPECT_TRUE(page0->IsDirty());
+
+  disk_manager->ShutDown();
+}
+
 }// namespace distribution_lsh
\ No newline at end of file
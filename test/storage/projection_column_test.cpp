@@ -0,0 +1,58 @@
+//===----------------------------------------------------
+//                    DISTRIBUTION_LSH
+// Created by chenjunhao on 2024/10/11.
+// test/storage/projection_column_test.cpp
+//
+//===-----------------------------------------------------
+
+#include <filesystem>
+#include <string>
+
+#include <storage/index/projection_column.h>
+#include <gtest/gtest.h>
+
+namespace distribution_lsh {
+
+TEST(ProjectionColumnTest, AppendAndReadTest) {
+  auto file_name = (std::filesystem::temp_directory_path() / "distribution_lsh_projection_column_test.pc").string();
+  std::filesystem::remove(file_name);
+
+  // Records cross the buffer boundary
+  {
+    ProjectionColumnWriter<float> writer(file_name, 16);
+    for (int i = 0; i < 100; ++i) {
+      writer.Append(static_cast<float>(i) * 0.5F, RID(i / 10, i % 10));
+    }
+  }
+
+  // Reopened columns are appended to
+  {
+    ProjectionColumnWriter<float> writer(file_name, 16);
+    writer.Append(-1.0F, RID(100, 0));
+    writer.Flush();
+  }
+
+  ProjectionColumnReader<float> reader(file_name);
+  ASSERT_EQ(reader.GetSize(), 101);
+  auto records = reader.GetRecords();
+  for (int i = 0; i < 100; ++i) {
+    ASSERT_EQ(records[i].value_, static_cast<float>(i) * 0.5F);
+    ASSERT_EQ(records[i].GetRID(), RID(i / 10, i % 10));
+  }
+  ASSERT_EQ(records[100].value_, -1.0F);
+  ASSERT_EQ(records[100].GetRID(), RID(100, 0));
+
+  // A torn record is dropped before appending
+  std::filesystem::resize_file(file_name, std::filesystem::file_size(file_name) - 3);
+  {
+    ProjectionColumnWriter<float> writer(file_name);
+    writer.Append(2.0F, RID(101, 0));
+  }
+  ProjectionColumnReader<float> torn_reader(file_name);
+  ASSERT_EQ(torn_reader.GetSize(), 101);
+  ASSERT_EQ(torn_reader.GetRecords()[100].GetRID(), RID(101, 0));
+
+  std::filesystem::remove(file_name);
+}
+
+} // namespace distribution_lsh
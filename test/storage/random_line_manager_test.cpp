@@ -5,6 +5,7 @@
 //
 //===-----------------------------------------------------
 
+#include <algorithm>
 #include <memory>
 #include <stdexcept>
 
@@ -110,4 +111,264 @@ TEST_F(RandomLineManagerTest, DeleteTest) {
   }
 }
 
+TEST_F(RandomLineManagerTest, DeleteSlotTest) {
+  ASSERT_TRUE(rlm_->GenerateRandomLineGroup(25));
+  ASSERT_EQ(rlm_->GetSize(), 25);
+
+  // A slot is deleted once, a free or out of range slot leaves the size untouched
+  EXPECT_TRUE(rlm_->Delete(1, 3));
+  EXPECT_EQ(rlm_->GetSize(), 24);
+  EXPECT_FALSE(rlm_->Delete(1, 3));
+  EXPECT_FALSE(rlm_->Delete(1, -1));
+  EXPECT_FALSE(rlm_->Delete(1, 10));
+  EXPECT_EQ(rlm_->GetSize(), 24);
+
+  // The other lines of the directory page are still there
+  auto random_line_rids = std::make_shared<std::vector<RID>>();
+  rlm_->GetSize(nullptr, random_line_rids);
+  ASSERT_EQ(random_line_rids->size(), 24);
+  EXPECT_EQ(std::find(random_line_rids->begin(), random_line_rids->end(), RID(1, 3)), random_line_rids->end());
+  EXPECT_TRUE(rlm_->Delete(1, 4));
+  EXPECT_EQ(rlm_->GetSize(), 23);
+}
+
+TEST_F(RandomLineManagerTest, LegacyHeaderTest) {
+  auto bpm = std::make_shared<BufferPoolManager>(5, std::make_shared<DiskManagerUnlimitedMemory>());
+  auto make_manager = [&](page_id_t header_page_id) {
+    return std::make_shared<RandomLineManager<float>>("legacy random line manager",
+                                                      GetHashValue("legacy random line manager"),
+                                                      bpm,
+                                                      rlg_,
+                                                      header_page_id,
+                                                      dimension_,
+                                                      10,
+                                                      10,
+                                                      RandomLineDistributionType::GAUSSIAN,
+                                                      RandomLineNormalizationType::NONE,
+                                                      100.0F);
+  };
+  auto rlm = make_manager(INVALID_PAGE_ID);
+  ASSERT_TRUE(rlm->GenerateRandomLineGroup(25));
+  ASSERT_TRUE(rlm->Delete(1, 3));
+  rlm.reset();
+
+  // A file written before the header page kept the size reads zeros behind the directory page start id
+  {
+    auto header_page_guard = bpm->FetchPageWrite(HEADER_PAGE_ID);
+    auto header_page = header_page_guard.AsMut<RandomLineHeaderPage>();
+    ASSERT_EQ(header_page->GetFormatVersion(), RANDOM_LINE_HEADER_PAGE_VERSION);
+    header_page->SetSize(0);
+    header_page->SetFormatVersion(0);
+  }
+
+  // Its size is recounted from the directory pages on the first open and kept from then on
+  auto reopened_rlm = make_manager(HEADER_PAGE_ID);
+  ASSERT_FALSE(reopened_rlm->IsSeeded());
+  ASSERT_EQ(reopened_rlm->GetSize(), 24);
+  auto header_page_guard = bpm->FetchPageRead(HEADER_PAGE_ID);
+  ASSERT_EQ(header_page_guard.As<RandomLineHeaderPage>()->GetFormatVersion(), RANDOM_LINE_HEADER_PAGE_VERSION);
+  ASSERT_EQ(header_page_guard.As<RandomLineHeaderPage>()->GetSize(), 24);
+}
+
+TEST_F(RandomLineManagerTest, GenerationRollBackTest) {
+  // A group the buffer pool runs out of frames for leaves the stored lines untouched
+  auto disk_manager = std::make_shared<DiskManagerUnlimitedMemory>();
+  auto bpm = std::make_shared<BufferPoolManager>(5, disk_manager);
+  auto rlm = std::make_shared<RandomLineManager<float>>("random line roll back",
+                                                        GetHashValue("random line roll back"),
+                                                        bpm,
+                                                        rlg_,
+                                                        INVALID_PAGE_ID,
+                                                        dimension_,
+                                                        10,
+                                                        10,
+                                                        RandomLineDistributionType::GAUSSIAN,
+                                                        RandomLineNormalizationType::NONE,
+                                                        100.0F);
+  ASSERT_TRUE(rlm->GenerateRandomLineGroup(8));
+  ASSERT_EQ(rlm->GetSize(), 8);
+
+  // Pin frames so that a line spanning several data pages can not be written
+  {
+    std::vector<BasicPageGuard> pinned_pages;
+    for (int index = 0; index < 2; ++index) {
+      auto page_id = INVALID_PAGE_ID;
+      pinned_pages.emplace_back(bpm->NewPageGuarded(&page_id));
+      ASSERT_NE(page_id, INVALID_PAGE_ID);
+    }
+    EXPECT_FALSE(rlm->GenerateRandomLineGroup(5));
+    EXPECT_EQ(rlm->GetSize(), 8);
+  }
+
+  // The lines are written before the directory pages, so a group crossing one fits in the frames left
+  {
+    auto page_id = INVALID_PAGE_ID;
+    auto pinned_page = bpm->NewPageGuarded(&page_id);
+    ASSERT_NE(page_id, INVALID_PAGE_ID);
+    ASSERT_TRUE(rlm->GenerateRandomLineGroup(5));
+    ASSERT_EQ(rlm->GetSize(), 13);
+  }
+  auto outer_array =
+      rlg_->GenerateRandomLine(RandomLineDistributionType::GAUSSIAN, RandomLineNormalizationType::NONE, dimension_);
+  for (int index = 0; index < 13; ++index) {
+    auto directory_page_id = INVALID_PAGE_ID;
+    auto slot = INVALID_SLOT_VALUE;
+    rlm->InnerProduct(index, &directory_page_id, &slot, outer_array);
+    EXPECT_NE(directory_page_id, INVALID_PAGE_ID);
+    EXPECT_NE(slot, INVALID_SLOT_VALUE);
+  }
+}
+
+TEST_F(RandomLineManagerTest, SeededGenerationTest) {
+  // Managers with generators of the same seed store the same lines
+  auto make_manager = [&](std::shared_ptr<BufferPoolManager> bpm) {
+    return std::make_shared<RandomLineManager<float>>("seeded random line manager",
+                                                      GetHashValue("seeded random line manager"),
+                                                      std::move(bpm),
+                                                      std::make_shared<RandomLineGenerator<float>>(7),
+                                                      INVALID_PAGE_ID,
+                                                      dimension_,
+                                                      10,
+                                                      10,
+                                                      RandomLineDistributionType::GAUSSIAN,
+                                                      RandomLineNormalizationType::L2_NORM,
+                                                      0.5F);
+  };
+  auto rlm1 = make_manager(std::make_shared<BufferPoolManager>(50, std::make_shared<DiskManagerUnlimitedMemory>()));
+  auto rlm2 = make_manager(std::make_shared<BufferPoolManager>(50, std::make_shared<DiskManagerUnlimitedMemory>()));
+
+  // Groups are generated in several calls, the average random line carries over
+  ASSERT_TRUE(rlm1->GenerateRandomLineGroup(30));
+  ASSERT_TRUE(rlm1->GenerateRandomLineGroup(20));
+  ASSERT_TRUE(rlm2->GenerateRandomLineGroup(50));
+  ASSERT_EQ(rlm1->GetSize(), 50);
+  ASSERT_EQ(rlm2->GetSize(), 50);
+
+  std::shared_ptr<float[]> probe(new float[dimension_]);
+  for (int i = 0; i < dimension_; ++i) {
+    probe[i] = static_cast<float>(i % 7) - 3.0F;
+  }
+  page_id_t directory_page_id1;
+  page_id_t directory_page_id2;
+  int slot1;
+  int slot2;
+  for (int index = 0; index < 50; ++index) {
+    EXPECT_EQ(rlm1->InnerProduct(index, &directory_page_id1, &slot1, probe),
+              rlm2->InnerProduct(index, &directory_page_id2, &slot2, probe));
+  }
+}
+
+TEST_F(RandomLineManagerTest, SeededGroupTest) {
+  auto bpm = std::make_shared<BufferPoolManager>(5, std::make_shared<DiskManagerUnlimitedMemory>());
+  auto make_manager = [&](page_id_t header_page_id) {
+    return std::make_shared<RandomLineManager<float>>("seed-defined random line manager",
+                                                      GetHashValue("seed-defined random line manager"),
+                                                      bpm,
+                                                      rlg_,
+                                                      header_page_id,
+                                                      dimension_,
+                                                      10,
+                                                      10,
+                                                      RandomLineDistributionType::CAUCHY,
+                                                      RandomLineNormalizationType::L2_NORM,
+                                                      EPSILON);
+  };
+
+  auto rlm = make_manager(INVALID_PAGE_ID);
+  ASSERT_TRUE(rlm->GenerateSeededRandomLineGroup(40, 2024));
+  ASSERT_FALSE(rlm->GenerateSeededRandomLineGroup(40, 2024));
+  ASSERT_TRUE(rlm->IsSeeded());
+  ASSERT_EQ(rlm->GetSize(), 40);
+  ASSERT_TRUE(rlm->GenerateRandomLineGroup(10));
+  ASSERT_EQ(rlm->GetSize(), 50);
+
+  // Lines are addressed by their index in the stream and cannot be deleted
+  auto random_line_rids = std::make_shared<std::vector<RID>>();
+  ASSERT_EQ(rlm->GetSize(nullptr, random_line_rids), 50);
+  ASSERT_EQ(random_line_rids->size(), 50);
+  EXPECT_EQ(random_line_rids->back(), RID(HEADER_PAGE_ID, 49));
+  EXPECT_FALSE(rlm->Delete(HEADER_PAGE_ID, 0));
+
+  // Reopening the file regenerates the same lines from the seed in the header page
+  auto reopened_rlm = make_manager(HEADER_PAGE_ID);
+  ASSERT_TRUE(reopened_rlm->IsSeeded());
+  ASSERT_EQ(reopened_rlm->GetSeed(), 2024);
+  ASSERT_EQ(reopened_rlm->GetSize(), 50);
+  ASSERT_EQ(reopened_rlm->GetDistributionType(), RandomLineDistributionType::CAUCHY);
+
+  std::shared_ptr<float[]> probe(new float[dimension_]);
+  for (int i = 0; i < dimension_; ++i) {
+    probe[i] = static_cast<float>(i % 5) - 2.0F;
+  }
+  page_id_t directory_page_id;
+  int slot;
+  for (int index = 0; index < 50; ++index) {
+    auto inner_product = rlm->InnerProduct(index, &directory_page_id, &slot, probe);
+    EXPECT_EQ(directory_page_id, HEADER_PAGE_ID);
+    EXPECT_EQ(slot, index);
+    EXPECT_EQ(inner_product, reopened_rlm->InnerProduct(HEADER_PAGE_ID, index, probe));
+  }
+  EXPECT_THROW(reopened_rlm->InnerProduct(HEADER_PAGE_ID, 50, probe), Exception);
+}
+
+TEST_F(RandomLineManagerTest, StructuredProjectionTest) {
+  std::shared_ptr<float[]> probe(new float[dimension_]);
+  for (int i = 0; i < dimension_; ++i) {
+    probe[i] = static_cast<float>(i % 9) - 4.0F;
+  }
+  auto make_manager = [&](RandomLineDistributionType distribution_type) {
+    return std::make_shared<RandomLineManager<float>>("structured random line manager",
+                                                      GetHashValue("structured random line manager"),
+                                                      std::make_shared<BufferPoolManager>(10, std::make_shared<DiskManagerUnlimitedMemory>()),
+                                                      std::make_shared<RandomLineGenerator<float>>(5),
+                                                      INVALID_PAGE_ID,
+                                                      dimension_,
+                                                      10,
+                                                      10,
+                                                      distribution_type,
+                                                      RandomLineNormalizationType::L2_NORM,
+                                                      0.0F);
+  };
+
+  // Lines of a sparse group are stored as their non-zero entries, projections match the dense lines
+  for (auto distribution_type : {RandomLineDistributionType::SPARSE, RandomLineDistributionType::VERY_SPARSE}) {
+    auto rlm = make_manager(distribution_type);
+    ASSERT_TRUE(rlm->GenerateRandomLineGroup(20));
+    ASSERT_EQ(rlm->GetSize(), 20);
+    RandomLineGenerator<float> generator(5);
+    std::vector<float> lines(static_cast<size_t>(20) * dimension_);
+    ASSERT_TRUE(generator.GenerateRandomLines(distribution_type, RandomLineNormalizationType::L2_NORM,
+                                              dimension_, 20, lines.data()));
+
+    std::vector<RID> random_line_rids;
+    std::vector<float> projections;
+    ASSERT_TRUE(rlm->Project(probe, &random_line_rids, &projections));
+    ASSERT_EQ(projections.size(), 20);
+    for (int index = 0; index < 20; ++index) {
+      auto expected = 0.0F;
+      for (int i = 0; i < dimension_; ++i) {
+        expected += lines[index * dimension_ + i] * probe[i];
+      }
+      EXPECT_NEAR(projections[index], expected, 1E-4);
+      EXPECT_EQ(projections[index], rlm->InnerProduct(random_line_rids[index].GetPageId(),
+                                                      static_cast<int>(random_line_rids[index].GetSlotNum()),
+                                                      probe));
+    }
+  }
+
+  // A seed-defined SRHT group is projected by the fast hadamard transform
+  for (auto distribution_type : {RandomLineDistributionType::SRHT, RandomLineDistributionType::VERY_SPARSE}) {
+    auto rlm = make_manager(distribution_type);
+    ASSERT_TRUE(rlm->GenerateSeededRandomLineGroup(30, 99));
+    std::vector<RID> random_line_rids;
+    std::vector<float> projections;
+    ASSERT_TRUE(rlm->Project(probe, &random_line_rids, &projections));
+    ASSERT_EQ(projections.size(), 30);
+    for (int index = 0; index < 30; ++index) {
+      EXPECT_EQ(random_line_rids[index], RID(HEADER_PAGE_ID, index));
+      EXPECT_NEAR(projections[index], rlm->InnerProduct(HEADER_PAGE_ID, index, probe), 1E-4);
+    }
+  }
+}
+
 } // namespace distribution_lsh
@@ -64,4 +64,32 @@ TEST(RelationDataPageTest, DeleteTest) {
   ASSERT_EQ(data_page->Get(7).next_null_slot_, INVALID_SLOT_VALUE);
 }
 
+TEST(RelationDataPageTest, OccupancyBitmapTest) {
+  std::array<char, DISTRIBUTION_LSH_PAGE_SIZE> raw_data{};
+  auto data_page = reinterpret_cast<RelationDataPage<RandomLineFileToBPlusTreeFileUnion>*>(raw_data.data());
+  data_page->Init();
+  ASSERT_TRUE(data_page->HasOccupancyBitmap());
+
+  for (int i = 0; i < data_page->GetMaxSize(); ++i) {
+    RandomLineFileToBPlusTreeFileUnion union_data{.map_ = {.random_line_slot_ = i}};
+    auto index = 0;
+    ASSERT_TRUE(data_page->Insert(union_data, &index));
+    ASSERT_EQ(index, i);
+  }
+
+  ASSERT_TRUE(data_page->Delete(40));
+  ASSERT_TRUE(data_page->Delete(33));
+  ASSERT_FALSE(data_page->Delete(33));
+  ASSERT_EQ(data_page->GetNullSlotStart(), 33);
+  ASSERT_EQ(data_page->Get(33).next_null_slot_, INVALID_SLOT_VALUE);
+  ASSERT_EQ(data_page->Get(34).map_.random_line_slot_, 34);
+
+  RandomLineFileToBPlusTreeFileUnion union_data{.map_ = {.random_line_slot_ = 100}};
+  auto index = 0;
+  ASSERT_TRUE(data_page->Insert(union_data, &index));
+  ASSERT_EQ(index, 33);
+  ASSERT_EQ(data_page->GetNullSlotStart(), 40);
+  ASSERT_EQ(data_page->Get(33).map_.random_line_slot_, 100);
+}
+
 } // namespace distribution_lsh
\ No newline at end of file